@@ -0,0 +1,236 @@
+#ifndef ACTION_RESOLVER_H
+#define ACTION_RESOLVER_H
+
+// Rules engine for mechanical player actions on worlds with a machine-readable map
+// (see world_model.h). Moving through a known exit, taking an item that is present,
+// looking around, examining an item and listing the inventory are resolved directly,
+// with turn counting, unsafe-location health loss and the win / lose conditions applied.
+// Anything else - free-form input, unknown items, exits whose destination is not known -
+// is left to the model. Moves and takes use a turn; looking, examining, listing and
+// blocked moves do not.
+
+#include <algorithm>
+#include <cctype>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "world_model.h"
+
+class ActionResolver {
+public:
+    // True with the new state text when the rules cover the action
+    static bool resolve(const WorldModel& world, const std::string& stateText,
+                        const std::string& action, std::string& newState) {
+        PlayerState state;
+        if (!PlayerState::parse(stateText, state)) {
+            return false;
+        }
+        const WorldLocation* here = world.find(state.location);
+        if (!here) {
+            return false;
+        }
+
+        std::vector<std::string> words = significantWords(action);
+        if (words.empty() || words.size() > 5) {
+            return false;
+        }
+        const std::string& verb = words[0];
+        std::vector<std::string> object(words.begin() + 1, words.end());
+        if (verb == "pick" && !object.empty() && object[0] == "up") {
+            object.erase(object.begin());
+        }
+
+        if (state.status != "active") {
+            state.messages = {"The game is over."};
+        } else if (direction(verb).size() && object.empty()) {
+            if (!move(world, *here, direction(verb), state)) return false;
+        } else if (isOneOf(verb, {"move", "go", "walk", "run", "head"}) && object.size() == 1 && direction(object[0]).size()) {
+            if (!move(world, *here, direction(object[0]), state)) return false;
+        } else if (isOneOf(verb, {"take", "get", "grab", "pick"}) && !object.empty()) {
+            if (!take(world, *here, object, state)) return false;
+        } else if (isOneOf(verb, {"inventory", "inv", "i"}) && object.empty()) {
+            state.messages = {state.inventory.empty() ? "You are carrying nothing."
+                                                      : "You are carrying: " + join(state.inventory) + "."};
+        } else if (isOneOf(verb, {"look", "l"}) && object.empty()) {
+            state.messages = {describe(*here, state)};
+        } else if (isOneOf(verb, {"examine", "look", "inspect", "x"}) && !object.empty()) {
+            if (!examine(world, *here, object, state)) return false;
+        } else {
+            return false;
+        }
+
+        newState = state.serialize();
+        return true;
+    }
+
+private:
+    static std::vector<std::string> significantWords(const std::string& action) {
+        static const std::vector<std::string> fillers = {"the", "a", "an", "to", "at", "my"};
+        std::vector<std::string> words;
+        std::istringstream in(WorldModel::lower(action));
+        std::string word;
+        while (in >> word) {
+            word.erase(std::remove_if(word.begin(), word.end(),
+                                      [](unsigned char c) { return std::ispunct(c) && c != '_'; }),
+                       word.end());
+            if (!word.empty() && !isOneOf(word, fillers)) {
+                words.push_back(word);
+            }
+        }
+        return words;
+    }
+
+    static std::string direction(const std::string& word) {
+        static const std::map<std::string, std::string> directions = {
+            {"n", "north"}, {"north", "north"}, {"s", "south"}, {"south", "south"},
+            {"e", "east"}, {"east", "east"}, {"w", "west"}, {"west", "west"},
+            {"u", "up"}, {"up", "up"}, {"d", "down"}, {"down", "down"},
+            {"ne", "northeast"}, {"northeast", "northeast"}, {"nw", "northwest"}, {"northwest", "northwest"},
+            {"se", "southeast"}, {"southeast", "southeast"}, {"sw", "southwest"}, {"southwest", "southwest"}};
+        auto it = directions.find(word);
+        return it == directions.end() ? "" : it->second;
+    }
+
+    static bool isOneOf(const std::string& word, const std::vector<std::string>& options) {
+        return std::find(options.begin(), options.end(), word) != options.end();
+    }
+
+    // Item as written in messages ("crystal_of_power" -> "crystal of power")
+    static std::string display(std::string item) {
+        std::replace(item.begin(), item.end(), '_', ' ');
+        return item;
+    }
+
+    static std::string join(const std::vector<std::string>& items) {
+        std::string text;
+        for (const auto& item : items) {
+            text += (text.empty() ? "" : ", ") + item;
+        }
+        return text;
+    }
+
+    // Items of the location the player has not taken
+    static std::vector<std::string> present(const WorldLocation& location, const PlayerState& state) {
+        std::vector<std::string> items;
+        for (const auto& item : location.items) {
+            if (!state.has(item)) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    static std::string describe(const WorldLocation& location, const PlayerState& state) {
+        std::string text = location.description;
+        for (const auto& item : present(location, state)) {
+            auto it = location.itemDescriptions.find(item);
+            if (it != location.itemDescriptions.end()) {
+                text += " " + it->second;
+            }
+        }
+        if (!location.exits.empty()) {
+            text += " Exits: " + join(location.exits) + ".";
+        }
+        return text;
+    }
+
+    // The one candidate item whose name contains every object word
+    static std::string matchItem(const std::vector<std::string>& object, const std::vector<std::string>& candidates) {
+        std::string match;
+        for (const auto& item : candidates) {
+            std::string name = " " + WorldModel::lower(item) + " ";
+            std::replace(name.begin(), name.end(), '_', ' ');
+            bool all = true;
+            for (const auto& word : object) {
+                all = all && name.find(" " + word + " ") != std::string::npos;
+            }
+            if (all) {
+                if (!match.empty()) {
+                    return "";  // Ambiguous
+                }
+                match = item;
+            }
+        }
+        return match;
+    }
+
+    static bool move(const WorldModel& world, const WorldLocation& here, const std::string& dir, PlayerState& state) {
+        if (std::find(here.exits.begin(), here.exits.end(), dir) == here.exits.end()) {
+            state.messages = {"There is no way " + dir + " from here. Exits: " + join(here.exits) + "."};
+            return true;
+        }
+        const WorldLocation* there = world.find(world.destination(here, dir));
+        if (!there) {
+            return false;
+        }
+        state.location = there->name;
+        state.messages = {describe(*there, state)};
+        endTurn(world, *there, state);
+        return true;
+    }
+
+    static bool take(const WorldModel& world, const WorldLocation& here, const std::vector<std::string>& object,
+                     PlayerState& state) {
+        std::string item = matchItem(object, present(here, state));
+        if (item.empty()) {
+            item = matchItem(object, state.inventory);
+            if (item.empty()) {
+                return false;
+            }
+            state.messages = {"You already have the " + display(item) + "."};
+            return true;
+        }
+        state.inventory.push_back(item);
+        auto info = world.itemInfo.find(item);
+        state.messages = {"You take the " + display(item) + "." +
+                          (info != world.itemInfo.end() && !info->second.empty() ? " " + info->second : "")};
+        endTurn(world, here, state);
+        return true;
+    }
+
+    static bool examine(const WorldModel& world, const WorldLocation& here, const std::vector<std::string>& object,
+                        PlayerState& state) {
+        std::vector<std::string> visible = present(here, state);
+        visible.insert(visible.end(), state.inventory.begin(), state.inventory.end());
+        std::string item = matchItem(object, visible);
+        if (item.empty()) {
+            return false;
+        }
+        auto info = world.itemInfo.find(item);
+        auto placed = here.itemDescriptions.find(item);
+        if (info != world.itemInfo.end() && !info->second.empty()) {
+            state.messages = {info->second};
+        } else if (placed != here.itemDescriptions.end()) {
+            state.messages = {placed->second};
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // A turn passes: unsafe locations cost health, then the win / lose conditions apply
+    static void endTurn(const WorldModel& world, const WorldLocation& location, PlayerState& state) {
+        state.turn++;
+        if (!location.safe) {
+            int loss = location.healthPenalty > 0 ? location.healthPenalty : world.healthLossUnsafe;
+            state.health = std::max(0, state.health - loss);
+            if (loss > 0) {
+                state.messages.back() += " You lose " + std::to_string(loss) + " health.";
+            }
+        }
+        if (!world.winItem.empty() && state.has(world.winItem) &&
+            (world.winLocation.empty() || state.location == world.winLocation)) {
+            state.status = "won";
+            state.messages.back() += " You have won the game!";
+        } else if (state.health <= world.loseHealth) {
+            state.status = "lost";
+            state.messages.back() += " Your strength is gone. Game over.";
+        } else if (world.maxTurns > 0 && state.turn >= world.maxTurns) {
+            state.status = "lost";
+            state.messages.back() += " You are out of turns. Game over.";
+        }
+    }
+};
+
+#endif // ACTION_RESOLVER_H
@@ -10,6 +10,7 @@
 #include <chrono>
 #include <filesystem>
 #include <sys/socket.h>
+#include <poll.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -20,12 +21,20 @@
 #include <iomanip>
 #include <sstream>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 #define CPPHTTPLIB_OPENSSL_SUPPORT
 #include "../httplib/httplib.h"
 #include <openssl/sha.h>
 #include <nlohmann/json.hpp>
 #include "../llama.cpp/common/common.h"
 #include "../llama.cpp/include/llama.h"
+#include "stop_sequence_matcher.h"
+#include "prompt_token_cache.h"
+#include "request_scheduler.h"
+#include "request_deadline.h"
+#include "world_blob_cache.h"
+#include "chat_template.h"
 
 // Global flags
 static std::atomic<bool> g_shutdown_requested{false};
@@ -38,6 +47,63 @@ void signal_handler(int signal)
     g_shutdown_requested = true;
 }
 
+// Binary verdict indicators that end a validation generation (matched case-insensitively)
+enum ValidationStop
+{
+    STOP_YES = 0,
+    STOP_NO = 1,
+    STOP_VALID = 2,
+    STOP_INVALID = 3,
+    STOP_TRUE = 4,
+    STOP_FALSE = 5
+};
+
+static const StopSequenceMatcher &validationStopMatcher()
+{
+    static const StopSequenceMatcher matcher({"yes", "no", "valid", "invalid", "true", "false"}, true);
+    return matcher;
+}
+
+// Static validation prompt fragments - tokenized once per model tier at load time,
+// the prompt is assembled as VALIDATION_PREFIX + <statement> + VALIDATION_SUFFIX
+enum ValidationFragment
+{
+    FRAGMENT_VALIDATION_PREFIX = 0,
+    FRAGMENT_VALIDATION_SUFFIX
+};
+
+static const std::string VALIDATION_PREFIX =
+    "You are an ultra-permissive and creativity-loving game master validator. Your job is to ENCOURAGE player imagination and say YES to almost everything!\n\n"
+
+    "DATA TO ANALYZE:\n";
+
+static const std::string VALIDATION_SUFFIX =
+    "\n\n"
+
+    "ULTRA-PERMISSIVE GUIDELINES - Say YES unless the action is:\n"
+    "1. Completely nonsensical (like turning into a refrigerator for no reason)\n"
+    "2. Explicitly breaking fundamental game rules (like instantly killing all NPCs)\n"
+    "3. Completely unrelated to the game context\n\n"
+
+    "CREATIVITY-FIRST APPROACH:\n"
+    "- Say YES to ALL creative and imaginative actions\n"
+    "- Say YES to magical/fantasy elements even if they seem powerful\n"
+    "- Say YES to unusual character abilities and transformations\n"
+    "- Say YES to inventive problem-solving approaches\n"
+    "- Say YES to dramatic story changes and plot twists\n"
+    "- Say YES to resource gathering, crafting, and exploration\n"
+    "- Say YES to social interactions and dialogue\n"
+    "- Say YES to combat actions and skill usage\n"
+    "- Say YES to world-building and environmental changes\n"
+    "- Say YES to informational requests and observations\n"
+    "- Default to YES when uncertain - favor fun over realism!\n\n"
+
+    "REMEMBER: Players should feel free to be wildly creative. Only say NO to truly absurd or game-breaking actions.\n\n"
+
+    "Respond with exactly one word: YES (for creative/valid actions) or NO (only for truly absurd actions)\n\n"
+
+    "RESPONSE: ";
+
 // AI Model Downloader for automatic model acquisition
 class ModelDownloader
 {
@@ -318,6 +384,23 @@ private:
     std::atomic<bool> model_loading{false};
     std::string model_error = "";
 
+    // Small model tier (optional) - validations run here first and escalate
+    // to the large model only when the answer is not a clear binary verdict
+    llama_model *small_model = nullptr;
+    std::string small_model_path;
+    std::atomic<bool> small_model_loaded{false};
+    std::atomic<int> small_tier_validations{0};
+    std::atomic<int> small_tier_escalations{0};
+
+    // Game worlds by content hash; validations of game actions send only the hash
+    WorldBlobCache world_blobs;
+
+    // Pre-tokenized instruction fragments, one cache per model vocabulary
+    PromptTokenCache large_prompt_cache;
+    PromptTokenCache small_prompt_cache;
+    ChatFrame large_chat;   // Chat framing from each model's own template
+    ChatFrame small_chat;
+
     // Model Downloader
     std::unique_ptr<ModelDownloader> modelDownloader;
 
@@ -325,8 +408,33 @@ private:
     std::atomic<bool> heartbeat_running{true};
     std::thread heartbeat_thread;
 
+    // Priority work queue - per-class {max concurrent, max queued}
+    RequestScheduler scheduler{{{
+        {4, 64}, // ping / status
+        {0, 0},  // lookup (served by the game engine daemon)
+        {2, 32}, // validate
+        {1, 1},  // player_action (served by the game engine daemon)
+        {0, 0},  // narrative (served by the game engine daemon)
+        {1, 1},  // create_game (served by the game engine daemon)
+        {0, 0}   // background (no idle work in this daemon)
+    }}};
+
+    // Cancellation state of queued/running validations by dedupe key, so coalesced
+    // requests can register their own connection and deadline on the shared job
+    std::mutex cancellations_mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<RequestCancellation>> job_cancellations;
+
+    // Keep-alive connections waiting for their next request (fd -> last activity).
+    // Clients that send "keep_alive":true get newline-terminated replies and may
+    // reuse the connection; idle ones are closed after KEEPALIVE_IDLE_SECONDS.
+    static constexpr int KEEPALIVE_IDLE_SECONDS = 30;
+    std::mutex keepalive_mutex;
+    std::unordered_map<int, std::chrono::steady_clock::time_point> keepalive_connections;
+    std::thread keepalive_thread;
+
 public:
-    AIValidationDaemon(const std::string &modelPath) : model_path(modelPath)
+    AIValidationDaemon(const std::string &modelPath, const std::string &smallModelPath = "")
+        : model_path(modelPath), small_model_path(smallModelPath)
     {
         // Install signal handlers
         signal(SIGTERM, signal_handler);
@@ -497,6 +605,10 @@ public:
             std::cout << "[Daemon] Model vocabulary size: " << vocab_size << std::endl;
             std::cout << "[Daemon] STEP 6: ✓ Model verification passed!" << std::endl;
 
+            std::cout << "[Daemon] STEP 7: Pre-tokenizing validation prompt fragments..." << std::endl;
+            warmPromptCache(large_prompt_cache, large_chat, model);
+            std::cout << "[Daemon] STEP 7: ✓ Prompt fragments tokenized!" << std::endl;
+
             model_loaded = true;
             model_loading = false;
 
@@ -522,6 +634,39 @@ public:
         }
     }
 
+    bool loadSmallModel()
+    {
+        std::cout << "[ValidationDaemon] Loading small model tier: " << small_model_path << std::endl;
+
+        if (!std::filesystem::exists(small_model_path))
+        {
+            std::cerr << "[ValidationDaemon] WARNING: Small model not found - validations will use the large model" << std::endl;
+            return false;
+        }
+
+        llama_model_params model_params = llama_model_default_params();
+        model_params.n_gpu_layers = 32;
+        model_params.use_mmap = true;
+        model_params.use_mlock = false;
+
+        small_model = llama_model_load_from_file(small_model_path.c_str(), model_params);
+        if (!small_model || !llama_model_get_vocab(small_model))
+        {
+            std::cerr << "[ValidationDaemon] WARNING: Small model loading failed - validations will use the large model" << std::endl;
+            if (small_model)
+            {
+                llama_model_free(small_model);
+                small_model = nullptr;
+            }
+            return false;
+        }
+
+        warmPromptCache(small_prompt_cache, small_chat, small_model);
+        small_model_loaded = true;
+        std::cout << "[ValidationDaemon] ✓ Small model tier ready" << std::endl;
+        return true;
+    }
+
     void loadModelAsync()
     {
         std::cout << "[Daemon] Starting async model loading thread..." << std::endl;
@@ -544,35 +689,65 @@ public:
                 std::cout << "[Daemon] Model loading failed! Duration: " << duration.count() << " seconds" << std::endl;
                 std::cout << "[Daemon] Error: " << model_error << std::endl;
             }
+
+            // Small tier loads after the large model so readiness is never delayed by it
+            if (success && !small_model_path.empty()) {
+                loadSmallModel();
+            }
             std::cout.flush(); })
             .detach();
         std::cout << "[Daemon] Async model loading thread launched" << std::endl;
     }
 
-    std::string generateValidationResponse(const std::string &prompt, int max_tokens = 10)
+    // The validation prompt is one user message; harmony models answer in the final
+    // channel at low reasoning effort, so the verdict is the first generated word
+    void warmPromptCache(PromptTokenCache &cache, ChatFrame &chat, llama_model *target)
+    {
+        chat = ChatFrame::render(target, "", "low");
+        std::cout << "[ValidationDaemon] Chat framing: " << (chat.templated ? "model template" : "plain text")
+                  << (chat.harmony ? " (harmony, final channel)" : "") << std::endl;
+
+        cache.bind(llama_model_get_vocab(target));
+        cache.addFragment(FRAGMENT_VALIDATION_PREFIX, chat.prefix + VALIDATION_PREFIX, true);
+        cache.addFragment(FRAGMENT_VALIDATION_SUFFIX, VALIDATION_SUFFIX + chat.suffix);
+    }
+
+    std::string generateValidationResponse(const std::string &statement, int max_tokens = 10, bool use_small_model = false,
+                                           RequestCancellation *cancel = nullptr)
     {
         if (!model_loaded || !model)
         {
             return "{\"error\":\"Model not loaded\"}";
         }
 
-        const llama_vocab *vocab = llama_model_get_vocab(model);
+        // Fall back to the large model when the small tier is unavailable
+        bool small_tier = use_small_model && small_model_loaded;
+        llama_model *active_model = small_tier ? small_model : model;
+        const llama_vocab *vocab = llama_model_get_vocab(active_model);
 
-        const int n_prompt = -llama_tokenize(vocab, prompt.c_str(), prompt.size(), NULL, 0, true, true);
-        std::vector<llama_token> prompt_tokens(n_prompt);
-
-        if (llama_tokenize(vocab, prompt.c_str(), prompt.size(), prompt_tokens.data(), prompt_tokens.size(), true, true) < 0)
+        // Assemble the prompt from pre-tokenized instruction fragments
+        PromptTokenCache &cache = small_tier ? small_prompt_cache : large_prompt_cache;
+        PromptTokenCache::Tokens statement_tokens;
+        if (!cache.tokenize(statement, false, statement_tokens))
         {
             return "{\"error\":\"Failed to tokenize prompt\"}";
         }
 
+        PromptTokenCache::Tokens prompt_tokens;
+        prompt_tokens.reserve(cache.fragment(FRAGMENT_VALIDATION_PREFIX).size() + statement_tokens.size() +
+                              cache.fragment(FRAGMENT_VALIDATION_SUFFIX).size());
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_VALIDATION_PREFIX));
+        PromptTokenCache::append(prompt_tokens, statement_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_VALIDATION_SUFFIX));
+        const int n_prompt = prompt_tokens.size();
+
         llama_context_params ctx_params = llama_context_default_params();
         ctx_params.n_ctx = 2048;                      // Smaller context for validation tasks
         ctx_params.n_batch = std::max(256, n_prompt); // Smaller batch for efficiency
         ctx_params.no_perf = true;
         ctx_params.n_threads = 6; // Fewer threads for validation
         ctx_params.n_threads_batch = 6;
-        llama_context *ctx = llama_init_from_model(model, ctx_params);
+        llama_context *ctx = llama_init_from_model(active_model, ctx_params);
         if (!ctx)
         {
             return "{\"error\":\"Failed to create context\"}";
@@ -590,12 +765,22 @@ public:
         llama_batch batch = llama_batch_get_one(prompt_tokens.data(), prompt_tokens.size());
 
         std::string response;
+        response.reserve(64);
         int n_decode = 0;
 
+        const StopSequenceMatcher &stop_matcher = validationStopMatcher();
+        StopSequenceMatcher::MatchState stop_state;
+
         std::cout << "[ValidationDaemon] Starting binary validation..." << std::endl;
 
         for (int n_pos = 0; n_pos + batch.n_tokens < ctx_params.n_ctx && n_decode < max_tokens;)
         {
+            if (cancel && cancel->shouldStop())
+            {
+                std::cout << "[ValidationDaemon] Validation cancelled (" << cancel->reason() << ")" << std::endl;
+                break;
+            }
+
             int decode_result = llama_decode(ctx, batch);
             if (decode_result != 0)
             {
@@ -626,25 +811,21 @@ public:
             int n = llama_token_to_piece(vocab, new_token_id, buf, sizeof(buf), 0, true);
             if (n > 0)
             {
-                std::string token_str(buf, n);
-                response += token_str;
+                response.append(buf, n);
 
-                // Stop IMMEDIATELY if we get clear binary indicators
-                std::string lower_response = response;
-                std::transform(lower_response.begin(), lower_response.end(), lower_response.begin(), ::tolower);
+                // Stop IMMEDIATELY if we get clear binary indicators (incremental, case-insensitive)
+                int stop = stop_matcher.feed(stop_state, buf, n);
+                bool single_letter = response.length() == 1 &&
+                                     (std::tolower(static_cast<unsigned char>(response[0])) == 'y' ||
+                                      std::tolower(static_cast<unsigned char>(response[0])) == 'n');
 
-                if (lower_response.find("yes") != std::string::npos ||
-                    lower_response.find("no") != std::string::npos ||
-                    lower_response == "y" || lower_response == "n")
+                if (stop == STOP_YES || stop == STOP_NO || single_letter)
                 {
                     std::cout << "[ValidationDaemon] IMMEDIATE termination triggered by YES/NO: " << response << std::endl;
                     break;
                 }
 
-                if (lower_response.find("valid") != std::string::npos ||
-                    lower_response.find("invalid") != std::string::npos ||
-                    lower_response.find("true") != std::string::npos ||
-                    lower_response.find("false") != std::string::npos)
+                if (stop >= 0)
                 {
                     std::cout << "[ValidationDaemon] Early termination triggered by binary indicator: " << response << std::endl;
                     break;
@@ -667,61 +848,17 @@ public:
         llama_sampler_free(smpl);
         llama_free(ctx);
 
-        return response;
-    }
-
-    std::string processValidation(const nlohmann::json &request)
-    {
-        std::string statement = request.value("statement", "");
-
-        if (statement.empty())
+        if (cancel && cancel->isCancelled())
         {
-            return "{\"error\":\"No statement provided for validation\"}";
+            return cancel->errorResponse();
         }
 
-        // Simple binary validation prompt
-        // std::string prompt =
-        //     "You are a binary validator. Analyze the following statement and respond with exactly one word: YES or NO.\n\n"
-        //     "STATEMENT: " + statement + "\n\n"
-        //     "INSTRUCTIONS:\n"
-        //     "- If the statement is true, logical, valid, or reasonable, respond: YES\n"
-        //     "- If the statement is false, illogical, invalid, or unreasonable, respond: NO\n"
-        //     "- Do not explain your reasoning\n"
-        //     "- Do not add any other text\n"
-        //     "- Your response must be exactly one word: YES or NO\n\n"
-        //     "RESPONSE: ";
-        std::string prompt =
-            "You are an ultra-permissive and creativity-loving game master validator. Your job is to ENCOURAGE player imagination and say YES to almost everything!\n\n"
-
-            "DATA TO ANALYZE:\n" +
-            statement + "\n\n"
-
-                        "ULTRA-PERMISSIVE GUIDELINES - Say YES unless the action is:\n"
-                        "1. Completely nonsensical (like turning into a refrigerator for no reason)\n"
-                        "2. Explicitly breaking fundamental game rules (like instantly killing all NPCs)\n"
-                        "3. Completely unrelated to the game context\n\n"
-
-                        "CREATIVITY-FIRST APPROACH:\n"
-                        "- Say YES to ALL creative and imaginative actions\n"
-                        "- Say YES to magical/fantasy elements even if they seem powerful\n"
-                        "- Say YES to unusual character abilities and transformations\n"
-                        "- Say YES to inventive problem-solving approaches\n"
-                        "- Say YES to dramatic story changes and plot twists\n"
-                        "- Say YES to resource gathering, crafting, and exploration\n"
-                        "- Say YES to social interactions and dialogue\n"
-                        "- Say YES to combat actions and skill usage\n"
-                        "- Say YES to world-building and environmental changes\n"
-                        "- Say YES to informational requests and observations\n"
-                        "- Default to YES when uncertain - favor fun over realism!\n\n"
-
-                        "REMEMBER: Players should feel free to be wildly creative. Only say NO to truly absurd or game-breaking actions.\n\n"
-
-                        "Respond with exactly one word: YES (for creative/valid actions) or NO (only for truly absurd actions)\n\n"
-
-                        "RESPONSE: ";
-
-        std::string ai_response = generateValidationResponse(prompt, 5);
+        return (small_tier ? small_chat : large_chat).finalText(response);
+    }
 
+    // Map a raw model answer onto a binary verdict with a confidence score
+    void interpretValidationResponse(const std::string &ai_response, bool &is_valid, double &confidence)
+    {
         // Enhanced binary response parsing
         std::string lower_response = ai_response;
         std::transform(lower_response.begin(), lower_response.end(), lower_response.begin(), ::tolower);
@@ -743,8 +880,8 @@ public:
         bool isN = (lower_response == "n");
 
         // Determine validity - default to false for safety
-        bool is_valid = false;
-        double confidence = 0.0;
+        is_valid = false;
+        confidence = 0.0;
 
         // Perfect matches get highest confidence
         if (lower_response == "yes" || lower_response == "y")
@@ -803,6 +940,74 @@ public:
             is_valid = false;
             confidence = 0.3;
         }
+    }
+
+    std::string processValidation(const nlohmann::json &request, RequestCancellation *cancel = nullptr)
+    {
+        std::string statement = request.value("statement", "");
+
+        // A game action statement sent with a world hash leaves the world out;
+        // it is put back in front as "GameWorld: <world> -> <statement>"
+        if (request.contains("world_hash") && !statement.empty())
+        {
+            statement = "GameWorld: " + request.value("game_world", "") + " -> " + statement;
+        }
+
+        if (statement.empty())
+        {
+            return "{\"error\":\"No statement provided for validation\"}";
+        }
+
+        if (!model_loaded)
+        {
+            return notReadyResponse();
+        }
+
+        // Simple binary validation prompt
+        // std::string prompt =
+        //     "You are a binary validator. Analyze the following statement and respond with exactly one word: YES or NO.\n\n"
+        //     "STATEMENT: " + statement + "\n\n"
+        //     "INSTRUCTIONS:\n"
+        //     "- If the statement is true, logical, valid, or reasonable, respond: YES\n"
+        //     "- If the statement is false, illogical, invalid, or unreasonable, respond: NO\n"
+        //     "- Do not explain your reasoning\n"
+        //     "- Do not add any other text\n"
+        //     "- Your response must be exactly one word: YES or NO\n\n"
+        //     "RESPONSE: ";
+        // Active prompt: VALIDATION_PREFIX + statement + VALIDATION_SUFFIX (pre-tokenized at load)
+
+        bool is_valid = false;
+        double confidence = 0.0;
+        bool decided = false;
+        std::string ai_response;
+
+        // Small model tier first - escalate when it does not give a clear binary answer
+        if (small_model_loaded)
+        {
+            small_tier_validations++;
+            ai_response = generateValidationResponse(statement, 5, true, cancel);
+            if ((cancel && cancel->isCancelled()) || isErrorResponse(ai_response))
+            {
+                return ai_response;
+            }
+            interpretValidationResponse(ai_response, is_valid, confidence);
+            decided = confidence >= 0.75;
+            if (!decided)
+            {
+                small_tier_escalations++;
+                std::cout << "[ValidationDaemon] Small model answer ambiguous - escalating to large model" << std::endl;
+            }
+        }
+
+        if (!decided)
+        {
+            ai_response = generateValidationResponse(statement, 5, false, cancel);
+            if ((cancel && cancel->isCancelled()) || isErrorResponse(ai_response))
+            {
+                return ai_response;
+            }
+            interpretValidationResponse(ai_response, is_valid, confidence);
+        }
 
         std::cout << "[ValidationDaemon] Analysis:" << std::endl;
         std::cout << "[ValidationDaemon]   Statement: " << statement << std::endl;
@@ -812,10 +1017,25 @@ public:
 
         return "{\"valid\":" + std::string(is_valid ? "true" : "false") +
                ",\"confidence\":" + std::to_string(confidence) +
-               ",\"raw_response\":\"" + ai_response + "\"}";
+               ",\"raw_response\":" + nlohmann::json(ai_response).dump(-1, ' ', false, nlohmann::json::error_handler_t::replace) + "}";
+    }
+
+    // Validation answer while the model is unavailable - lets clients check readiness
+    // and validate in one request instead of pinging first
+    std::string notReadyResponse() const
+    {
+        std::string model_status = model_loading ? "loading" : (model_error.empty() ? "initializing" : "error");
+        return "{\"status\":\"not_ready\",\"model_status\":\"" + model_status + "\"" +
+               ",\"error\":\"Model not ready (" + model_status + ")\"}";
+    }
+
+    // Generation failures come back as {"error":...} and must not be read as a YES/NO answer
+    static bool isErrorResponse(const std::string &response)
+    {
+        return response.rfind("{\"error\"", 0) == 0;
     }
 
-    std::string handleRequest(const std::string &request_str)
+    std::string handleRequest(const std::string &request_str, RequestCancellation *cancel = nullptr)
     {
         try
         {
@@ -824,7 +1044,12 @@ public:
 
             if (type == "validate")
             {
-                return processValidation(request);
+                // The world may have been evicted while the request was queued
+                if (!world_blobs.resolve(request))
+                {
+                    return WorldBlobCache::missResponse(request.value("world_hash", ""));
+                }
+                return processValidation(request, cancel);
             }
             else if (type == "ping")
             {
@@ -841,6 +1066,11 @@ public:
                 return "{\"status\":\"" + status + "\"" +
                        ",\"model_loaded\":" + std::string(model_loaded ? "true" : "false") +
                        ",\"model_loading\":" + std::string(model_loading ? "true" : "false") +
+                       ",\"small_model_loaded\":" + std::string(small_model_loaded ? "true" : "false") +
+                       ",\"small_tier_validations\":" + std::to_string(small_tier_validations.load()) +
+                       ",\"small_tier_escalations\":" + std::to_string(small_tier_escalations.load()) +
+                       ",\"queues\":{" + scheduler.metricsJson() + "}" +
+                       ",\"world_cache\":" + world_blobs.metricsJson() +
                        (model_error.empty() ? "" : ",\"error\":\"" + model_error + "\"") +
                        "}";
             }
@@ -855,47 +1085,253 @@ public:
         }
     }
 
-    void handleClient(int client_socket)
+    static RequestClass classifyRequest(const std::string &type)
     {
-        std::cout << "[ValidationDaemon] Handling client (fd=" << client_socket << ", thread_id=" << std::this_thread::get_id() << ")" << std::endl;
+        if (type == "validate")
+            return RequestClass::Validate;
+        return RequestClass::Ping; // ping and malformed requests are answered cheaply
+    }
 
+    // Read one request message; keeps reading until the buffered bytes form a complete JSON document
+    bool readRequest(int client_socket, std::string &request)
+    {
         char buffer[8192];
-        ssize_t bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
+        while (true)
+        {
+            ssize_t bytes_received = recv(client_socket, buffer, sizeof(buffer), 0);
+            if (bytes_received == 0)
+            {
+                if (request.empty())
+                    std::cout << "[ValidationDaemon] Client closed connection" << std::endl;
+                return !request.empty();
+            }
+            if (bytes_received < 0)
+            {
+                std::cerr << "[ValidationDaemon] Failed to receive data: " << strerror(errno) << std::endl;
+                return !request.empty();
+            }
+            request.append(buffer, bytes_received);
+            if (nlohmann::json::accept(request))
+            {
+                return true;
+            }
+        }
+    }
+
+    void sendResponse(int client_socket, const std::string &response, bool keep_alive = false)
+    {
+        std::cout << "[ValidationDaemon] Generated response (" << response.length() << " bytes)" << std::endl;
+        std::cout << "[ValidationDaemon] Response preview: " << response.substr(0, 100) << "..." << std::endl;
+
+        // Keep-alive replies are newline-framed since the connection stays open
+        std::string framed = keep_alive ? response + "\n" : response;
+        ssize_t bytes_sent = send(client_socket, framed.c_str(), framed.length(), MSG_NOSIGNAL);
+        if (bytes_sent == -1)
+        {
+            std::cerr << "[ValidationDaemon] Failed to send response: " << strerror(errno) << std::endl;
+        }
+        else
+        {
+            std::cout << "[ValidationDaemon] Sent " << bytes_sent << " bytes successfully" << std::endl;
+        }
 
-        if (bytes_received > 0)
+        if (keep_alive && bytes_sent != -1 && running)
         {
-            buffer[bytes_received] = '\0';
-            std::string request(buffer);
+            std::lock_guard<std::mutex> lock(keepalive_mutex);
+            keepalive_connections[client_socket] = std::chrono::steady_clock::now();
+            return;
+        }
+
+        close(client_socket);
+        std::cout << "[ValidationDaemon] Client connection closed (fd=" << client_socket << ")" << std::endl;
+    }
 
-            std::cout << "[ValidationDaemon] Received " << bytes_received << " bytes" << std::endl;
-            std::cout << "[ValidationDaemon] Request preview: " << request.substr(0, 100) << "..." << std::endl;
+    // Watch idle keep-alive connections: a readable one carries the next request (or
+    // EOF, which dispatchClient handles by closing), an expired one is closed
+    void startKeepAliveWatcher()
+    {
+        keepalive_thread = std::thread([this]()
+                                       {
+            while (running && !g_shutdown_requested) {
+                std::vector<struct pollfd> fds;
+                {
+                    std::lock_guard<std::mutex> lock(keepalive_mutex);
+                    auto now = std::chrono::steady_clock::now();
+                    for (auto it = keepalive_connections.begin(); it != keepalive_connections.end();) {
+                        if (now - it->second > std::chrono::seconds(KEEPALIVE_IDLE_SECONDS)) {
+                            close(it->first);
+                            it = keepalive_connections.erase(it);
+                            continue;
+                        }
+                        fds.push_back({it->first, POLLIN, 0});
+                        ++it;
+                    }
+                }
 
-            std::string response = handleRequest(request);
+                if (fds.empty()) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                    continue;
+                }
+                if (poll(fds.data(), fds.size(), 50) <= 0) continue;
 
-            std::cout << "[ValidationDaemon] Generated response (" << response.length() << " bytes)" << std::endl;
-            std::cout << "[ValidationDaemon] Response preview: " << response.substr(0, 100) << "..." << std::endl;
+                for (const auto &pfd : fds) {
+                    if (pfd.revents == 0) continue;
+                    {
+                        std::lock_guard<std::mutex> lock(keepalive_mutex);
+                        keepalive_connections.erase(pfd.fd);
+                    }
+                    dispatchClient(pfd.fd);
+                }
+            }
 
-            ssize_t bytes_sent = send(client_socket, response.c_str(), response.length(), 0);
-            if (bytes_sent == -1)
+            std::lock_guard<std::mutex> lock(keepalive_mutex);
+            for (const auto &connection : keepalive_connections) {
+                close(connection.first);
+            }
+            keepalive_connections.clear(); });
+    }
+
+    // Read the request on the accept thread and hand it to the priority scheduler.
+    // The response is written by the worker that runs the job, or immediately when
+    // the request class is saturated.
+    void dispatchClient(int client_socket)
+    {
+        // Bound how long a slow client can hold the accept loop
+        struct timeval timeout;
+        timeout.tv_sec = 5;
+        timeout.tv_usec = 0;
+        setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::string request;
+        if (!readRequest(client_socket, request))
+        {
+            close(client_socket);
+            return;
+        }
+
+        std::cout << "[ValidationDaemon] Received " << request.length() << " bytes" << std::endl;
+        std::cout << "[ValidationDaemon] Request preview: " << request.substr(0, 100) << "..." << std::endl;
+
+        RequestClass request_class = RequestClass::Ping;
+        uint64_t dedupe_key = 0;
+        int64_t deadline_ms = 0;
+        bool keep_alive = false;
+        try
+        {
+            nlohmann::json parsed = nlohmann::json::parse(request);
+            request_class = classifyRequest(parsed.value("type", ""));
+            deadline_ms = parsed.value("deadline_ms", static_cast<int64_t>(0));
+            keep_alive = parsed.value("keep_alive", false);
+            parsed.erase("keep_alive");
+
+            // A validation naming an unknown world is answered right away so the
+            // client resends it with the world text
+            if (request_class == RequestClass::Validate && !world_blobs.admit(parsed))
             {
-                std::cerr << "[ValidationDaemon] Failed to send response: " << strerror(errno) << std::endl;
+                std::cout << "[ValidationDaemon] World not cached - asking client for the world text" << std::endl;
+                sendResponse(client_socket, WorldBlobCache::missResponse(parsed.value("world_hash", "")), keep_alive);
+                return;
             }
-            else
+
+            // Identical validations (e.g. a contract retry) share one job; the retry
+            // carries a fresh deadline, so it is left out of the key. The world hash
+            // stands in for the world text whether or not the text was sent.
+            if (request_class == RequestClass::Validate)
             {
-                std::cout << "[ValidationDaemon] Sent " << bytes_sent << " bytes successfully" << std::endl;
+                parsed.erase("deadline_ms");
+                if (parsed.contains("world_hash"))
+                    parsed.erase("game_world");
+                dedupe_key = ContentHash::fnv1a64(parsed.dump());
             }
         }
-        else if (bytes_received == 0)
+        catch (...)
+        {
+            // handleRequest reports the parse error
+        }
+
+        if (deadline_ms > 0 && RequestCancellation::nowUnixMs() >= deadline_ms)
         {
-            std::cout << "[ValidationDaemon] Client closed connection" << std::endl;
+            std::cout << "[ValidationDaemon] Request arrived past its deadline - not queued" << std::endl;
+            sendResponse(client_socket, "{\"error\":\"cancelled\",\"reason\":\"deadline_exceeded\"}", keep_alive);
+            return;
+        }
+
+        // Answer validations immediately while the model is unavailable instead of queueing them
+        if (request_class == RequestClass::Validate && !model_loaded)
+        {
+            sendResponse(client_socket, notReadyResponse(), keep_alive);
+            return;
+        }
+
+        // Attach to the cancellation state of an identical in-flight job, or start a new one
+        std::shared_ptr<RequestCancellation> cancellation;
+        bool registered = false;
+        if (dedupe_key != 0)
+        {
+            std::lock_guard<std::mutex> lock(cancellations_mutex);
+            auto existing = job_cancellations.find(dedupe_key);
+            if (existing != job_cancellations.end())
+            {
+                cancellation = existing->second;
+                cancellation->addClient(client_socket, deadline_ms);
+            }
+            else
+            {
+                cancellation = std::make_shared<RequestCancellation>(client_socket, deadline_ms);
+                job_cancellations[dedupe_key] = cancellation;
+                registered = true;
+            }
         }
         else
         {
-            std::cerr << "[ValidationDaemon] Failed to receive data: " << strerror(errno) << std::endl;
+            cancellation = std::make_shared<RequestCancellation>(client_socket, deadline_ms);
         }
 
-        close(client_socket);
-        std::cout << "[ValidationDaemon] Client connection closed (fd=" << client_socket << ")" << std::endl;
+        RequestScheduler::Admission admission = scheduler.submit(
+            request_class, dedupe_key,
+            [this, request, cancellation, dedupe_key]()
+            {
+                // Clients may have given up while the job waited in the queue
+                std::string response = cancellation->shouldStop() ? cancellation->errorResponse()
+                                                                   : handleRequest(request, cancellation.get());
+                releaseCancellation(dedupe_key, cancellation);
+                return response;
+            },
+            [this, client_socket, keep_alive](const std::string &response)
+            { sendResponse(client_socket, response, keep_alive); });
+
+        if (admission == RequestScheduler::Admission::Rejected)
+        {
+            if (registered)
+            {
+                releaseCancellation(dedupe_key, cancellation);
+            }
+
+            int retry_after_ms = scheduler.retryAfterMs(request_class);
+            std::cout << "[ValidationDaemon] Queue full for " << requestClassName(request_class)
+                      << " - rejecting with retry_after_ms=" << retry_after_ms << std::endl;
+            sendResponse(client_socket, "{\"status\":\"busy\",\"error\":\"busy\"" +
+                                            std::string(",\"request_class\":\"") + requestClassName(request_class) + "\"" +
+                                            ",\"retry_after_ms\":" + std::to_string(retry_after_ms) + "}",
+                         keep_alive);
+        }
+        else if (admission == RequestScheduler::Admission::Coalesced)
+        {
+            std::cout << "[ValidationDaemon] Identical " << requestClassName(request_class)
+                      << " request already in progress - attached to existing job" << std::endl;
+        }
+    }
+
+    void releaseCancellation(uint64_t dedupe_key, const std::shared_ptr<RequestCancellation> &cancellation)
+    {
+        if (dedupe_key == 0)
+            return;
+        std::lock_guard<std::mutex> lock(cancellations_mutex);
+        auto it = job_cancellations.find(dedupe_key);
+        if (it != job_cancellations.end() && it->second == cancellation)
+        {
+            job_cancellations.erase(it);
+        }
     }
 
     bool startServer()
@@ -964,7 +1400,7 @@ public:
 
         // Listen for connections
         std::cout << "[Daemon] STEP 4: Starting to listen for connections..." << std::endl;
-        if (listen(server_socket, 5) == -1)
+        if (listen(server_socket, SOMAXCONN) == -1)
         {
             std::cerr << "[Daemon] ERROR: Failed to listen on socket: " << strerror(errno) << std::endl;
             close(server_socket);
@@ -994,6 +1430,12 @@ public:
         // Start model loading asynchronously - don't block!
         loadModelAsync();
 
+        // Start the bounded worker pool for queued requests
+        scheduler.start();
+
+        // Serve follow-up requests on kept-alive client connections
+        startKeepAliveWatcher();
+
         std::cout << "[Daemon] ========== Daemon Ready for Requests ==========" << std::endl;
         std::cout << "[Daemon] Model loading in progress - accepting connections" << std::endl;
         std::cout << "[Daemon] TCP server listening on port: " << port << std::endl;
@@ -1043,11 +1485,8 @@ public:
             std::string status = model_loaded ? "ready" : (model_loading ? "loading" : "error");
             std::cout << "[Daemon] Current model status: " << status << std::endl;
 
-            // Handle client in separate thread for concurrency
-            std::thread client_thread(&AIValidationDaemon::handleClient, this, client_socket);
-            client_thread.detach();
-
-            std::cout << "[Daemon] Client handler thread started for connection " << connection_count << std::endl;
+            // Queue the request by priority class - workers are bounded by the scheduler
+            dispatchClient(client_socket);
             std::cout.flush();
         }
 
@@ -1070,6 +1509,18 @@ public:
 
         stopHeartbeat();
         stop();
+        if (keepalive_thread.joinable())
+        {
+            keepalive_thread.join();
+        }
+        scheduler.stop();
+
+        if (small_model)
+        {
+            std::cout << "[Daemon] Freeing small model..." << std::endl;
+            llama_model_free(small_model);
+            small_model = nullptr;
+        }
 
         if (model)
         {
@@ -1091,6 +1542,7 @@ public:
 int main(int argc, char *argv[])
 {
     std::string model_path = "../../../model/gpt-oss-20b-Q5_K_M.gguf";
+    std::string small_model_path = ""; // Optional small model tier
 
     // Parse command line arguments
     for (int i = 1; i < argc; i++)
@@ -1105,6 +1557,10 @@ int main(int argc, char *argv[])
         {
             model_path = arg.substr(8); // Skip "--model="
         }
+        else if (arg.find("--small-model=") == 0)
+        {
+            small_model_path = arg.substr(14); // Skip "--small-model="
+        }
         else if (i == 1 && arg[0] != '-')
         {
             // First non-flag argument is model path (backward compatibility)
@@ -1114,6 +1570,7 @@ int main(int argc, char *argv[])
 
     std::cout << "[ValidationDaemon] ========== AI VALIDATION DAEMON STARTUP ==========" << std::endl;
     std::cout << "[ValidationDaemon] Starting AI Validation Daemon with model: " << model_path << std::endl;
+    std::cout << "[ValidationDaemon] Small model tier: " << (small_model_path.empty() ? "disabled" : small_model_path) << std::endl;
     std::cout << "[ValidationDaemon] Process ID: " << getpid() << std::endl;
     std::cout << "[ValidationDaemon] Working directory: " << std::filesystem::current_path() << std::endl;
     std::cout << "[ValidationDaemon] Test mode: " << (g_test_mode ? "ENABLED" : "DISABLED") << std::endl;
@@ -1128,7 +1585,7 @@ int main(int argc, char *argv[])
     try
     {
         std::cout << "[ValidationDaemon] Creating validation daemon instance..." << std::endl;
-        AIValidationDaemon daemon(model_path);
+        AIValidationDaemon daemon(model_path, small_model_path);
 
         std::cout << "[ValidationDaemon] Starting daemon run loop..." << std::endl;
         daemon.run();
@@ -1,5 +1,7 @@
 // filepath: /home/deilnode3/mohsan/evernode/evernode_c/src/ai_jury_module.cpp
 #include "ai_jury_module.h"
+#include "request_deadline.h"
+#include "content_hash.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -14,6 +16,7 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <cstring>
+#include <cerrno>
 #include <filesystem>
 #include <signal.h>
 #include <sys/wait.h>
@@ -25,6 +28,7 @@ private:
     pid_t daemonPid = -1;
     std::string daemonPath = "../../../ai_jury_daemon";  // AI Jury daemon binary
     std::string pidFile = "../../../ai_jury_daemon.pid";
+    std::string smallModelPath = "../../../model/Llama-3.2-1B-Instruct-Q4_K_M.gguf";  // Optional fast tier
     
     bool isDaemonProcessRunning(pid_t pid) {
         if (pid <= 0) return false;
@@ -127,7 +131,13 @@ public:
             std::cout << "[AIJury Child] Executing daemon: " << daemonPath << std::endl;
             std::cout.flush();
             
-            execl(daemonPath.c_str(), "ai_jury_daemon", (char*)nullptr);
+            // Enable the small model tier only when its model file has been deployed
+            if (std::filesystem::exists(smallModelPath)) {
+                std::string smallModelArg = "--small-model=" + smallModelPath;
+                execl(daemonPath.c_str(), "ai_jury_daemon", smallModelArg.c_str(), (char*)nullptr);
+            } else {
+                execl(daemonPath.c_str(), "ai_jury_daemon", (char*)nullptr);
+            }
             std::cerr << "[AIJury Child] FATAL: Failed to exec daemon: " << strerror(errno) << std::endl;
             exit(1);
         } else if (daemonPid > 0) {
@@ -189,15 +199,35 @@ static std::unique_ptr<DaemonManager> g_daemonManager = nullptr;
 
 namespace AIJury {
 
+bool startJuryDaemon() {
+    if (!g_daemonManager) {
+        g_daemonManager = std::make_unique<DaemonManager>();
+    }
+    return g_daemonManager->startDaemon();
+}
+
+RequestId makeRequestId(uint64_t round, const std::string& userKey, const std::string& input, size_t inputIndex) {
+    uint64_t hash = ContentHash::fnv1a64Le(round);
+    hash = ContentHash::fnv1a64(userKey.data(), userKey.size(), hash);
+    hash = ContentHash::fnv1a64Le(inputIndex, hash);
+    hash = ContentHash::fnv1a64(input.data(), input.size(), hash);
+    RequestId id = hash & REQUEST_ID_MASK;
+    return id != 0 ? id : 1;
+}
+
 // Vote implementation
 std::string Vote::toJson() const {
     nlohmann::json j;
     j["requestId"] = requestId;
+    j["round"] = round;
     j["isValid"] = isValid;
     j["confidence"] = confidence;
     j["reason"] = reason;
     j["juryId"] = juryId;
     j["context"] = context;
+    if (!sender.empty()) {
+        j["sender"] = sender;   // Persisted with carried-over requests; overwritten on NPL receipt
+    }
     return j.dump();
 }
 
@@ -205,12 +235,14 @@ Vote Vote::fromJson(const std::string& json) {
     Vote vote;
     try {
         nlohmann::json j = nlohmann::json::parse(json);
-        vote.requestId = j.value("requestId", 0);
+        vote.requestId = j.value("requestId", static_cast<RequestId>(0));
+        vote.round = j.value("round", static_cast<uint64_t>(0));
         vote.isValid = j.value("isValid", false);
         vote.confidence = j.value("confidence", 0.0);
         vote.reason = j.value("reason", "");
         vote.juryId = j.value("juryId", "");
         vote.context = j.value("context", "");
+        vote.sender = j.value("sender", "");
     } catch (const std::exception& e) {
         std::cerr << "[AIJury] Error parsing vote JSON: " << e.what() << std::endl;
     }
@@ -230,43 +262,53 @@ std::string AIModelDecisionEngine::getEngineInfo() const {
     return "AIModelDecisionEngine v1.0 - AI Jury Daemon: " + status;
 }
 
+AIModelDecisionEngine::~AIModelDecisionEngine() {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    for (auto& connection : idleConnections) {
+        closeAIDaemonConnection(connection);
+    }
+}
+
+// Non-blocking: make sure the daemon process is up and take one readiness reading.
+// makeDecision re-checks readiness per request, so nothing waits for the model here.
 bool AIModelDecisionEngine::loadModel() {
-    std::cout << "[AIJury] Loading AI model..." << std::endl;
-    // Ping daemon first
-    if (!pingAIDaemon()) {
+    std::cout << "[AIJury] Connecting to AI jury daemon..." << std::endl;
+    std::string pingResp = sendToAIDaemon("{\"type\":\"ping\"}");
+    bool reachable = false;
+    try {
+        auto resp = nlohmann::json::parse(pingResp);
+        reachable = resp.contains("status");
+        recordReadiness(resp.value("status", "") == "ready" && resp.value("model_loaded", false));
+    } catch (...) {
+        recordReadiness(false);
+    }
+
+    if (!reachable) {
         if (!g_daemonManager->startDaemon()) {
             std::cerr << "[AIJury] Failed to start AI daemon" << std::endl;
-            return false;
-        }
-        // Wait a few seconds for daemon to start
-        std::this_thread::sleep_for(std::chrono::seconds(2));
-    }
-    // Wait for model to be ready using daemon's status
-    for (int i = 0; i < 300; ++i) {
-        std::string pingResp = sendToAIDaemon("{\"type\":\"ping\"}");
-        try {
-            auto resp = nlohmann::json::parse(pingResp);
-            if (resp.value("status", "") == "ready" && resp.value("model_loaded", false)) {
-                modelLoaded = true;
-                std::cout << "[AIJury] AI model loaded and ready" << std::endl;
-                return true;
-            }
-        } catch (...) {}
-        if (i % 30 == 0 && i > 0) {
-            std::cout << "[AIJury] Still waiting for AI model... (" << i << "/300 seconds)" << std::endl;
         }
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        return false;
     }
-    std::cout << "[AIJury] Timeout waiting for AI model readiness" << std::endl;
-    modelLoaded = false;
-    return false;
+    std::cout << "[AIJury] AI model " << (modelLoaded ? "ready" : "not ready yet - loading in background") << std::endl;
+    return modelLoaded;
 }
 
-bool AIModelDecisionEngine::pingAIDaemon() {
-    // Simple TCP connection test to AI daemon
+void AIModelDecisionEngine::recordReadiness(bool ready) {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    modelLoaded = ready;
+    readinessCheckedAt = std::chrono::steady_clock::now();
+}
+
+bool AIModelDecisionEngine::recentlyNotReady() const {
+    std::lock_guard<std::mutex> lock(stateMutex);
+    return !modelLoaded && readinessCheckedAt != std::chrono::steady_clock::time_point{} &&
+           std::chrono::steady_clock::now() - readinessCheckedAt < std::chrono::milliseconds(READINESS_TTL_MS);
+}
+
+int AIModelDecisionEngine::connectToAIDaemon() {
     int sock = socket(AF_INET, SOCK_STREAM, 0);
     if (sock < 0) {
-        return false;
+        return -1;
     }
     
     struct sockaddr_in serverAddr;
@@ -277,60 +319,133 @@ bool AIModelDecisionEngine::pingAIDaemon() {
     
     // Set socket timeout
     struct timeval timeout;
-    timeout.tv_sec = 2;
+    timeout.tv_sec = 120;  // 120 second timeout for AI responses (model can be slow)
     timeout.tv_usec = 0;
     setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
     setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
     
-    bool connected = connect(sock, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) == 0;
-    close(sock);
-    
-    return connected;
+    if (connect(sock, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+void AIModelDecisionEngine::closeAIDaemonConnection(DaemonConnection& connection) {
+    if (connection.socket != -1) {
+        close(connection.socket);
+        connection.socket = -1;
+    }
+    connection.receiveBuffer.clear();
 }
 
 std::string AIModelDecisionEngine::sendToAIDaemon(const std::string& request) {
-    // Connect to AI daemon via TCP
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock < 0) {
-        return "{\"error\": \"Failed to create socket\"}";
+    // Honour the daemon's admission control: back off on "busy" replies using its retry hint
+    const int maxAttempts = 3;
+    std::string response;
+    for (int attempt = 1; attempt <= maxAttempts; attempt++) {
+        response = sendToAIDaemonOnce(request);
+        if (response.find("\"status\":\"busy\"") == std::string::npos) {
+            return response;
+        }
+        
+        int retryAfterMs = 1000;
+        try {
+            retryAfterMs = nlohmann::json::parse(response).value("retry_after_ms", 1000);
+        } catch (...) {}
+        retryAfterMs = std::min(std::max(retryAfterMs, 100), 5000);
+        
+        std::cout << "[AIJury] Daemon busy - retrying in " << retryAfterMs << "ms (attempt "
+                  << attempt << "/" << maxAttempts << ")" << std::endl;
+        if (attempt < maxAttempts) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(retryAfterMs));
+        }
+    }
+    return response;
+}
+
+std::string AIModelDecisionEngine::sendToAIDaemonOnce(const std::string& request) {
+    // Ask the daemon to keep the connection open for the next request
+    std::string keptAliveRequest = request;
+    try {
+        nlohmann::json parsed = nlohmann::json::parse(request);
+        parsed["keep_alive"] = true;
+        keptAliveRequest = parsed.dump();
+    } catch (...) {}
+    
+    // Take an idle connection; a new one is opened when all are in use
+    DaemonConnection connection;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!idleConnections.empty()) {
+            connection = std::move(idleConnections.back());
+            idleConnections.pop_back();
+        }
     }
     
-    struct sockaddr_in serverAddr;
-    memset(&serverAddr, 0, sizeof(serverAddr));
-    serverAddr.sin_family = AF_INET;
-    serverAddr.sin_port = htons(8766);  // AI jury daemon port (matches daemon configuration)
-    inet_pton(AF_INET, "127.0.0.1", &serverAddr.sin_addr);
-    
-    // Set socket timeout
-    struct timeval timeout;
-    timeout.tv_sec = 120;  // 120 second timeout for AI responses (model can be slow)
-    timeout.tv_usec = 0;
-    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-    setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    bool reused = connection.socket != -1;
+    std::string response;
+    bool exchanged = exchangeWithAIDaemon(connection, keptAliveRequest, response);
     
-    if (connect(sock, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
-        close(sock);
-        return "{\"error\": \"Failed to connect to AI daemon\"}";
+    // The daemon closes kept-alive connections after a while - retry once on a fresh one
+    if (!exchanged && reused && response == "{\"error\": \"Connection closed by AI daemon\"}") {
+        exchangeWithAIDaemon(connection, keptAliveRequest, response);
     }
     
-    // Send request
-    ssize_t sent = send(sock, request.c_str(), request.length(), 0);
-    if (sent < 0) {
-        close(sock);
-        return "{\"error\": \"Failed to send request\"}";
+    if (connection.socket != -1) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        idleConnections.push_back(std::move(connection));
+    }
+    return response;
+}
+
+// One request/reply on the kept-alive connection, connecting first if needed.
+// Replies are newline-terminated; on failure the connection is dropped and
+// response holds an error object.
+bool AIModelDecisionEngine::exchangeWithAIDaemon(DaemonConnection& connection, const std::string& request,
+                                                 std::string& response) {
+    int& daemonSocket = connection.socket;
+    std::string& receiveBuffer = connection.receiveBuffer;
+    if (daemonSocket == -1) {
+        daemonSocket = connectToAIDaemon();
+        if (daemonSocket == -1) {
+            response = "{\"error\": \"Failed to connect to AI daemon\"}";
+            return false;
+        }
     }
     
-    // Receive response
-    char buffer[4096];
-    ssize_t received = recv(sock, buffer, sizeof(buffer) - 1, 0);
-    close(sock);
+    std::string framed = request + "\n";
+    if (send(daemonSocket, framed.c_str(), framed.length(), MSG_NOSIGNAL) < 0) {
+        closeAIDaemonConnection(connection);
+        response = "{\"error\": \"Connection closed by AI daemon\"}";
+        return false;
+    }
     
-    if (received > 0) {
-        buffer[received] = '\0';
-        return std::string(buffer);
+    size_t newline;
+    while ((newline = receiveBuffer.find('\n')) == std::string::npos) {
+        char buffer[4096];
+        ssize_t received = recv(daemonSocket, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            receiveBuffer.append(buffer, received);
+            continue;
+        }
+        
+        // A daemon without keep-alive support replies and closes the connection
+        if (received == 0 && !receiveBuffer.empty()) {
+            response = receiveBuffer;
+            closeAIDaemonConnection(connection);
+            return true;
+        }
+        bool timedOut = received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        closeAIDaemonConnection(connection);
+        response = timedOut ? "{\"error\": \"No response from AI daemon\"}"
+                            : "{\"error\": \"Connection closed by AI daemon\"}";
+        return false;
     }
     
-    return "{\"error\": \"No response from AI daemon\"}";
+    response = receiveBuffer.substr(0, newline);
+    receiveBuffer.erase(0, newline + 1);
+    return true;
 }
 
 std::string AIModelDecisionEngine::getDaemonStats() const {
@@ -338,50 +453,72 @@ std::string AIModelDecisionEngine::getDaemonStats() const {
     return const_cast<AIModelDecisionEngine*>(this)->sendToAIDaemon("{\"type\":\"ping\"}");
 }
 
-Decision AIModelDecisionEngine::makeDecision(const std::string& messageType, 
+Decision AIModelDecisionEngine::makeDecision(const std::string& /*messageType*/, 
                                            const std::string& messageData, 
-                                           const std::string& context) {
+                                           const std::string& /*context*/) {
+    return requestDecision(messageData, "", "");
+}
+
+Decision AIModelDecisionEngine::makeWorldDecision(const std::string& /*messageType*/,
+                                                const std::string& worldHash,
+                                                const std::string& gameWorld,
+                                                const std::string& messageData,
+                                                const std::string& /*context*/) {
+    return requestDecision(messageData, worldHash, gameWorld);
+}
+
+Decision AIModelDecisionEngine::requestDecision(const std::string& statement,
+                                              const std::string& worldHash,
+                                              const std::string& gameWorld) {
     Decision decision;
     decision.isValid = false;
     decision.confidence = 0.0;
     decision.reason = "AI model not available";
     decision.metadata = "";
 
-    // Always ping daemon and check model status before validation
-    if (!pingAIDaemon()) {
-        decision.reason = "AI daemon not running";
-        decision.isValid = true;
-        decision.confidence = 0.1;
-        return decision;
-    }
-    std::string pingResp = sendToAIDaemon("{\"type\":\"ping\"}");
-    try {
-        auto resp = nlohmann::json::parse(pingResp);
-        if (resp.value("status", "") != "ready" || !resp.value("model_loaded", false)) {
-            decision.reason = "AI model not ready (" + resp.value("status", "") + ")";
-            decision.isValid = true;
-            decision.confidence = 0.1;
-            return decision;
-        }
-    } catch (...) {
-        decision.reason = "Failed to parse daemon status";
+    // A recent "not ready" reading answers without contacting the daemon
+    if (recentlyNotReady()) {
+        decision.reason = "AI model not ready";
         decision.isValid = true;
         decision.confidence = 0.1;
         return decision;
     }
-    // Prepare AI request
+
+    // Prepare AI request - the daemon reports "not_ready" itself, so no ping first
     nlohmann::json aiRequest;
     aiRequest["type"] = "validate";
-    aiRequest["statement"] = messageData;
+    aiRequest["statement"] = statement;
+    if (!worldHash.empty()) {
+        aiRequest["world_hash"] = worldHash;
+    }
+    // Stop the daemon shortly before our 120s receive timeout gives up on the reply
+    aiRequest["deadline_ms"] = RequestCancellation::deadlineIn(115000);
     // Note: context is not used by the daemon but we could add it later
     std::string response = sendToAIDaemon(aiRequest.dump());
+    if (!worldHash.empty() && response.find("\"status\":\"world_cache_miss\"") != std::string::npos) {
+        // The daemon does not hold this world yet - send it once, later turns hit the cache
+        aiRequest["game_world"] = gameWorld;
+        response = sendToAIDaemon(aiRequest.dump());
+    }
     try {
         nlohmann::json aiResponse = nlohmann::json::parse(response);
-        if (aiResponse.contains("error")) {
-            decision.reason = "AI error: " + aiResponse["error"].get<std::string>();
+        if (aiResponse.value("status", "") == "not_ready") {
+            recordReadiness(false);
+            decision.reason = "AI model not ready (" + aiResponse.value("model_status", "") + ")";
+            decision.isValid = true;
+            decision.confidence = 0.1;
+        } else if (aiResponse.contains("error")) {
+            std::string error = aiResponse["error"].get<std::string>();
+            if (error == "Failed to connect to AI daemon") {
+                recordReadiness(false);
+                decision.reason = "AI daemon not running";
+            } else {
+                decision.reason = "AI error: " + error;
+            }
             decision.isValid = true;
             decision.confidence = 0.1;
         } else {
+            recordReadiness(true);
             if (aiResponse.contains("valid")) {
                 decision.isValid = aiResponse["valid"].get<bool>();
             }
@@ -411,30 +548,62 @@ AIJuryModule::AIJuryModule(std::unique_ptr<IDecisionEngine> engine)
 void AIJuryModule::processRequest(const hp_user* user, 
                                 const std::string& messageType, 
                                 const std::string& messageData, 
-                                int requestId, 
+                                RequestId requestId, 
                                 int peerCount,
-                                const std::string& context) {
+                                const std::string& context,
+                                const std::string& gameWorld,
+                                const std::string& worldHash) {
     std::cout << "[AIJury] Processing request " << requestId << " of type: " << messageType << std::endl;
     
-    // Create new request state
+    // Create new request state. The statement and context are only needed for the
+    // decision below, so they are not copied into the tracked state.
     auto state = std::make_unique<RequestState>();
     state->user = user;
     state->requestId = requestId;
     state->messageType = messageType;
-    state->messageData = messageData;
-    state->context = context;
+    
+    // Register before deciding: other game workers read NPL while this decision runs,
+    // and peer votes for this request must find it. Votes that arrived even earlier
+    // were held back and are counted now.
+    std::vector<Vote> heldVotes;
+    {
+        std::lock_guard<std::mutex> lock(requestsMutex);
+        activeRequests[requestId] = std::move(state);
+        auto early = earlyVotes.find(requestId);
+        if (early != earlyVotes.end()) {
+            heldVotes = std::move(early->second);
+            earlyVotes.erase(early);
+        }
+    }
+    for (const Vote& held : heldVotes) {
+        recordVote(held, peerCount);
+    }
     
     // Make AI decision
-    Decision decision = decisionEngine->makeDecision(messageType, messageData, context);
+    Decision decision = worldHash.empty()
+        ? decisionEngine->makeDecision(messageType, messageData, context)
+        : decisionEngine->makeWorldDecision(messageType, worldHash, gameWorld, messageData, context);
     
     // Create vote
     Vote vote;
     vote.requestId = requestId;
+    {
+        std::lock_guard<std::mutex> lock(requestsMutex);
+        vote.round = currentRound;
+    }
     vote.isValid = decision.isValid;
     vote.confidence = decision.confidence;
     vote.reason = decision.reason;
     vote.juryId = juryId;
     vote.context = context;
+    {
+        // Kept so a request carried into a later round can broadcast it again
+        std::lock_guard<std::mutex> lock(requestsMutex);
+        RequestState* registered = findRequest(requestId);
+        if (registered) {
+            registered->ownVote = vote;
+        }
+    }
     
     // Broadcast vote to other peers
     if (nplBroadcast) {
@@ -442,9 +611,6 @@ void AIJuryModule::processRequest(const hp_user* user,
         std::cout << "[AIJury] Broadcasted vote for request " << requestId << std::endl;
     }
     
-    // Store the request state for consensus tracking
-    activeRequests.push_back(std::move(state));
-    
     std::cout << "[AIJury] Vote: " << (decision.isValid ? "VALID" : "INVALID") 
               << " (confidence: " << decision.confidence << ") - " << decision.reason << std::endl;
     
@@ -455,43 +621,137 @@ void AIJuryModule::processRequest(const hp_user* user,
     // }
 }
 
-void AIJuryModule::processVote(const std::string& voteJson, int peerCount) {
-    Vote vote = Vote::fromJson(voteJson);
+void AIJuryModule::restoreRequest(const hp_user* user,
+                                  RequestId requestId,
+                                  const std::string& messageType,
+                                  const Vote& ownVote,
+                                  const std::vector<Vote>& votes,
+                                  int peerCount) {
+    std::cout << "[AIJury] Restoring request " << requestId << " with " << votes.size() << " vote(s)" << std::endl;
     
-    // Find the corresponding request
-    RequestState* state = findRequest(vote.requestId);
-    if (!state) {
-        std::cout << "[AIJury] Received vote for unknown request " << vote.requestId << std::endl;
-        return;
+    auto state = std::make_unique<RequestState>();
+    state->user = user;
+    state->requestId = requestId;
+    state->messageType = messageType;
+    state->ownVote = ownVote;
+    
+    std::vector<Vote> heldVotes = votes;
+    {
+        std::lock_guard<std::mutex> lock(requestsMutex);
+        activeRequests[requestId] = std::move(state);
+        auto early = earlyVotes.find(requestId);
+        if (early != earlyVotes.end()) {
+            heldVotes.insert(heldVotes.end(), early->second.begin(), early->second.end());
+            earlyVotes.erase(early);
+        }
+    }
+    for (const Vote& held : heldVotes) {
+        recordVote(held, peerCount);
     }
     
-    // Update consensus tracking
-    state->received++;
-    int voteIndex = vote.isValid ? 1 : 0;
-    state->tally[voteIndex]++;
-    state->confidenceSum[voteIndex] += vote.confidence;
-    
-    std::cout << "[AIJury] Vote received for request " << vote.requestId 
-              << " (" << state->received << "/" << peerCount << ")" << std::endl;
-    
-    // Check if we have enough votes for consensus
-    if (state->received >= peerCount) {
-        int validVotes = state->tally[1];
-        int invalidVotes = state->tally[0];
-        bool majorityValid = validVotes > invalidVotes;
-        double avgConfidence = (state->confidenceSum[0] + state->confidenceSum[1]) / state->received;
+    // Peers whose round closed before this vote reached them count it now
+    if (nplBroadcast && !ownVote.juryId.empty()) {
+        nplBroadcast(ownVote.toJson());
+    }
+}
+
+bool AIJuryModule::snapshotRequest(RequestId requestId, Vote& ownVote, std::vector<Vote>& votes) const {
+    std::lock_guard<std::mutex> lock(requestsMutex);
+    auto it = activeRequests.find(requestId);
+    if (it == activeRequests.end() || it->second->resolved) {
+        return false;
+    }
+    ownVote = it->second->ownVote;
+    votes = it->second->votes;
+    return true;
+}
+
+void AIJuryModule::processVote(const std::string& voteJson, const std::string& sender, int peerCount) {
+    Vote vote = Vote::fromJson(voteJson);
+    vote.sender = sender;   // The authenticated NPL sender, whatever the payload claims
+    recordVote(vote, peerCount);
+}
+
+void AIJuryModule::recordVote(const Vote& vote, int peerCount) {
+    RequestState* state = nullptr;
+    int validVotes = 0;
+    int invalidVotes = 0;
+    int received = 0;
+    double avgConfidence = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(requestsMutex);
         
-        sendConsensusResult(state, majorityValid, avgConfidence, validVotes, invalidVotes, state->received);
+        // Find the corresponding request
+        state = findRequest(vote.requestId);
+        if (!state) {
+            // A vote from an earlier round can only belong to a request that is gone
+            // (requests carried over from earlier rounds are restored before votes are read)
+            if (vote.round != 0 && currentRound != 0 && vote.round < currentRound) {
+                std::cout << "[AIJury] Dropping stale vote for request " << vote.requestId
+                          << " from round " << vote.round << std::endl;
+                return;
+            }
+            
+            // A peer may vote before this node reaches the request - hold the vote
+            std::cout << "[AIJury] Holding vote for request " << vote.requestId << " not yet processed here" << std::endl;
+            earlyVotes[vote.requestId].push_back(vote);
+            return;
+        }
+        if (state->resolved) {
+            std::cout << "[AIJury] Ignoring extra vote for resolved request " << vote.requestId << std::endl;
+            return;
+        }
+        
+        // Votes for carried-over requests are broadcast again - count each node once, by
+        // the NPL key it sent from (the juryId in the payload is the sender's own claim)
+        if (vote.sender.empty()) {
+            std::cout << "[AIJury] Ignoring vote without a known sender for request " << vote.requestId << std::endl;
+            return;
+        }
+        for (const Vote& counted : state->votes) {
+            if (counted.sender == vote.sender) {
+                std::cout << "[AIJury] Ignoring repeated vote from " << vote.sender.substr(0, 16)
+                          << " for request " << vote.requestId << std::endl;
+                return;
+            }
+        }
+        
+        // Update consensus tracking
+        state->votes.push_back(vote);
+        state->received++;
+        int voteIndex = vote.isValid ? 1 : 0;
+        state->tally[voteIndex]++;
+        state->confidenceSum[voteIndex] += vote.confidence;
+        
+        std::cout << "[AIJury] Vote received for request " << vote.requestId 
+                  << " (" << state->received << "/" << peerCount << ")" << std::endl;
+        
+        // Check if we have enough votes for consensus
+        if (state->received < peerCount) {
+            return;
+        }
         state->resolved = true;
+        validVotes = state->tally[1];
+        invalidVotes = state->tally[0];
+        received = state->received;
+        avgConfidence = (state->confidenceSum[0] + state->confidenceSum[1]) / state->received;
     }
+    
+    // Answer outside the lock (the callback writes game state); the request stays
+    // listed until then so waiters do not see consensus before the answer is written
+    bool majorityValid = validVotes > invalidVotes;
+    sendConsensusResult(state, majorityValid, avgConfidence, validVotes, invalidVotes, received);
+    
+    // Drop the resolved request so activeRequests only holds pending ones
+    std::lock_guard<std::mutex> lock(requestsMutex);
+    activeRequests.erase(vote.requestId);
 }
 
-void AIJuryModule::waitForConsensus(int requestId, int peerCount, int timeoutMs) {
+void AIJuryModule::waitForConsensus(RequestId requestId, int peerCount, int timeoutMs) {
     auto startTime = std::chrono::steady_clock::now();
     
     while (true) {
-        RequestState* state = findRequest(requestId);
-        if (!state || state->resolved) {
+        if (isConsensusReached(requestId)) {
             std::cout << "[AIJury] Consensus reached for request " << requestId << std::endl;
             break;
         }
@@ -513,13 +773,10 @@ void AIJuryModule::waitForConsensus(int requestId, int peerCount, int timeoutMs)
     }
 }
 
-bool AIJuryModule::isConsensusReached(int requestId) const {
-    for (const auto& req : activeRequests) {
-        if (req->requestId == requestId) {
-            return req->resolved;
-        }
-    }
-    return false; // Request not found, consider it resolved
+bool AIJuryModule::isConsensusReached(RequestId requestId) const {
+    // Requests are removed once their consensus result has been sent
+    std::lock_guard<std::mutex> lock(requestsMutex);
+    return activeRequests.count(requestId) == 0; // Request not found, consider it resolved
 }
 
 std::string AIJuryModule::getJuryStats() const {
@@ -551,13 +808,9 @@ bool AIJuryModule::isAIModelReady() const {
     return false;
 }
 
-RequestState* AIJuryModule::findRequest(int requestId) {
-    for (auto& req : activeRequests) {
-        if (req->requestId == requestId) {
-            return req.get();
-        }
-    }
-    return nullptr;
+RequestState* AIJuryModule::findRequest(RequestId requestId) {
+    auto it = activeRequests.find(requestId);
+    return it == activeRequests.end() ? nullptr : it->second.get();
 }
 
 void AIJuryModule::sendConsensusResult(RequestState* state, bool majorityValid, 
@@ -577,7 +830,9 @@ void AIJuryModule::sendConsensusResult(RequestState* state, bool majorityValid,
                                             avgConfidence, 
                                             result.dump());
     
-    if (userResponse && state->user) {
+    // Also called without a user: a restored request's user may not be connected this
+    // round, and the contract still has to apply the result
+    if (userResponse) {
         userResponse(state->user, response);
     }
     
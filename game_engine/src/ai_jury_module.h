@@ -6,6 +6,10 @@
 #include <memory>
 #include <unordered_map>
 #include <functional>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 
 // Forward declarations
@@ -13,6 +17,13 @@ struct hp_user;
 
 namespace AIJury {
 
+// Request IDs are derived from the round, the user's public key and the input, so
+// every node assigns the same ID to the same input and IDs never repeat across rounds.
+// Masked to 53 bits so they survive JSON numbers in JavaScript clients; 0 means "none".
+using RequestId = uint64_t;
+constexpr RequestId REQUEST_ID_MASK = (1ULL << 53) - 1;
+RequestId makeRequestId(uint64_t round, const std::string& userKey, const std::string& input, size_t inputIndex);
+
 // Core decision structure
 struct Decision {
     bool isValid;
@@ -23,12 +34,15 @@ struct Decision {
 
 // Vote structure for consensus
 struct Vote {
-    int requestId;
-    bool isValid;
-    double confidence;
+    RequestId requestId = 0;
+    uint64_t round = 0;    // Round the request belongs to (0 from peers that do not send it)
+    bool isValid = false;
+    double confidence = 0.0;
     std::string reason;
     std::string juryId;
     std::string context;   // Context data for validation
+    std::string sender;    // NPL public key the vote arrived from - set by the receiver, never
+                           // taken from a peer's payload; votes are counted once per sender
     
     std::string toJson() const;
     static Vote fromJson(const std::string& json);
@@ -37,14 +51,14 @@ struct Vote {
 // Request state for consensus tracking
 struct RequestState {
     const struct hp_user* user;
-    int requestId;
+    RequestId requestId;
     std::string messageType;
-    std::string messageData;
-    std::string context;
     
     // Consensus state
-    bool resolved = false;
+    bool resolved = false;         // Result decided and being sent; later votes are ignored
     int received = 0;
+    std::vector<Vote> votes;       // Counted votes, one per NPL sender
+    Vote ownVote;                  // This node's vote (juryId empty until decided)
     int tally[2] = {0, 0};         // [invalid_count, valid_count]
     double confidenceSum[2] = {0.0, 0.0};
     
@@ -59,28 +73,66 @@ public:
     virtual Decision makeDecision(const std::string& messageType, 
                                 const std::string& messageData, 
                                 const std::string& context) = 0;
+    // Decision on a statement about a game world that is addressed by content hash.
+    // Engines without a world cache see the world inlined in front of the statement.
+    virtual Decision makeWorldDecision(const std::string& messageType,
+                                       const std::string& /*worldHash*/,
+                                       const std::string& gameWorld,
+                                       const std::string& messageData,
+                                       const std::string& context) {
+        return makeDecision(messageType, "GameWorld: " + gameWorld + " -> " + messageData, context);
+    }
     virtual std::string getEngineInfo() const = 0;
 };
 
 // AI model-based decision engine - Uses direct AI Daemon communication
 class AIModelDecisionEngine : public IDecisionEngine {
 private:
-    bool modelLoaded = false;
+    std::atomic<bool> modelLoaded{false};
+    
+    // Cached readiness: a "not ready" reading is trusted for READINESS_TTL_MS, so
+    // votes during model loading are answered without touching the daemon
+    static constexpr int READINESS_TTL_MS = 2000;
+    std::chrono::steady_clock::time_point readinessCheckedAt{};
+    
+    // Kept-alive connection to the jury daemon, reused across requests
+    struct DaemonConnection {
+        int socket = -1;
+        std::string receiveBuffer;
+    };
+    // Idle kept-alive connections. Concurrent decisions each take one (or open a new
+    // one), so validations of independent games reach the daemon together.
+    std::vector<DaemonConnection> idleConnections;
+    mutable std::mutex stateMutex;   // Guards idleConnections and readinessCheckedAt
     
     // Direct AI daemon communication methods
-    bool pingAIDaemon();
-    std::string sendToAIDaemon(const std::string& request);
+    int connectToAIDaemon();
+    void closeAIDaemonConnection(DaemonConnection& connection);
+    std::string sendToAIDaemon(const std::string& request);      // Retries on "busy" replies
+    std::string sendToAIDaemonOnce(const std::string& request);
+    bool exchangeWithAIDaemon(DaemonConnection& connection, const std::string& request, std::string& response);
+    bool recentlyNotReady() const;
+    void recordReadiness(bool ready);
     bool waitForModelReady(int maxWaitSeconds = 300);  // Wait for model to be ready
+    Decision requestDecision(const std::string& statement,   // World text sent only on a daemon cache miss
+                             const std::string& worldHash,
+                             const std::string& gameWorld);
     
 public:
     AIModelDecisionEngine();
-    bool loadModel();           // Connect to AI daemon
+    ~AIModelDecisionEngine() override;
+    bool loadModel();           // Connect to (or start) AI daemon - non-blocking
     bool isModelReady() const { return modelLoaded; }
     std::string getDaemonStats() const;  // Get daemon status via ping
     
     Decision makeDecision(const std::string& messageType, 
                         const std::string& messageData, 
                         const std::string& context) override;
+    Decision makeWorldDecision(const std::string& messageType,
+                             const std::string& worldHash,
+                             const std::string& gameWorld,
+                             const std::string& messageData,
+                             const std::string& context) override;
     std::string getEngineInfo() const override;
 };
 
@@ -88,7 +140,10 @@ public:
 class AIJuryModule {
 private:
     std::unique_ptr<IDecisionEngine> decisionEngine;
-    std::vector<std::unique_ptr<RequestState>> activeRequests;
+    std::unordered_map<RequestId, std::unique_ptr<RequestState>> activeRequests;
+    mutable std::mutex requestsMutex;   // Requests are added and voted on from concurrent game workers
+    std::unordered_map<RequestId, std::vector<Vote>> earlyVotes;   // Peer votes for requests not yet registered here
+    uint64_t currentRound = 0;          // Votes from earlier rounds are stale and dropped
     std::string juryId;
     
     // NPL messaging functions (set by contract)
@@ -100,6 +155,18 @@ public:
     
     // Configuration
     void setJuryId(const std::string& id) { juryId = id; }
+    void setRound(uint64_t round) {
+        std::lock_guard<std::mutex> lock(requestsMutex);
+        currentRound = round;
+    }
+    // Start of a round in a process that outlives it (contract worker): requests and
+    // early votes of the previous round go, as they would with the process
+    void beginRound(uint64_t round) {
+        std::lock_guard<std::mutex> lock(requestsMutex);
+        currentRound = round;
+        activeRequests.clear();
+        earlyVotes.clear();
+    }
     void setNPLBroadcast(std::function<void(const std::string&)> func) { nplBroadcast = func; }
     void setUserResponse(std::function<void(const hp_user*, const std::string&)> func) { userResponse = func; }
     
@@ -107,18 +174,34 @@ public:
     void processRequest(const hp_user* user, 
                        const std::string& messageType, 
                        const std::string& messageData, 
-                       int requestId, 
+                       RequestId requestId, 
                        int peerCount,
-                       const std::string& context = "");
+                       const std::string& context = "",
+                       const std::string& gameWorld = "",   // With worldHash: the world the statement is about
+                       const std::string& worldHash = "");
+    
+    // Cross-round pipelining: a request left open at the end of an earlier round is
+    // registered again with the votes counted so far, and this node's vote is broadcast
+    // again for peers that missed it. snapshotRequest reads an open request back out.
+    void restoreRequest(const hp_user* user,          // nullptr when the user is not connected
+                        RequestId requestId,
+                        const std::string& messageType,
+                        const Vote& ownVote,
+                        const std::vector<Vote>& votes,
+                        int peerCount);
+    bool snapshotRequest(RequestId requestId, Vote& ownVote, std::vector<Vote>& votes) const;
     
-    void processVote(const std::string& voteJson, int peerCount);
-    void waitForConsensus(int requestId, int peerCount, int timeoutMs = 5000);
-    bool isConsensusReached(int requestId) const;
+    void processVote(const std::string& voteJson, const std::string& sender, int peerCount);
+    void waitForConsensus(RequestId requestId, int peerCount, int timeoutMs = 5000);
+    bool isConsensusReached(RequestId requestId) const;
     
     // Status and utilities
     std::string getJuryStats() const;
     std::string getJuryId() const { return juryId; }
-    size_t getActiveRequestCount() const { return activeRequests.size(); }
+    size_t getActiveRequestCount() const {
+        std::lock_guard<std::mutex> lock(requestsMutex);
+        return activeRequests.size();
+    }
     
     // Model management (for AI-based engines)
     bool loadAIModel();
@@ -126,7 +209,8 @@ public:
     bool isAIModelReady() const;
     
 private:
-    RequestState* findRequest(int requestId);
+    RequestState* findRequest(RequestId requestId);   // Caller holds requestsMutex
+    void recordVote(const Vote& vote, int peerCount);
     void sendConsensusResult(RequestState* state, bool majorityValid, 
                            double avgConfidence, int validVotes, int invalidVotes, int totalVotes);
     std::string escapeJson(const std::string& str) const;
@@ -135,6 +219,9 @@ private:
 // Factory functions
 std::unique_ptr<AIJuryModule> createAIModelJury(const std::string& juryId = "");
 
+// Start the jury daemon process if it is not already running (does not wait for its model)
+bool startJuryDaemon();
+
 // Utility functions
 std::string generateJuryId();
 std::string formatJuryResponse(const std::string& type, const std::string& decision, 
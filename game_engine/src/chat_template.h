@@ -0,0 +1,140 @@
+#ifndef CHAT_TEMPLATE_H
+#define CHAT_TEMPLATE_H
+
+// Chat framing for the AI daemon prompts, taken from the model's own chat template
+// (GGUF tokenizer.chat_template through llama_chat_apply_template) instead of
+// hand-written headers. A conversation with placeholder messages is rendered once per
+// model at load time and cut at the placeholders, so the framing is pre-tokenized like
+// every other prompt fragment. Harmony models (gpt-oss) get a reasoning-effort line in
+// the system turn and their answer is prefilled into the final channel, so no analysis
+// text is generated and thrown away.
+
+#include <utility>
+#include <string>
+#include <vector>
+#include "../llama.cpp/include/llama.h"
+
+struct ChatFrame {
+    std::string prefix;              // Conversation start up to the first user message
+    std::string suffix;              // End of a user message up to the answer
+    std::string nextTurn;            // End of an answer up to the next user message
+    std::vector<std::string> stops;  // Texts that end an answer
+    bool harmony = false;
+    bool templated = false;          // False when the model template could not be applied
+
+    // Frame for one system prompt (may be empty) on the given model
+    static ChatFrame render(const llama_model* model, const std::string& systemPrompt,
+                            const std::string& reasoningEffort = "low") {
+        ChatFrame frame;
+        const char* tmpl = llama_model_chat_template(model, nullptr);
+        std::string tmplText = tmpl ? tmpl : "";
+        frame.harmony = tmplText.find("<|channel|>") != std::string::npos;
+
+        std::vector<std::pair<std::string, std::string>> system;
+        if (frame.harmony) {
+            system.emplace_back("system", "Reasoning: " + reasoningEffort +
+                                "\n\n# Valid channels: analysis, final. Channel must be included for every message.");
+            if (!systemPrompt.empty()) {
+                system.emplace_back("developer", "# Instructions\n\n" + systemPrompt);
+            }
+        } else if (!systemPrompt.empty()) {
+            system.emplace_back("system", systemPrompt);
+        }
+
+        // [system..., user] and [system..., user, assistant, user], both opening the answer
+        auto first = system;
+        first.emplace_back("user", USER_A);
+        auto second = first;
+        second.emplace_back("assistant", ANSWER);
+        second.emplace_back("user", USER_B);
+
+        std::string one, two;
+        size_t userA = std::string::npos, answer = std::string::npos, userB = std::string::npos;
+        if (apply(tmpl, first, one) && apply(tmpl, second, two)) {
+            userA = one.find(USER_A);
+            answer = two.find(ANSWER);
+            userB = two.find(USER_B);
+        }
+        if (userA == std::string::npos || answer == std::string::npos || userB == std::string::npos || userB < answer) {
+            // No usable template: plain text framing
+            frame.prefix = systemPrompt.empty() ? "" : systemPrompt + "\n\n";
+            frame.suffix = "\n\n";
+            frame.nextTurn = "\n\n";
+            return frame;
+        }
+
+        frame.templated = true;
+        frame.prefix = one.substr(0, userA);
+        frame.suffix = one.substr(userA + std::string(USER_A).size());
+        frame.nextTurn = two.substr(answer + std::string(ANSWER).size(), userB - answer - std::string(ANSWER).size());
+
+        if (frame.harmony) {
+            // Answers go straight to the final channel and end a turn with <|end|>
+            frame.suffix += "<|channel|>final<|message|>";
+            if (frame.nextTurn.compare(0, 10, "<|return|>") == 0) {
+                frame.nextTurn.replace(0, 10, "<|end|>");
+            }
+            frame.stops = {"<|return|>", "<|end|>", "<|start|>", "<|channel|>"};
+        } else {
+            // The text closing an answer in history is the end-of-turn marker
+            auto answered = first;
+            answered.emplace_back("assistant", ANSWER);
+            std::string three;
+            if (apply(tmpl, answered, three, false) && three.find(ANSWER) != std::string::npos) {
+                std::string close = three.substr(three.find(ANSWER) + std::string(ANSWER).size());
+                close.erase(close.find_last_not_of(" \n") + 1);
+                if (!close.empty()) {
+                    frame.stops.push_back(close);
+                }
+            }
+        }
+        return frame;
+    }
+
+    // Cut an answer down to its final text: drop reasoning the model produced anyway
+    // (a harmony analysis channel or a <think> block) and anything after a stop text
+    std::string finalText(const std::string& text) const {
+        std::string result = text;
+        size_t final = result.rfind("<|channel|>final<|message|>");
+        if (final != std::string::npos) {
+            result.erase(0, final + 27);
+        }
+        size_t thinkEnd = result.find("</think>");
+        if (thinkEnd != std::string::npos) {
+            result.erase(0, thinkEnd + 8);
+        }
+        for (const std::string& stop : stops) {
+            size_t at = result.find(stop);
+            if (at != std::string::npos) {
+                result.erase(at);
+            }
+        }
+        return result;
+    }
+
+private:
+    static constexpr const char* USER_A = "\x1f" "user_a" "\x1f";
+    static constexpr const char* USER_B = "\x1f" "user_b" "\x1f";
+    static constexpr const char* ANSWER = "\x1f" "answer" "\x1f";
+
+    static bool apply(const char* tmpl, const std::vector<std::pair<std::string, std::string>>& messages, std::string& out,
+                      bool openAnswer = true) {
+        std::vector<llama_chat_message> chat;
+        for (const auto& message : messages) {
+            chat.push_back({message.first.c_str(), message.second.c_str()});
+        }
+        std::vector<char> buf(4096);
+        int32_t n = llama_chat_apply_template(tmpl, chat.data(), chat.size(), openAnswer, buf.data(), buf.size());
+        if (n > static_cast<int32_t>(buf.size())) {
+            buf.resize(n);
+            n = llama_chat_apply_template(tmpl, chat.data(), chat.size(), openAnswer, buf.data(), buf.size());
+        }
+        if (n < 0) {
+            return false;
+        }
+        out.assign(buf.data(), n);
+        return true;
+    }
+};
+
+#endif // CHAT_TEMPLATE_H
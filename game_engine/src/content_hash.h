@@ -0,0 +1,49 @@
+#ifndef CONTENT_HASH_H
+#define CONTENT_HASH_H
+
+// Content hashing for cache keys shared between the contract and the AI daemons.
+// FNV-1a 64-bit: dependency-free (the game daemon does not link OpenSSL), stable
+// across processes and builds, and fast enough to hash multi-KB worlds per request.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace ContentHash {
+
+inline uint64_t fnv1a64(const char* data, size_t length, uint64_t seed = 14695981039346656037ULL) {
+    uint64_t hash = seed;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1a64(const std::string& text) {
+    return fnv1a64(text.data(), text.size());
+}
+
+// An integer as 8 little-endian bytes, so the hash is the same on every node
+inline uint64_t fnv1a64Le(uint64_t value, uint64_t seed = 14695981039346656037ULL) {
+    char bytes[8];
+    for (int i = 0; i < 8; i++) {
+        bytes[i] = static_cast<char>(value >> (8 * i));
+    }
+    return fnv1a64(bytes, sizeof(bytes), seed);
+}
+
+// Fixed-width lowercase hex form used on the wire and in file names
+inline std::string toHex(uint64_t hash) {
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+    return std::string(buf, 16);
+}
+
+inline std::string hashHex(const std::string& text) {
+    return toHex(fnv1a64(text));
+}
+
+} // namespace ContentHash
+
+#endif // CONTENT_HASH_H
@@ -0,0 +1,208 @@
+#ifndef CONTRACT_WORKER_H
+#define CONTRACT_WORKER_H
+
+// Hand-off of a contract round from the per-round process Hot Pocket starts to a
+// long-lived worker process (CONTRACT_WORKER_MODE). The per-round process only reads the
+// round's args and passes them, its working directory and the round's channel fds (user
+// input, user outputs, NPL, control) over a Unix seqpacket socket with SCM_RIGHTS; the
+// worker runs the round and answers with the exit status the round process exits with.
+// One round per connection:
+//   shim -> worker: {"cwd":..., "binary":..., "fd_count":N, "args_bytes":M}
+//                   fd batches: the fd numbers in the shim as payload, the fds as SCM_RIGHTS
+//                   the args in chunks of up to kChunk bytes
+//   worker -> shim: {"accepted":true|false} - false when the worker runs another build of
+//                   the contract binary than the shim (it exits; the shim starts a new one)
+//   worker -> shim: {"status":<exit status>}
+// Received fds are close-on-exec, so daemons the worker starts never hold a round open.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <nlohmann/json.hpp>
+
+class ContractWorker {
+public:
+    static constexpr size_t kFdBatch = 200;   // Below the kernel's SCM_MAX_FD (253)
+    static constexpr size_t kChunk = 65536;
+
+    struct Round {
+        std::string cwd;
+        std::string binary;      // binaryIdentity() of the shim
+        std::string args;
+        std::vector<int> from;   // Channel fd numbers in the shim
+        std::vector<int> fds;    // The same channels in this process
+    };
+
+    // The executable this process runs (device, inode, size, modification time). A worker
+    // keeps its own from startup even after the file is replaced on disk.
+    static std::string binaryIdentity() {
+        struct stat st{};
+        if (stat("/proc/self/exe", &st) != 0) return "";
+        return std::to_string(st.st_dev) + ":" + std::to_string(st.st_ino) + ":" + std::to_string(st.st_size) + ":" +
+               std::to_string(st.st_mtim.tv_sec) + "." + std::to_string(st.st_mtim.tv_nsec);
+    }
+
+    static int listenOn(const std::string& path) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) return -1;
+        int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (sock < 0) return -1;
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(path.c_str());
+        if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(sock, 16) != 0) {
+            close(sock);
+            return -1;
+        }
+        return sock;
+    }
+
+    static int connectTo(const std::string& path) {
+        sockaddr_un addr{};
+        if (path.size() >= sizeof(addr.sun_path)) return -1;
+        int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (sock < 0) return -1;
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        if (connect(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(sock);
+            return -1;
+        }
+        return sock;
+    }
+
+    static bool sendRound(int sock, const std::string& cwd, const std::string& args, const std::vector<int>& fds) {
+        nlohmann::json header = {{"cwd", cwd}, {"binary", binaryIdentity()}, {"fd_count", fds.size()}, {"args_bytes", args.size()}};
+        if (!sendMessage(sock, header.dump())) return false;
+        for (size_t i = 0; i < fds.size(); i += kFdBatch) {
+            size_t count = std::min(kFdBatch, fds.size() - i);
+            std::string numbers(reinterpret_cast<const char*>(fds.data() + i), count * sizeof(int));
+            if (!sendMessage(sock, numbers, fds.data() + i, count)) return false;
+        }
+        for (size_t i = 0; i < args.size(); i += kChunk) {
+            if (!sendMessage(sock, args.substr(i, kChunk))) return false;
+        }
+        return true;
+    }
+
+    // False on a malformed or cut-off hand-off; fds received so far are closed
+    static bool receiveRound(int sock, Round& round) {
+        std::string message;
+        if (!receiveMessage(sock, message, nullptr)) return false;
+        nlohmann::json header = nlohmann::json::parse(message, nullptr, false);
+        if (!header.is_object()) return false;
+        round.cwd = header.value("cwd", "");
+        round.binary = header.value("binary", "");
+        size_t fdCount = header.value("fd_count", static_cast<size_t>(0));
+        size_t argsBytes = header.value("args_bytes", static_cast<size_t>(0));
+
+        bool ok = true;
+        while (ok && round.fds.size() < fdCount) {
+            std::vector<int> received;
+            ok = receiveMessage(sock, message, &received);
+            std::vector<int> numbers(message.size() / sizeof(int));
+            std::memcpy(numbers.data(), message.data(), numbers.size() * sizeof(int));
+            round.fds.insert(round.fds.end(), received.begin(), received.end());
+            round.from.insert(round.from.end(), numbers.begin(), numbers.end());
+            ok = ok && !received.empty() && numbers.size() == received.size();
+        }
+        while (ok && round.args.size() < argsBytes) {
+            ok = receiveMessage(sock, message, nullptr) && !message.empty();
+            round.args += message;
+        }
+        if (!ok || round.fds.size() != fdCount || round.args.size() != argsBytes) {
+            for (int fd : round.fds) close(fd);
+            round.fds.clear();
+            return false;
+        }
+        return true;
+    }
+
+    static bool sendAccepted(int sock, bool accepted) {
+        return sendMessage(sock, nlohmann::json{{"accepted", accepted}}.dump());
+    }
+
+    // False when the worker refused the round or went away before answering
+    static bool receiveAccepted(int sock) {
+        std::string message;
+        if (!receiveMessage(sock, message, nullptr)) return false;
+        nlohmann::json reply = nlohmann::json::parse(message, nullptr, false);
+        return reply.is_object() && reply.value("accepted", false);
+    }
+
+    static bool sendStatus(int sock, int status) {
+        return sendMessage(sock, nlohmann::json{{"status", status}}.dump());
+    }
+
+    // Blocks until the worker has finished the round; false when it went away first
+    static bool receiveStatus(int sock, int& status) {
+        std::string message;
+        if (!receiveMessage(sock, message, nullptr)) return false;
+        nlohmann::json reply = nlohmann::json::parse(message, nullptr, false);
+        if (!reply.is_object() || !reply.contains("status")) return false;
+        status = reply.value("status", 1);
+        return true;
+    }
+
+private:
+    static bool sendMessage(int sock, const std::string& data, const int* fds = nullptr, size_t fdCount = 0) {
+        iovec iov{const_cast<char*>(data.data()), data.size()};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        std::vector<char> control;
+        if (fdCount > 0) {
+            control.resize(CMSG_SPACE(fdCount * sizeof(int)));
+            msg.msg_control = control.data();
+            msg.msg_controllen = control.size();
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(fdCount * sizeof(int));
+            std::memcpy(CMSG_DATA(cmsg), fds, fdCount * sizeof(int));
+        }
+        ssize_t sent;
+        do {
+            sent = sendmsg(sock, &msg, MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+        return sent == static_cast<ssize_t>(data.size());
+    }
+
+    static bool receiveMessage(int sock, std::string& data, std::vector<int>* fds) {
+        data.resize(kChunk);
+        iovec iov{&data[0], data.size()};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        std::vector<char> control(CMSG_SPACE(kFdBatch * sizeof(int)));
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        ssize_t received;
+        do {
+            received = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+        } while (received < 0 && errno == EINTR);
+        if (received <= 0) return false;
+        data.resize(received);
+
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+            size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+            std::vector<int> passed(count);
+            std::memcpy(passed.data(), CMSG_DATA(cmsg), count * sizeof(int));
+            for (int fd : passed) {
+                if (fds) fds->push_back(fd);
+                else close(fd);
+            }
+        }
+        // A truncated message (too long, or fds beyond the control buffer) is a broken hand-off
+        return (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) == 0;
+    }
+};
+
+#endif // CONTRACT_WORKER_H
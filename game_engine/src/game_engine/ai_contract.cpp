@@ -14,10 +14,17 @@
 #include <sstream>
 #include <memory>
 #include <unordered_map>
+#include <unordered_set>
 #include <set>
 #include <thread>
 #include <chrono>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <csignal>
 #include <fcntl.h>
+#include <poll.h>
 #include <unistd.h>
 #include <sys/wait.h>
 #include "../httplib/httplib.h"
@@ -26,8 +33,16 @@
 #include "ai_service_client.h"
 #include "ai_jury_module.h"
 #include "nft_minting_client.h"
+#include "content_hash.h"
+#include "world_blob_cache.h"
+#include "action_resolver.h"
+#include "world_index.h"
+#include "contract_worker.h"
+#include "narrative_tickets.h"
 #include <nlohmann/json.hpp>
 
+std::string escapeJsonForOutput(const std::string &str);
+
 // AI Model Downloader using cpp-httplib (kept for initial model setup)
 class ModelDownloader
 {
@@ -296,6 +311,15 @@ public:
     {
         modelFilePath = path;
     }
+
+    // Re-read the downloaded size from disk without downloading anything
+    double refreshProgress()
+    {
+        std::error_code ec;
+        uintmax_t size = std::filesystem::file_size(std::filesystem::path("../../../model") / fileName, ec);
+        fileSize = ec ? 0 : static_cast<size_t>(size);
+        return getProgress();
+    }
 };
 
 // Game State Manager (unchanged - handles file persistence)
@@ -431,7 +455,9 @@ public:
         if (file)
         {
             file << gameWorld;
+            file.close();
             std::cout << "Game world saved: " << filePath << std::endl;
+            writeGamesIndex();
             return true;
         }
         return false;
@@ -444,12 +470,80 @@ public:
         if (file)
         {
             file << gameState;
+            file.close();
             std::cout << "Game state saved: " << filePath << std::endl;
+            writeFileAtomically(gameDataDir + "/snapshot_" + gameId + ".json", buildGameStateResponse(gameId, gameState));
             return true;
         }
         return false;
     }
 
+    // Pre-serialized read responses, kept next to the game files so read-only rounds
+    // answer list_games / get_game_state with a single file read. They are written
+    // only from consensus rounds and derived from consensus state, so every node
+    // holds identical copies.
+    static std::string buildGameStateResponse(const std::string &gameId, const std::string &gameState)
+    {
+        return "{\"type\":\"gameState\",\"game_id\":\"" + escapeJsonForOutput(gameId) +
+               "\",\"state\":\"" + escapeJsonForOutput(gameState) + "\"}";
+    }
+
+    static std::string buildGamesListResponse(std::vector<std::string> games)
+    {
+        std::sort(games.begin(), games.end());
+        std::string gamesList = "[";
+        for (size_t i = 0; i < games.size(); ++i)
+        {
+            gamesList += "\"" + games[i] + "\"";
+            if (i < games.size() - 1)
+                gamesList += ",";
+        }
+        gamesList += "]";
+        return "{\"type\":\"gamesList\",\"games\":" + gamesList + "}";
+    }
+
+    void writeGamesIndex()
+    {
+        writeFileAtomically(gameDataDir + "/games_index.json", buildGamesListResponse(listGames()));
+    }
+
+    // Create the index and snapshots for games saved before they existed
+    void ensureSnapshots()
+    {
+        if (std::filesystem::exists(gameDataDir + "/games_index.json"))
+            return;
+
+        std::vector<std::string> games = listGames();
+        for (const auto &gameId : games)
+        {
+            std::string gameState = loadGameState(gameId);
+            if (!gameState.empty())
+            {
+                writeFileAtomically(gameDataDir + "/snapshot_" + gameId + ".json", buildGameStateResponse(gameId, gameState));
+            }
+        }
+        writeFileAtomically(gameDataDir + "/games_index.json", buildGamesListResponse(games));
+        std::cout << "Game snapshots created for " << games.size() << " games" << std::endl;
+    }
+
+    // Serialized get_game_state response, or empty if the game does not exist
+    std::string loadGameStateSnapshot(const std::string &gameId)
+    {
+        std::string snapshot = readFile(gameDataDir + "/snapshot_" + gameId + ".json");
+        if (!snapshot.empty())
+            return snapshot;
+
+        std::string gameState = loadGameState(gameId);
+        return gameState.empty() ? "" : buildGameStateResponse(gameId, gameState);
+    }
+
+    // Serialized list_games response
+    std::string loadGamesListSnapshot()
+    {
+        std::string snapshot = readFile(gameDataDir + "/games_index.json");
+        return snapshot.empty() ? buildGamesListResponse(listGames()) : snapshot;
+    }
+
     std::string loadGameWorld(const std::string &gameId)
     {
         std::string filePath = gameDataDir + "/game_world_" + gameId + ".txt";
@@ -503,6 +597,33 @@ public:
         }
         return games;
     }
+
+private:
+    static std::string readFile(const std::string &filePath)
+    {
+        std::ifstream file(filePath);
+        if (!file)
+            return "";
+        return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    }
+
+    static void writeFileAtomically(const std::string &filePath, const std::string &content)
+    {
+        std::string tmpPath = filePath + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::trunc);
+            file << content;
+            if (!file)
+            {
+                std::cerr << "Error writing snapshot: " << filePath << std::endl;
+                return;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, filePath, ec);
+        if (ec)
+            std::cerr << "Error writing snapshot: " << filePath << " - " << ec.message() << std::endl;
+    }
 };
 
 // Game Engine Daemon Process Manager (renamed to avoid conflict with AI Jury module)
@@ -512,6 +633,7 @@ private:
     pid_t gameEngineDaemonPid = -1;
     std::string gameEngineDaemonPath = "../../../AIDaemon"; // Persistent directory for daemon binary
     std::string gameEngineModelPath = "../../../model/gpt-oss-20b-Q5_K_M.gguf";
+    std::string gameEngineSmallModelPath = "../../../model/Llama-3.2-1B-Instruct-Q4_K_M.gguf"; // Optional fast tier
     std::string gameEnginePidFile = "../../../ai_daemon.pid";
 
     bool isDaemonProcessRunning(pid_t pid)
@@ -620,6 +742,145 @@ private:
         std::cout << "[Contract] Daemon cleanup complete" << std::endl;
     }
 
+    // Model and daemon binary as they are on disk now (size and modification time, so a
+    // replaced file is noticed without hashing gigabytes every round)
+    std::string gameEngineDaemonIdentity()
+    {
+        std::string identity;
+        for (const std::string &path : {gameEngineModelPath, gameEngineSmallModelPath, gameEngineDaemonPath})
+        {
+            std::error_code sizeEc, timeEc;
+            auto size = std::filesystem::file_size(path, sizeEc);
+            auto modified = std::filesystem::last_write_time(path, timeEc);
+            identity += path + ":" + (sizeEc || timeEc ? "-" : std::to_string(size) + ":" + std::to_string(modified.time_since_epoch().count())) + ";";
+        }
+        return identity;
+    }
+
+    // Fork and exec the daemon; returns the child's PID (-1 when fork failed)
+    pid_t forkGameEngineDaemon(int port, bool standby)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            // Child process - exec the daemon
+            std::cout << "[Daemon Child] Executing daemon: " << gameEngineDaemonPath << " " << gameEngineModelPath << std::endl;
+            std::cout.flush();
+
+            std::vector<std::string> args = {"AIDaemon", gameEngineModelPath};
+            // Enable the small model tier only when its model file has been deployed
+            if (std::filesystem::exists(gameEngineSmallModelPath))
+                args.push_back("--small-model=" + gameEngineSmallModelPath);
+            if (port != DaemonEndpoint::DEFAULT_PORT)
+                args.push_back("--port=" + std::to_string(port));
+            if (standby)
+                args.push_back("--standby");
+            std::vector<char *> argv;
+            for (std::string &arg : args)
+                argv.push_back(arg.data());
+            argv.push_back(nullptr);
+            execv(gameEngineDaemonPath.c_str(), argv.data());
+            std::cerr << "[Daemon Child] FATAL: Failed to exec daemon: " << strerror(errno) << std::endl;
+            exit(1);
+        }
+        return pid;
+    }
+
+    void discardStandby(const DaemonEndpoint &standby)
+    {
+        if (isDaemonProcessRunning(standby.pid))
+            kill(standby.pid, SIGTERM);
+        std::remove(DaemonEndpoint::STANDBY_FILE);
+    }
+
+    // Switch contract traffic to a standby: it takes over the PID and status files, the
+    // endpoint file is replaced in one rename, and the daemon it replaces is retired
+    bool promoteStandby(const DaemonEndpoint &standby, const DaemonEndpoint *replaced)
+    {
+        AIServiceClient client;
+        if (!client.activateDaemon(standby.port))
+        {
+            std::cerr << "[Contract] Standby daemon on port " << standby.port << " did not accept activation" << std::endl;
+            return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(DaemonEndpoint::STANDBY_FILE, DaemonEndpoint::ACTIVE_FILE, ec);
+        if (ec)
+        {
+            std::cerr << "[Contract] Failed to switch daemon endpoint: " << ec.message() << std::endl;
+            return false;
+        }
+        gameEngineDaemonPid = standby.pid;
+        writeGameEnginePidFile(standby.pid);
+        std::cout << "[Contract] ✓ Traffic switched to daemon " << standby.pid << " on port " << standby.port << std::endl;
+
+        if (replaced && isDaemonProcessRunning(replaced->pid) && !client.retireDaemon(replaced->port, standby.port))
+        {
+            // Not answering - it no longer owns the PID file, so a plain stop is safe
+            std::cout << "[Contract] Old daemon " << replaced->pid << " did not answer retire - stopping it" << std::endl;
+            kill(replaced->pid, SIGTERM);
+        }
+        return true;
+    }
+
+    // Hot model swap for a running daemon: when the model or the daemon binary changed
+    // since it started, load a standby next to it on the other port and switch to it in
+    // the first round that finds it ready. Player actions are served by the old daemon
+    // until then.
+    void maintainStandby(pid_t activePid)
+    {
+        std::string identity = gameEngineDaemonIdentity();
+        DaemonEndpoint active;
+        if (!DaemonEndpoint::load(DaemonEndpoint::ACTIVE_FILE, active))
+        {
+            // Started before endpoints were recorded - taken as running the current build
+            active.pid = activePid;
+            active.identity = identity;
+            active.save(DaemonEndpoint::ACTIVE_FILE);
+        }
+
+        DaemonEndpoint standby;
+        bool haveStandby = DaemonEndpoint::load(DaemonEndpoint::STANDBY_FILE, standby);
+        if (haveStandby && (active.identity == identity || standby.identity != identity || !isDaemonProcessRunning(standby.pid)))
+        {
+            std::cout << "[Contract] Discarding standby daemon " << standby.pid << " (superseded or gone)" << std::endl;
+            discardStandby(standby);
+            haveStandby = false;
+        }
+        if (active.identity == identity)
+            return;
+
+        if (!haveStandby)
+        {
+            standby.port = DaemonEndpoint::otherPort(active.port);
+            standby.identity = identity;
+            standby.pid = forkGameEngineDaemon(standby.port, true);
+            if (standby.pid > 0)
+            {
+                standby.save(DaemonEndpoint::STANDBY_FILE);
+                std::cout << "[Contract] Model or daemon binary changed - standby daemon " << standby.pid
+                          << " loading on port " << standby.port << " while " << active.pid << " keeps serving" << std::endl;
+            }
+            return;
+        }
+
+        AIServiceClient client;
+        std::string status = client.daemonStatusOn(standby.port);
+        if (status == "ready")
+        {
+            promoteStandby(standby, &active);
+        }
+        else if (status == "error")
+        {
+            std::cerr << "[Contract] Standby daemon failed to load its model - discarded, retrying next round" << std::endl;
+            discardStandby(standby);
+        }
+        else
+        {
+            std::cout << "[Contract] Standby daemon " << standby.pid << " still loading - old daemon keeps serving" << std::endl;
+        }
+    }
+
 public:
     bool startDaemon()
     {
@@ -670,6 +931,7 @@ public:
                 std::cout << "[Contract] Process " << existingPid << " is running - using existing daemon" << std::endl;
                 std::cout << "[Contract] Note: Daemon may be loading model, which can take 10+ minutes" << std::endl;
                 gameEngineDaemonPid = existingPid;
+                maintainStandby(existingPid);
                 return true; // Just use the existing daemon, don't test responsiveness
             }
         }
@@ -685,6 +947,17 @@ public:
 
         std::cout << "[Contract] No daemon found - starting new daemon..." << std::endl;
 
+        // A standby of the current build that outlived the daemon it was loading for
+        // takes over directly instead of a second cold start
+        DaemonEndpoint standby;
+        if (DaemonEndpoint::load(DaemonEndpoint::STANDBY_FILE, standby))
+        {
+            if (standby.identity == gameEngineDaemonIdentity() && isDaemonProcessRunning(standby.pid) &&
+                promoteStandby(standby, nullptr))
+                return true;
+            discardStandby(standby);
+        }
+
         // Ensure daemon binary exists in persistent directory
         if (!ensureGameEngineDaemonBinaryExists())
         {
@@ -696,21 +969,15 @@ public:
         std::cout.flush();
 
         // Fork and exec the daemon
-        gameEngineDaemonPid = fork();
-        if (gameEngineDaemonPid == 0)
-        {
-            // Child process - exec the daemon
-            std::cout << "[Daemon Child] Executing daemon: " << gameEngineDaemonPath << " " << gameEngineModelPath << std::endl;
-            std::cout.flush();
-
-            execl(gameEngineDaemonPath.c_str(), "AIDaemon", gameEngineModelPath.c_str(), (char *)nullptr);
-            std::cerr << "[Daemon Child] FATAL: Failed to exec daemon: " << strerror(errno) << std::endl;
-            exit(1);
-        }
-        else if (gameEngineDaemonPid > 0)
+        gameEngineDaemonPid = forkGameEngineDaemon(DaemonEndpoint::DEFAULT_PORT, false);
+        if (gameEngineDaemonPid > 0)
         {
-            // Parent process - write PID file immediately
+            // Parent process - write PID and endpoint files immediately
             writeGameEnginePidFile(gameEngineDaemonPid);
+            DaemonEndpoint endpoint;
+            endpoint.pid = gameEngineDaemonPid;
+            endpoint.identity = gameEngineDaemonIdentity();
+            endpoint.save(DaemonEndpoint::ACTIVE_FILE);
             std::cout << "[Contract] Daemon started with PID: " << gameEngineDaemonPid << " (saved to " << gameEnginePidFile << ")" << std::endl;
 
             // Give daemon a moment to start (non-blocking)
@@ -778,19 +1045,368 @@ public:
     }
 };
 
+// Immutable game text (worlds, states) shared by reference between the request
+// objects of a round. Identical texts are held once; an entry lives only while
+// some request still references it.
+class BlobCache
+{
+public:
+    using Blob = std::shared_ptr<const std::string>;
+
+    static Blob empty()
+    {
+        static const Blob emptyBlob = std::make_shared<const std::string>();
+        return emptyBlob;
+    }
+
+    Blob intern(std::string text)
+    {
+        if (text.empty())
+            return empty();
+
+        uint64_t hash = ContentHash::fnv1a64(text);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = blobs.find(hash);
+        if (it != blobs.end())
+        {
+            Blob existing = it->second.lock();
+            if (existing && *existing == text)
+                return existing;
+        }
+
+        if (blobs.size() >= 64)
+            pruneExpired();
+        Blob blob = std::make_shared<const std::string>(std::move(text));
+        blobs[hash] = blob;
+        return blob;
+    }
+
+private:
+    std::mutex mutex; // Game workers intern concurrently
+    std::unordered_map<uint64_t, std::weak_ptr<const std::string>> blobs;
+
+    void pruneExpired()
+    {
+        for (auto it = blobs.begin(); it != blobs.end();)
+            it = it->second.expired() ? blobs.erase(it) : std::next(it);
+    }
+};
+
 // Game Action State for AI Jury validation - Legacy voting fields removed
 struct GameActionState
 {
-    const struct hp_user *user;
+    const struct hp_user *user = nullptr;
     std::string gameId;
     std::string action;
     std::string playerAction; // Store the player action for validation
-    std::string oldGameState; // Store old state for validation
-    std::string newGameState; // Store new state for validation
-    std::string gameWorld;    // Store game world for validation
+    BlobCache::Blob oldGameState = BlobCache::empty(); // Store old state for validation
+    BlobCache::Blob newGameState = BlobCache::empty(); // Store new state for validation
+    BlobCache::Blob gameWorld = BlobCache::empty();    // Store game world for validation
+    std::string worldHash;                             // Content hash the daemons address gameWorld by
     bool continue_conversation = false; // Store conversation continuity flag
 
-    int action_idx; // Action index for consensus tracking
+    AIJury::RequestId action_idx = 0; // Jury request ID for consensus tracking (0 = none)
+};
+
+// Request-scoped game action states of the current round. A state is recycled as
+// soon as its consensus completes, so memory is bounded by the requests in flight
+// rather than the number of inputs in the round; reset() drops everything at round end.
+class RoundArena
+{
+public:
+    GameActionState *acquire()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            if (!inUse[i])
+            {
+                inUse[i] = true;
+                return slots[i].get();
+            }
+        }
+        slots.push_back(std::make_unique<GameActionState>());
+        inUse.push_back(true);
+        return slots.back().get();
+    }
+
+    GameActionState *find(AIJury::RequestId action_idx)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            if (inUse[i] && slots[i]->action_idx == action_idx)
+                return slots[i].get();
+        }
+        return nullptr;
+    }
+
+    // Clear the state (dropping its blob references) and make the slot reusable
+    void release(GameActionState *state)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < slots.size(); i++)
+        {
+            if (slots[i].get() == state)
+            {
+                *state = GameActionState{};
+                inUse[i] = false;
+                return;
+            }
+        }
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        slots.clear();
+        inUse.clear();
+    }
+
+private:
+    std::mutex mutex; // Game workers acquire and release concurrently
+    std::vector<std::unique_ptr<GameActionState>> slots;
+    std::vector<bool> inUse;
+};
+
+// Player actions whose jury consensus was not finished in the round that made them
+// (CONSENSUS_PIPELINE_MODE). Each is one JSON record in a node-local directory outside
+// the contract state - the votes a node has seen are its own, not consensus state.
+// A record is written when its round ends without consensus, rewritten with the votes
+// counted so far in every following round, and removed once its answer reached the user.
+class PendingTransitionStore
+{
+public:
+    struct Record
+    {
+        AIJury::RequestId requestId = 0;
+        uint64_t round = 0;
+        std::string userKey;
+        std::string gameId;
+        std::string playerAction;
+        std::string oldState;
+        std::string newState;
+        AIJury::Vote ownVote;
+        std::vector<AIJury::Vote> votes;
+        std::string response; // Consensus answer held until the user is connected again
+    };
+
+    explicit PendingTransitionStore(std::string directory) : dir(std::move(directory)) {}
+
+    // Records of earlier rounds, oldest request first
+    std::vector<Record> load()
+    {
+        std::vector<Record> records;
+        std::error_code ec;
+        if (!std::filesystem::is_directory(dir, ec))
+            return records;
+        for (const auto &entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            if (entry.path().extension() != ".json")
+                continue;
+            try
+            {
+                std::ifstream file(entry.path());
+                nlohmann::json j = nlohmann::json::parse(file);
+                Record record;
+                record.requestId = j.value("requestId", static_cast<AIJury::RequestId>(0));
+                record.round = j.value("round", static_cast<uint64_t>(0));
+                record.userKey = j.value("userKey", "");
+                record.gameId = j.value("gameId", "");
+                record.playerAction = j.value("playerAction", "");
+                record.oldState = j.value("oldState", "");
+                record.newState = j.value("newState", "");
+                record.ownVote = AIJury::Vote::fromJson(j.value("ownVote", nlohmann::json::object()).dump());
+                for (const auto &vote : j.value("votes", nlohmann::json::array()))
+                    record.votes.push_back(AIJury::Vote::fromJson(vote.dump()));
+                record.response = j.value("response", "");
+                if (record.requestId != 0)
+                    records.push_back(std::move(record));
+            }
+            catch (const std::exception &e)
+            {
+                std::cerr << "[Pipeline] Skipping unreadable record " << entry.path() << ": " << e.what() << std::endl;
+            }
+        }
+        std::sort(records.begin(), records.end(), [](const Record &a, const Record &b)
+                  { return a.round != b.round ? a.round < b.round : a.requestId < b.requestId; });
+        return records;
+    }
+
+    bool save(const Record &record)
+    {
+        nlohmann::json j;
+        j["requestId"] = record.requestId;
+        j["round"] = record.round;
+        j["userKey"] = record.userKey;
+        j["gameId"] = record.gameId;
+        j["playerAction"] = record.playerAction;
+        j["oldState"] = record.oldState;
+        j["newState"] = record.newState;
+        j["ownVote"] = nlohmann::json::parse(record.ownVote.toJson());
+        j["votes"] = nlohmann::json::array();
+        for (const auto &vote : record.votes)
+            j["votes"].push_back(nlohmann::json::parse(vote.toJson()));
+        j["response"] = record.response;
+
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        std::string path = pathOf(record.requestId);
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::trunc);
+            if (!file)
+                return false;
+            file << j.dump();
+        }
+        std::filesystem::rename(tmpPath, path, ec);
+        return !ec;
+    }
+
+    void remove(AIJury::RequestId requestId)
+    {
+        std::error_code ec;
+        std::filesystem::remove(pathOf(requestId), ec);
+    }
+
+    // Transitions carried across rounds: their consensus answer is always held and sent in
+    // the transition's delivery round, never in whichever round the votes happened to complete
+    void markDeferred(AIJury::RequestId requestId)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        deferred.insert(requestId);
+    }
+
+    bool isDeferred(AIJury::RequestId requestId)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return deferred.count(requestId) > 0;
+    }
+
+    // Consensus answers held for their delivery round
+    void holdResponse(AIJury::RequestId requestId, const std::string &response)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        heldResponses[requestId] = response;
+    }
+
+    bool takeHeldResponse(AIJury::RequestId requestId, std::string &response)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = heldResponses.find(requestId);
+        if (it == heldResponses.end())
+            return false;
+        response = std::move(it->second);
+        heldResponses.erase(it);
+        return true;
+    }
+
+    void clearHeldResponses()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        heldResponses.clear();
+        deferred.clear();
+    }
+
+private:
+    std::string dir;
+    std::mutex mutex; // Guards heldResponses and deferred (consensus may complete on any game worker)
+    std::unordered_map<AIJury::RequestId, std::string> heldResponses;
+    std::unordered_set<AIJury::RequestId> deferred;
+
+    std::string pathOf(AIJury::RequestId requestId) const
+    {
+        return dir + "/" + std::to_string(requestId) + ".json";
+    }
+};
+
+// Narratives of two-phase player turns (TWO_PHASE_TURNS) still to be sent to their users.
+// The daemon answers a turn with the structured state and generates the narrative in the
+// background; accepted turns are recorded here and the narrative is sent as a follow-up
+// message by the first round that finds it ready and the user connected. Node-local, one
+// JSON file outside the contract state, like the pending transitions.
+class PendingNarrativeStore
+{
+public:
+    struct Record
+    {
+        uint64_t round = 0;
+        std::string userKey;
+        std::string gameId;
+        std::string playerAction;
+        std::string oldState; // State before the turn - with game and action it addresses the narrative
+    };
+
+    explicit PendingNarrativeStore(std::string filePath) : path(std::move(filePath)) {}
+
+    // Turn of the current round whose narrative is to follow
+    void add(Record record)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        added.push_back(std::move(record));
+    }
+
+    // Records of earlier rounds followed by this round's
+    std::vector<Record> take()
+    {
+        std::vector<Record> records;
+        std::ifstream file(path);
+        if (file)
+        {
+            nlohmann::json j = nlohmann::json::parse(file, nullptr, false);
+            if (j.is_array())
+            {
+                for (const auto &entry : j)
+                {
+                    Record record;
+                    record.round = entry.value("round", static_cast<uint64_t>(0));
+                    record.userKey = entry.value("userKey", "");
+                    record.gameId = entry.value("gameId", "");
+                    record.playerAction = entry.value("playerAction", "");
+                    record.oldState = entry.value("oldState", "");
+                    records.push_back(std::move(record));
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        records.insert(records.end(), added.begin(), added.end());
+        added.clear();
+        return records;
+    }
+
+    bool save(const std::vector<Record> &records)
+    {
+        std::error_code ec;
+        if (records.empty())
+        {
+            std::filesystem::remove(path, ec);
+            return true;
+        }
+
+        nlohmann::json j = nlohmann::json::array();
+        for (const auto &record : records)
+        {
+            j.push_back({{"round", record.round},
+                         {"userKey", record.userKey},
+                         {"gameId", record.gameId},
+                         {"playerAction", record.playerAction},
+                         {"oldState", record.oldState}});
+        }
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::trunc);
+            if (!file)
+                return false;
+            file << j.dump();
+        }
+        std::filesystem::rename(tmpPath, path, ec);
+        return !ec;
+    }
+
+private:
+    std::string path;
+    std::mutex mutex; // Game workers add concurrently
+    std::vector<Record> added;
 };
 
 // Valuable Item Extraction for NFT Generation
@@ -889,17 +1505,274 @@ static std::unique_ptr<AIServiceClient> g_aiClient;
 static std::unique_ptr<GameStateManager> g_gameManager;
 static std::unique_ptr<ModelDownloader> g_modelDownloader;
 static std::unique_ptr<GameEngineDaemonManager> g_gameEngineDaemonManager;
-static std::vector<std::unique_ptr<GameActionState>> g_gameActionHandlers;
+static RoundArena g_roundArena;  // Game action states awaiting jury consensus
+static BlobCache g_blobCache;    // World/state text shared by those states
 static std::unique_ptr<AIJury::AIJuryModule> g_aiJury;
 static std::unique_ptr<ValuableItemExtractor> g_valuableItemExtractor;
 static std::unique_ptr<NFTMintingClient> g_nftMintingClient;
 
-// Conversation continuity state tracking
-static std::unordered_map<std::string, bool> g_gameConversationActive; // gameId -> conversation active flag
-static std::unordered_map<std::string, int> g_gameActionCount; // gameId -> action count for this conversation
+// Game worlds keyed by game ID. A world never changes after creation, so it is read
+// and hashed once per process and shared by every action on that game. The daemons
+// are sent the hash; the text goes over the wire only when they report a cache miss.
+class WorldCache
+{
+public:
+    struct Entry
+    {
+        BlobCache::Blob text = BlobCache::empty();
+        std::string hash;                         // Empty when the world does not exist
+        std::shared_ptr<const WorldModel> model;  // Parsed map; null when the world has none
+        std::shared_ptr<const WorldIndex> index;  // Sections for per-turn slices
+    };
 
-// COMMENTED OUT NFT CONSENSUS COORDINATION - IMPLEMENTING READ-ONLY MODE ONLY
-// NFT Coordination System (completely separate from AI Jury)
+    const Entry &get(const std::string &gameId)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = worlds.find(gameId);
+        if (it != worlds.end())
+            return it->second;
+
+        Entry entry;
+        entry.text = g_blobCache.intern(g_gameManager->loadGameWorld(gameId));
+        if (entry.text->empty())
+            return missing; // Not cached - the game may still be created
+        entry.hash = WorldBlobCache::hashOf(*entry.text);
+        auto model = std::make_shared<WorldModel>();
+        if (WorldModel::parse(*entry.text, *model))
+            entry.model = std::move(model);
+        entry.index = std::make_shared<WorldIndex>(WorldIndex::build(*entry.text));
+        return worlds.emplace(gameId, std::move(entry)).first->second;
+    }
+
+private:
+    std::mutex mutex; // Entries are never erased, so returned references stay valid
+    std::unordered_map<std::string, Entry> worlds;
+    const Entry missing;
+};
+static WorldCache g_worldCache;
+
+// Worlds generated up front for this round's create_game inputs (prompt -> AI response)
+static std::unordered_map<std::string, std::string> g_batchedGameCreations;
+
+// Responses to one user input. Inputs of a round run on concurrent game workers, so
+// handlers write into the slot of the input they serve and the slots are flushed to
+// the users in input order once all inputs are done - a user's responses keep their order.
+struct OutputSlot
+{
+    const struct hp_user *user = nullptr;
+    std::vector<std::string> messages;
+};
+static thread_local OutputSlot *t_outputSlot = nullptr;       // Slot of the input this thread serves
+static std::mutex g_outputMutex;                              // Guards slot contents and g_requestSlots
+static std::unordered_map<AIJury::RequestId, OutputSlot *> g_requestSlots; // Jury request ID -> slot of the input that made it
+
+// Point this thread's writes at another input's slot for the lifetime of the scope
+// (a consensus completed by one worker's NPL read answers another worker's input)
+class OutputSlotScope
+{
+public:
+    OutputSlotScope() : previous(t_outputSlot) {}
+    explicit OutputSlotScope(OutputSlot *slot) : previous(t_outputSlot) { enter(slot); }
+    ~OutputSlotScope() { t_outputSlot = previous; }
+
+    void enter(OutputSlot *slot)
+    {
+        if (slot)
+            t_outputSlot = slot;
+    }
+
+private:
+    OutputSlot *previous;
+};
+
+// Per-round scheduler for user inputs. Inputs are partitioned by the game they touch -
+// one partition per game ID, plus one shared partition for inputs that name no game
+// (stat, query, create_game, list_games, mint_nft). Partitions run concurrently on a
+// bounded worker pool; the inputs of a partition run one after another in input order.
+class RoundScheduler
+{
+public:
+    void add(const std::string &partition, std::function<void()> task)
+    {
+        auto it = partitionIndex.find(partition);
+        if (it == partitionIndex.end())
+        {
+            it = partitionIndex.emplace(partition, partitions.size()).first;
+            partitions.emplace_back();
+        }
+        partitions[it->second].push_back(std::move(task));
+    }
+
+    void run(size_t maxWorkers)
+    {
+        size_t workerCount = std::min(std::max<size_t>(maxWorkers, 1), partitions.size());
+        std::atomic<size_t> next{0};
+        auto worker = [this, &next]()
+        {
+            for (size_t p = next++; p < partitions.size(); p = next++)
+            {
+                for (auto &task : partitions[p])
+                    task();
+            }
+        };
+
+        std::cout << "[Scheduler] " << partitions.size() << " partition(s) on " << workerCount << " worker(s)" << std::endl;
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < workerCount; i++)
+            workers.emplace_back(worker);
+        worker(); // The main thread is a worker too
+        for (auto &t : workers)
+            t.join();
+    }
+
+private:
+    std::unordered_map<std::string, size_t> partitionIndex;
+    std::vector<std::vector<std::function<void()>>> partitions; // In order of first appearance
+};
+
+// Worker pool size for a round (ROUND_WORKERS, default 4; 1 processes inputs serially)
+static size_t roundWorkerCount()
+{
+    const char *configured = std::getenv("ROUND_WORKERS");
+    int workers = configured ? std::atoi(configured) : 4;
+    return workers > 0 ? static_cast<size_t>(workers) : 1;
+}
+
+static uint64_t g_round = 0;       // Round being executed (lcl_seq_no + 1); part of every jury request ID
+static std::mutex g_lazyInitMutex; // Serializes ensureAIJury / ensureNFTMintingClient across workers
+static std::mutex g_nplReadMutex;  // Only one worker drains NPL at a time; the others wait on its results
+
+// Cross-round consensus pipelining (CONSENSUS_PIPELINE_MODE=1). A player action's round
+// ends after generation and this node's vote: the user is told consensus is pending and
+// the transition is carried to the next rounds, which broadcast the vote again, count
+// late votes and send the consensus answer as a follow-up message. Rounds are then
+// bounded by local work instead of the slowest peer's inference. The follow-up goes out
+// PENDING_ANSWER_ROUNDS after the turn (or the first later round its user is connected),
+// the same round on every node whatever the local vote timing.
+static constexpr uint64_t PENDING_MAX_ROUNDS = 20;   // Rounds a transition may wait for consensus before it is dropped
+static constexpr uint64_t PENDING_ANSWER_ROUNDS = 2; // Rounds after the turn before its consensus answer is sent
+static constexpr int PENDING_COLLECT_MS = 500;      // End-of-round wait for votes of open transitions
+static PendingTransitionStore g_pendingTransitions("../../../pending_transitions");
+static std::vector<PendingTransitionStore::Record> g_openTransitions; // Deferred or restored this round
+static std::mutex g_openTransitionsMutex;                           // Guards g_openTransitions
+
+static bool consensusPipelineMode()
+{
+    const char *mode = std::getenv("CONSENSUS_PIPELINE_MODE");
+    return mode && (std::string(mode) == "1" || std::string(mode) == "true");
+}
+
+// Two-phase turns (TWO_PHASE_TURNS=1): generated player actions ask the daemon for the
+// structured state only, so jury validation and the state commit start after a short
+// generation; the narrative is produced in the background and follows NARRATIVE_DELIVERY_ROUNDS
+// after the turn (or the first later round its user is connected), so every node sends it
+// in the same round - the text of one node, relayed to the others over NPL.
+static constexpr uint64_t NARRATIVE_MAX_ROUNDS = 20;     // Rounds a narrative may wait for its user before it is dropped
+static constexpr uint64_t NARRATIVE_DELIVERY_ROUNDS = 2; // Rounds after the turn before its narrative is sent
+static constexpr int NARRATIVE_WAIT_MS = 5000;           // Per round, for narratives still generating when due
+static constexpr int NARRATIVE_RELAY_MS = 2000;          // Beyond that, for the narrator's relay to arrive
+static PendingNarrativeStore g_pendingNarratives("../../../pending_narratives.json");
+
+static bool twoPhaseTurnMode()
+{
+    const char *mode = std::getenv("TWO_PHASE_TURNS");
+    return mode && (std::string(mode) == "1" || std::string(mode) == "true");
+}
+
+// Leader-generates, followers-verify (LEADER_GENERATION_MODE=1). One node per game -
+// picked by hashing the game ID over the sorted UNL keys, which spreads generation over
+// the UNL instead of every node generating every turn - generates each player action's
+// new state and broadcasts it over NPL as {"type":"leader_state"}. The other nodes adopt
+// that exact state when it continues from their own old state and go straight to jury
+// validation. Followers wait at most LEADER_WAIT_MS from the start of the round for all
+// of its leader states together; after that every follower generates locally at once.
+static constexpr int LEADER_WAIT_MS = 45000;
+static std::chrono::steady_clock::time_point g_leaderWaitDeadline; // Set at round start
+
+static bool leaderGenerationMode()
+{
+    const char *mode = std::getenv("LEADER_GENERATION_MODE");
+    return mode && (std::string(mode) == "1" || std::string(mode) == "true");
+}
+
+// Semantic action cache (ACTION_CACHE_MODE=1): every node may answer a player action from
+// its own cache of near-identical earlier actions. Nodes then submit different states, so
+// it is off by default; in leader mode the turn leader uses it regardless.
+static bool actionCacheMode()
+{
+    const char *mode = std::getenv("ACTION_CACHE_MODE");
+    return mode && (std::string(mode) == "1" || std::string(mode) == "true");
+}
+
+// World pool (WORLD_POOL_MODE=1): create_game may be answered from the daemon's pool of
+// pre-generated worlds. Each node fills its own pool, so nodes commit different worlds -
+// only for deployments where that is acceptable (a single node). Off by default.
+static bool worldPoolMode()
+{
+    const char *mode = std::getenv("WORLD_POOL_MODE");
+    return mode && (std::string(mode) == "1" || std::string(mode) == "true");
+}
+
+// New states broadcast by turn leaders this round, by jury request ID (the same on every node)
+class LeaderStateBoard
+{
+public:
+    void post(AIJury::RequestId requestId, const std::string &sender, const std::string &oldStateHash, const std::string &newState)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        states[requestId] = {sender, oldStateHash, newState};
+    }
+
+    // The state the expected leader generated from this old state
+    bool take(AIJury::RequestId requestId, const std::string &leader, const std::string &oldStateHash, std::string &newState)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = states.find(requestId);
+        if (it == states.end() || it->second.sender != leader || it->second.oldStateHash != oldStateHash)
+            return false;
+        newState = std::move(it->second.newState);
+        states.erase(it);
+        return true;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        states.clear();
+    }
+
+private:
+    struct Posted
+    {
+        std::string sender;
+        std::string oldStateHash;
+        std::string newState;
+    };
+    std::mutex mutex; // Posted by the NPL reader, taken by game workers
+    std::unordered_map<AIJury::RequestId, Posted> states;
+};
+static LeaderStateBoard g_leaderStates;
+static LeaderStateBoard g_relayedNarratives; // Narratives relayed by narrators this round, by narrative ticket
+
+// Persistent contract worker (CONTRACT_WORKER_MODE=1). The process Hot Pocket starts each
+// round becomes a shim: it reads the round's args and hands them with the round's fds to
+// a long-lived worker over a Unix socket (see ContractWorker), which keeps its clients,
+// world cache and daemon connections from round to round. Rounds are served one at a
+// time and all per-round state is reset at the start of each, so outputs are the same as
+// with a fresh process. Read-only instances always run in their own process.
+static const char *CONTRACT_WORKER_SOCKET = "../../../contract_worker.sock";
+static const char *CONTRACT_WORKER_LOG = "../../../contract_worker.log";
+static constexpr int CONTRACT_WORKER_START_MS = 2000; // Wait for a newly started worker to listen
+static std::string g_contractArgs;                    // Args of this round, as read from Hot Pocket
+
+static bool contractWorkerMode()
+{
+    const char *mode = std::getenv("CONTRACT_WORKER_MODE");
+    return mode && (std::string(mode) == "1" || std::string(mode) == "true");
+}
+
+// COMMENTED OUT NFT CONSENSUS COORDINATION - IMPLEMENTING READ-ONLY MODE ONLY
+// NFT Coordination System (completely separate from AI Jury)
 // static std::unordered_map<std::string, bool> g_nftCoordinationInProgress; // gameId -> NFT coordination in progress
 // static std::unordered_map<std::string, nlohmann::json> g_nftCoordinationResults; // gameId -> NFT coordination results  
 // static std::unordered_map<std::string, std::chrono::steady_clock::time_point> g_nftCoordinationStartTime; // gameId -> start time
@@ -910,17 +1783,42 @@ static std::unordered_map<std::string, int> g_gameActionCount; // gameId -> acti
 // Helper function declarations
 std::string escapeJsonForOutput(const std::string &str);
 std::string cleanJsonResponse(const std::string &response);
+bool extractCreateGamePrompt(const std::string &message, std::string &prompt);
+
+// Subsystems created on first use, so rounds that never need them never pay for them
+AIJury::AIJuryModule *ensureAIJury();
+NFTMintingClient *ensureNFTMintingClient();
+void pregenerateGameCreations(const struct hp_contract_context *ctx);
+
+// Per-input output slots and round scheduling
+int writeUserMessage(const struct hp_user *user, const std::string &message);
+void bindRequestSlot(AIJury::RequestId requestId);
+OutputSlot *requestSlot(AIJury::RequestId requestId);
+std::string inputPartition(const std::string &message);
+void process_user_input(const struct hp_user *user, size_t input_idx, const std::string &message, int peer_count, bool readonly);
 
 // Message processing functions for AI-validated game actions
 void process_stat_message(const struct hp_user *user);
-void process_game_message(const struct hp_user *user, const std::string &action, const std::string &data, int action_idx, int peer_count);
+void process_readonly_stat_message(const struct hp_user *user);
+bool classifyReadRequest(const std::string &message, std::string &kind, std::string &gameId);
+bool serveReadOnlyRound(const struct hp_contract_context *ctx);
+void process_game_message(const struct hp_user *user, const std::string &action, const std::string &data, AIJury::RequestId action_idx, int peer_count);
 void waitForGameConsensus(int action_idx, int peer_count);
 
 // AI Jury integration functions
 void juryNPLBroadcast(const std::string &msg);
 void juryUserResponse(const hp_user *user, const std::string &response);
-void process_jury_vote(const std::string &voteJson, int peer_count);
-void waitForJuryConsensus(int request_idx, int peer_count);
+void process_jury_vote(const std::string &voteJson, const std::string &sender, int peer_count);
+void waitForJuryConsensus(AIJury::RequestId request_idx, int peer_count);
+void deferJuryConsensus(const struct hp_user *user, const GameActionState &state);
+void restorePendingTransitions(const struct hp_contract_context *ctx, int peer_count);
+void checkpointPendingTransitions(int peer_count);
+void deliverPendingNarratives(const struct hp_contract_context *ctx, int peer_count);
+std::string selectTurnLeader(const std::string &gameId);
+bool awaitLeaderState(AIJury::RequestId requestId, const std::string &leader, const std::string &oldState, int peer_count,
+                      std::string &newState);
+void broadcastLeaderState(AIJury::RequestId requestId, const std::string &oldState, const std::string &newState);
+void dispatchNplMessage(const struct hp_npl_msg *msg, void *user_data);
 
 // COMMENTED OUT NFT CONSENSUS COORDINATION FUNCTIONS - IMPLEMENTING READ-ONLY MODE ONLY
 // NFT Coordination System functions (completely separate from AI Jury)
@@ -1071,6 +1969,179 @@ std::string cleanJsonResponse(const std::string &response)
     return cleaned;
 }
 
+AIJury::AIJuryModule *ensureAIJury()
+{
+    std::lock_guard<std::mutex> lock(g_lazyInitMutex);
+    if (!g_aiJury)
+    {
+        // Named after the node key, so a vote broadcast again in a later round is
+        // recognised as the same juror's
+        const struct hp_contract_context *ctx = hp_get_context();
+        std::string juryId = ctx ? "jury_" + std::string(ctx->public_key.data).substr(2, 16) : "";
+        g_aiJury = AIJury::createAIModelJury(juryId);
+        g_aiJury->setNPLBroadcast(juryNPLBroadcast);
+        g_aiJury->setUserResponse(juryUserResponse);
+        g_aiJury->setRound(g_round);
+        std::cout << "AI Jury ID: " << g_aiJury->getJuryId() << std::endl;
+
+        // Non-blocking: connects to (or starts) the jury daemon and takes one readiness reading
+        g_aiJury->loadAIModel();
+    }
+    return g_aiJury.get();
+}
+
+NFTMintingClient *ensureNFTMintingClient()
+{
+    std::lock_guard<std::mutex> lock(g_lazyInitMutex);
+    if (!g_nftMintingClient)
+    {
+        // Configure NFT minting client with wallet seed from environment
+        const char *walletSeed = std::getenv("MINTER_WALLET_SEED");
+        if (!walletSeed)
+        {
+            std::cerr << "ERROR: MINTER_WALLET_SEED environment variable not set!" << std::endl;
+            std::cerr << "Please set: export MINTER_WALLET_SEED=<your_wallet_seed>" << std::endl;
+            return nullptr;
+        }
+
+        g_nftMintingClient = std::make_unique<NFTMintingClient>();
+        g_nftMintingClient->setMinterWallet(walletSeed);
+        std::cout << "NFT Minting Client initialized with environment configuration" << std::endl;
+    }
+    return g_nftMintingClient.get();
+}
+
+// Write a response to a user: into the slot of the input being served when there is
+// one (flushed in input order at the end of the round), directly otherwise
+int writeUserMessage(const struct hp_user *user, const std::string &message)
+{
+    OutputSlot *slot = t_outputSlot;
+    if (slot && slot->user == user)
+    {
+        std::lock_guard<std::mutex> lock(g_outputMutex);
+        slot->messages.push_back(message);
+        return static_cast<int>(message.length());
+    }
+    return hp_write_user_msg(user, message.c_str(), message.length());
+}
+
+// Remember which input a jury request belongs to, so its consensus answer lands in
+// that input's slot whichever worker completes the consensus
+void bindRequestSlot(AIJury::RequestId requestId)
+{
+    if (!t_outputSlot)
+        return;
+    std::lock_guard<std::mutex> lock(g_outputMutex);
+    g_requestSlots[requestId] = t_outputSlot;
+}
+
+OutputSlot *requestSlot(AIJury::RequestId requestId)
+{
+    std::lock_guard<std::mutex> lock(g_outputMutex);
+    auto it = g_requestSlots.find(requestId);
+    return it == g_requestSlots.end() ? nullptr : it->second;
+}
+
+// Extract the prompt from {"create_game":"prompt"}
+bool extractCreateGamePrompt(const std::string &message, std::string &prompt)
+{
+    size_t actionPos = message.find("\"create_game\":");
+    if (actionPos == std::string::npos)
+    {
+        return false;
+    }
+
+    size_t valueStart = message.find(":", actionPos) + 1;
+    while (valueStart < message.length() &&
+           (message[valueStart] == ' ' || message[valueStart] == '\t' || message[valueStart] == '\n'))
+    {
+        valueStart++;
+    }
+    if (valueStart < message.length() && message[valueStart] == '"')
+    {
+        size_t dataStart = valueStart + 1;
+        size_t dataEnd = message.find("\"", dataStart);
+        if (dataEnd != std::string::npos)
+        {
+            prompt = message.substr(dataStart, dataEnd - dataStart);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Collect every create_game prompt in this round's inputs and have the daemon generate
+// them together (parallel sequences sharing the creation template). Results are picked
+// up by process_game_message; anything not covered falls back to a single createGame call.
+void pregenerateGameCreations(const struct hp_contract_context *ctx)
+{
+    g_batchedGameCreations.clear();
+    if (!g_aiClient)
+    {
+        return;
+    }
+
+    std::vector<std::string> prompts;
+    for (size_t u = 0; u < ctx->users.count; u++)
+    {
+        const struct hp_user *user = &ctx->users.list[u];
+        for (size_t input_idx = 0; input_idx < user->inputs.count; input_idx++)
+        {
+            const char *buf = (const char *)hp_init_user_input_mmap() + user->inputs.list[input_idx].offset;
+            std::string message(buf, user->inputs.list[input_idx].size);
+            if (message.empty() ||
+                message.find("\"type\":\"stat\"") != std::string::npos ||
+                message.find("\"type\":\"query\"") != std::string::npos)
+            {
+                continue;
+            }
+
+            // Same detection order as the main input loop: JSON form, then "create_game:prompt"
+            std::string prompt;
+            bool found = false;
+            if (message.front() == '{' && message.back() == '}')
+            {
+                found = message.find("\"create_game\"") != std::string::npos && extractCreateGamePrompt(message, prompt);
+            }
+            else if (message.compare(0, 12, "create_game:") == 0)
+            {
+                prompt = message.substr(12);
+                found = true;
+            }
+
+            if (found && std::find(prompts.begin(), prompts.end(), prompt) == prompts.end())
+            {
+                prompts.push_back(prompt);
+            }
+        }
+    }
+
+    // A single creation gains nothing from batching
+    if (prompts.size() < 2 || !g_aiClient->isModelReady())
+    {
+        return;
+    }
+
+    const size_t maxBatch = AIServiceClient::MAX_CREATE_BATCH;
+    for (size_t start = 0; start < prompts.size(); start += maxBatch)
+    {
+        std::vector<std::string> chunk(prompts.begin() + start,
+                                       prompts.begin() + std::min(prompts.size(), start + maxBatch));
+        if (chunk.size() < 2)
+        {
+            break;
+        }
+
+        std::cout << "=== BATCHED CREATE_GAME: " << chunk.size() << " prompts ===" << std::endl;
+        std::vector<std::string> results = g_aiClient->createGames(chunk, worldPoolMode());
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            if (!results[i].empty())
+                g_batchedGameCreations[chunk[i]] = results[i];
+        }
+    }
+}
+
 void process_stat_message(const struct hp_user *user)
 {
     std::string response = "{\"type\":\"stats\"";
@@ -1103,111 +2174,353 @@ void process_stat_message(const struct hp_user *user)
     }
 
     response += "}";
-    hp_write_user_msg(user, response.c_str(), response.length());
+    writeUserMessage(user, response);
 }
 
-void process_game_message(const struct hp_user *user, const std::string &action, const std::string &data, int action_idx, int peer_count)
+// Stat for read-only rounds: daemon liveness from its PID file and details from the
+// status snapshot the daemon writes, instead of socket probes
+void process_readonly_stat_message(const struct hp_user *user)
 {
-    std::cout << "=== PROCESS_GAME_MESSAGE (Daemon-Based) ===" << std::endl;
-    std::cout << "Action: " << action << std::endl;
-    std::cout << "Data: " << data << std::endl;
-    std::cout << "Action Index: " << action_idx << std::endl;
-    std::cout << "Peer Count: " << peer_count << std::endl;
+    std::string response = "{\"type\":\"stats\"";
 
-    if (!g_aiClient || !g_gameManager)
+    if (g_modelDownloader)
     {
-        std::string error = "{\"type\":\"error\",\"error\":\"Game systems not initialized\"}";
-        std::cout << "ERROR: Game systems not initialized!" << std::endl;
-        hp_write_user_msg(user, error.c_str(), error.length());
-        return;
+        response += ",\"model_progress\":" + std::to_string(g_modelDownloader->refreshProgress());
     }
 
-    // Check daemon connectivity
-    if (!g_aiClient->isDaemonRunning())
+    bool daemon_running = false;
+    pid_t daemon_pid = -1;
+    std::ifstream pidFile("../../../ai_daemon.pid");
+    if (pidFile >> daemon_pid)
     {
-        std::string error = "{\"type\":\"error\",\"error\":\"AI Daemon not running\"}";
-        std::cout << "ERROR: AI Daemon not running!" << std::endl;
-        hp_write_user_msg(user, error.c_str(), error.length());
-        return;
+        daemon_running = daemon_pid > 0 && kill(daemon_pid, 0) == 0;
     }
 
-    // Check if model is ready (for actions that require AI)
-    bool model_ready = g_aiClient->isModelReady();
-    if (!model_ready && (action == "create_game" || action == "player_action"))
+    std::string detailed_status;
+    if (daemon_running)
     {
-        std::string error = "{\"type\":\"error\",\"error\":\"AI model still loading, please try again in a few minutes\"}";
-        std::cout << "INFO: AI model still loading, skipping " << action << std::endl;
-        hp_write_user_msg(user, error.c_str(), error.length());
-        return;
+        std::ifstream statusFile("../../../ai_daemon.status");
+        detailed_status.assign((std::istreambuf_iterator<char>(statusFile)), std::istreambuf_iterator<char>());
     }
+    bool model_ready = detailed_status.find("\"model_loaded\":true") != std::string::npos;
 
-    // Only player_action requires voting consensus - all other actions are immediate
-    if (action != "player_action")
+    response += ",\"daemon_status\":\"" + std::string(daemon_running ? "running" : "stopped") + "\"";
+    response += ",\"model_ready\":" + std::string(model_ready ? "true" : "false");
+    if (!detailed_status.empty())
     {
-        std::cout << "Action '" << action << "' does not require voting - processing immediately..." << std::endl;
+        response += ",\"daemon_details\":" + detailed_status;
     }
 
-    // Create game action state
-    auto state = std::make_unique<GameActionState>();
-    state->user = user;
-    state->action = action;
+    if (g_gameManager)
+    {
+        try
+        {
+            nlohmann::json gamesList = nlohmann::json::parse(g_gameManager->loadGamesListSnapshot());
+            response += ",\"total_games\":" + std::to_string(gamesList["games"].size());
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "Error reading games index: " << e.what() << std::endl;
+        }
+    }
 
-    std::string playerActionText;
-    bool continue_conversation = false;
-    std::string oldGameState;
-    std::string newGameState;
-    std::string gameWorld;
+    response += "}";
+    hp_write_user_msg(user, response.c_str(), response.length());
+}
 
-    if (action == "create_game")
+// Quoted value following "key": in a JSON-looking message
+static bool extractQuotedValue(const std::string &message, const std::string &key, std::string &value)
+{
+    size_t keyPos = message.find("\"" + key + "\":");
+    if (keyPos == std::string::npos)
+        return false;
+
+    size_t valueStart = message.find(":", keyPos) + 1;
+    while (valueStart < message.length() &&
+           (message[valueStart] == ' ' || message[valueStart] == '\t' || message[valueStart] == '\n'))
     {
-        // Create new game from user prompt - NO VOTING NEEDED
-        std::cout << "=== CREATE_GAME (No Voting - Daemon-Based) ===" << std::endl;
-        std::string aiResponse = g_aiClient->createGame(data);
+        valueStart++;
+    }
+    if (valueStart >= message.length() || message[valueStart] != '"')
+        return false;
 
-        std::cout << "AI Response Length: " << aiResponse.length() << std::endl;
-        std::cout << "AI Response (first 200 chars): " << aiResponse.substr(0, 200) << std::endl;
-        std::cout << "AI Response (last 200 chars): " << aiResponse.substr(std::max(0, (int)aiResponse.length() - 200)) << std::endl;
+    size_t dataEnd = message.find("\"", valueStart + 1);
+    if (dataEnd == std::string::npos)
+        return false;
+    value = message.substr(valueStart + 1, dataEnd - valueStart - 1);
+    return true;
+}
 
-        // Simple error checking - only check for empty response
-        if (!aiResponse.empty())
-        {
-            // Generate deterministic game ID using user prompt for hash
-            std::string gameId = g_gameManager->generateGameId(data, "");
-            std::cout << "Generated Game ID: " << gameId << std::endl;
+// Scheduler partition of an input: the game ID for inputs that read or change one game
+// (player_action, get_game_state), "" for everything else. Mirrors the detection order
+// of process_user_input.
+std::string inputPartition(const std::string &message)
+{
+    std::string gameId;
+    if (message.find("\"type\":\"stat\"") != std::string::npos || message.find("\"type\":\"query\"") != std::string::npos)
+        return "";
 
-            // Separate game world from game state
-            auto [gameWorldContent, gameStateContent] = g_gameManager->separateGameContent(aiResponse);
+    if (!message.empty() && message.front() == '{' && message.back() == '}')
+    {
+        if (message.find("\"create_game\"") != std::string::npos)
+            return "";
+        if (message.find("\"game_id\"") != std::string::npos && message.find("\"action\"") != std::string::npos)
+            return extractQuotedValue(message, "game_id", gameId) ? "game:" + gameId : "";
+        if (message.find("\"list_games\"") != std::string::npos)
+            return "";
+        if (message.find("\"get_game_state\"") != std::string::npos)
+            return extractQuotedValue(message, "get_game_state", gameId) ? "game:" + gameId : "";
+        return "";
+    }
 
-            // Save game files directly (no validation needed for creation)
-            if (g_gameManager->saveGameWorld(gameId, gameWorldContent) &&
-                g_gameManager->saveGameState(gameId, gameStateContent))
-            {
+    // Colon format: "player_action:<game id>:<action>"
+    size_t colonPos = message.find(':');
+    if (colonPos != std::string::npos && message.compare(0, colonPos, "player_action") == 0)
+    {
+        size_t idEnd = message.find(':', colonPos + 1);
+        if (idEnd != std::string::npos)
+            return "game:" + message.substr(colonPos + 1, idEnd - colonPos - 1);
+    }
+    return "";
+}
 
-                std::cout << "Game created and saved successfully!" << std::endl;
+// Classify an input the same way the main input loop does, accepting only the
+// requests the read path can answer: stat, list_games and get_game_state
+bool classifyReadRequest(const std::string &message, std::string &kind, std::string &gameId)
+{
+    if (message.empty())
+        return false;
 
-                // Send immediate response - no consensus needed
-                std::string result = "{\"type\":\"gameCreated\",\"game_id\":\"" + escapeJsonForOutput(gameId) + "\",\"status\":\"success\"}";
-                std::cout << "Sending response: " << result << std::endl;
-                int bytes_written = hp_write_user_msg(user, result.c_str(), result.length());
-                std::cout << "hp_write_user_msg returned: " << bytes_written << " bytes" << std::endl;
-                std::cout << "Response sent to client immediately!" << std::endl;
-                return; // Exit early - no voting needed
-            }
-            else
-            {
-                std::cout << "ERROR: Failed to save game files!" << std::endl;
-                std::string error = "{\"type\":\"error\",\"error\":\"Failed to save game data\"}";
-                hp_write_user_msg(user, error.c_str(), error.length());
-                return;
-            }
-        }
-        else
-        {
-            std::cout << "ERROR: AI Daemon failed to generate game content!" << std::endl;
-            std::string error = "{\"type\":\"error\",\"error\":\"Failed to generate game content\"}";
-            hp_write_user_msg(user, error.c_str(), error.length());
-            return;
-        }
+    if (message.find("\"type\":\"stat\"") != std::string::npos)
+    {
+        kind = "stat";
+        return true;
+    }
+    if (message.find("\"type\":\"query\"") != std::string::npos)
+        return false;
+
+    if (message.front() == '{' && message.back() == '}')
+    {
+        if (message.find("\"create_game\"") != std::string::npos)
+            return false;
+        if (message.find("\"game_id\"") != std::string::npos && message.find("\"action\"") != std::string::npos)
+            return false;
+        if (message.find("\"list_games\"") != std::string::npos)
+        {
+            kind = "list_games";
+            return true;
+        }
+        if (message.find("\"get_game_state\"") != std::string::npos)
+        {
+            kind = "get_game_state";
+            return extractQuotedValue(message, "get_game_state", gameId);
+        }
+        return false;
+    }
+
+    // Colon-separated format: "action:data"
+    size_t colonPos = message.find(":");
+    if (colonPos == std::string::npos)
+        return false;
+    std::string action = message.substr(0, colonPos);
+    if (action == "stat" || action == "list_games")
+    {
+        kind = action;
+        return true;
+    }
+    if (action == "get_game_state")
+    {
+        kind = action;
+        gameId = message.substr(colonPos + 1);
+        return true;
+    }
+    return false;
+}
+
+// Read-only rounds that consist only of stat / list_games / get_game_state are
+// answered here from the pre-serialized snapshots, without the model downloader
+// checks, daemon client, AI Jury or NFT client. Returns false without writing
+// anything if any input needs the full contract path.
+bool serveReadOnlyRound(const struct hp_contract_context *ctx)
+{
+    struct ReadRequest
+    {
+        const struct hp_user *user;
+        std::string kind;
+        std::string gameId;
+    };
+
+    const char *input = (const char *)hp_init_user_input_mmap();
+    std::vector<ReadRequest> requests;
+    for (size_t u = 0; u < ctx->users.count; u++)
+    {
+        const struct hp_user *user = &ctx->users.list[u];
+        for (size_t input_idx = 0; input_idx < user->inputs.count; input_idx++)
+        {
+            size_t len = user->inputs.list[input_idx].size;
+            if (len == 0)
+                continue;
+
+            ReadRequest request{user, "", ""};
+            std::string message(input + user->inputs.list[input_idx].offset, len);
+            if (!classifyReadRequest(message, request.kind, request.gameId))
+                return false;
+            requests.push_back(std::move(request));
+        }
+    }
+
+    g_modelDownloader = std::make_unique<ModelDownloader>();
+    g_gameManager = std::make_unique<GameStateManager>();
+
+    for (const auto &request : requests)
+    {
+        if (request.kind == "stat")
+        {
+            process_readonly_stat_message(request.user);
+        }
+        else if (request.kind == "list_games")
+        {
+            std::string result = g_gameManager->loadGamesListSnapshot();
+            hp_write_user_msg(request.user, result.c_str(), result.length());
+        }
+        else
+        {
+            std::string result = g_gameManager->loadGameStateSnapshot(request.gameId);
+            if (result.empty())
+                result = "{\"type\":\"error\",\"error\":\"Game not found\"}";
+            hp_write_user_msg(request.user, result.c_str(), result.length());
+        }
+    }
+
+    std::cout << "Read-only round answered from snapshots (" << requests.size() << " requests)" << std::endl;
+    return true;
+}
+
+void process_game_message(const struct hp_user *user, const std::string &action, const std::string &data, AIJury::RequestId action_idx, int peer_count)
+{
+    std::cout << "=== PROCESS_GAME_MESSAGE (Daemon-Based) ===" << std::endl;
+    std::cout << "Action: " << action << std::endl;
+    std::cout << "Data: " << data << std::endl;
+    std::cout << "Action Index: " << action_idx << std::endl;
+    std::cout << "Peer Count: " << peer_count << std::endl;
+
+    if (!g_aiClient || !g_gameManager)
+    {
+        std::string error = "{\"type\":\"error\",\"error\":\"Game systems not initialized\"}";
+        std::cout << "ERROR: Game systems not initialized!" << std::endl;
+        writeUserMessage(user, error);
+        return;
+    }
+
+    // Check daemon connectivity
+    if (!g_aiClient->isDaemonRunning())
+    {
+        std::string error = "{\"type\":\"error\",\"error\":\"AI Daemon not running\"}";
+        std::cout << "ERROR: AI Daemon not running!" << std::endl;
+        writeUserMessage(user, error);
+        return;
+    }
+
+    // Check if model is ready (for actions that require AI)
+    bool model_ready = g_aiClient->isModelReady();
+    if (!model_ready && (action == "create_game" || action == "player_action"))
+    {
+        std::string error = "{\"type\":\"error\",\"error\":\"AI model still loading, please try again in a few minutes\"}";
+        std::cout << "INFO: AI model still loading, skipping " << action << std::endl;
+        writeUserMessage(user, error);
+        return;
+    }
+
+    // Only player_action requires voting consensus - all other actions are immediate
+    if (action != "player_action")
+    {
+        std::cout << "Action '" << action << "' does not require voting - processing immediately..." << std::endl;
+    }
+
+    // Create game action state in the round arena. It is recycled when this call returns
+    // once its consensus has been answered; a state still waiting for votes stays until
+    // the end-of-round NPL read so a late consensus can still find it.
+    GameActionState *state = g_roundArena.acquire();
+    struct StateRelease
+    {
+        GameActionState *state;
+        ~StateRelease()
+        {
+            if (state->action_idx == 0 || !g_aiJury || g_aiJury->isConsensusReached(state->action_idx))
+                g_roundArena.release(state);
+        }
+    } stateRelease{state};
+    state->user = user;
+    state->action = action;
+
+    std::string playerActionText;
+    bool continue_conversation = false;
+    BlobCache::Blob newGameState = BlobCache::empty(); // Set only when generation produced a new state
+    bool narrativeDeferred = false;                    // Two-phase turn: the narrative follows the state
+    PendingNarrativeStore::Record narrative;
+
+    if (action == "create_game")
+    {
+        // Create new game from user prompt - NO VOTING NEEDED
+        std::cout << "=== CREATE_GAME (No Voting - Daemon-Based) ===" << std::endl;
+        // Use the world generated in this round's batch if there is one
+        std::string aiResponse;
+        auto batched = g_batchedGameCreations.find(data);
+        if (batched != g_batchedGameCreations.end())
+        {
+            std::cout << "Using world from batched creation" << std::endl;
+            aiResponse = batched->second;
+            g_batchedGameCreations.erase(batched);
+        }
+        else
+        {
+            aiResponse = g_aiClient->createGame(data, "", worldPoolMode());
+        }
+
+        std::cout << "AI Response Length: " << aiResponse.length() << std::endl;
+        std::cout << "AI Response (first 200 chars): " << aiResponse.substr(0, 200) << std::endl;
+        std::cout << "AI Response (last 200 chars): " << aiResponse.substr(std::max(0, (int)aiResponse.length() - 200)) << std::endl;
+
+        // Simple error checking - only check for empty response
+        if (!aiResponse.empty())
+        {
+            // Generate deterministic game ID using user prompt for hash
+            std::string gameId = g_gameManager->generateGameId(data, "");
+            std::cout << "Generated Game ID: " << gameId << std::endl;
+
+            // Separate game world from game state
+            auto [gameWorldContent, gameStateContent] = g_gameManager->separateGameContent(aiResponse);
+
+            // Save game files directly (no validation needed for creation)
+            if (g_gameManager->saveGameWorld(gameId, gameWorldContent) &&
+                g_gameManager->saveGameState(gameId, gameStateContent))
+            {
+
+                std::cout << "Game created and saved successfully!" << std::endl;
+
+                // Send immediate response - no consensus needed
+                std::string result = "{\"type\":\"gameCreated\",\"game_id\":\"" + escapeJsonForOutput(gameId) + "\",\"status\":\"success\"}";
+                std::cout << "Sending response: " << result << std::endl;
+                int bytes_written = writeUserMessage(user, result);
+                std::cout << "writeUserMessage returned: " << bytes_written << " bytes" << std::endl;
+                std::cout << "Response sent to client immediately!" << std::endl;
+                return; // Exit early - no voting needed
+            }
+            else
+            {
+                std::cout << "ERROR: Failed to save game files!" << std::endl;
+                std::string error = "{\"type\":\"error\",\"error\":\"Failed to save game data\"}";
+                writeUserMessage(user, error);
+                return;
+            }
+        }
+        else
+        {
+            std::cout << "ERROR: AI Daemon failed to generate game content!" << std::endl;
+            std::string error = "{\"type\":\"error\",\"error\":\"Failed to generate game content\"}";
+            writeUserMessage(user, error);
+            return;
+        }
     }
     else if (action == "player_action")
     {
@@ -1218,9 +2531,6 @@ void process_game_message(const struct hp_user *user, const std::string &action,
             // Set context even for format errors (no validation needed here)
             state->gameId = "";
             state->playerAction = data;
-            state->oldGameState = "";
-            state->newGameState = "";
-            state->gameWorld = "";
         }
         else
         {
@@ -1248,8 +2558,24 @@ void process_game_message(const struct hp_user *user, const std::string &action,
                 std::cout << "[DEBUG] Using two-part format, continue_conversation = false" << std::endl;
             }
             // Load existing game state AND game world
-            oldGameState = g_gameManager->loadGameState(gameId);
-            gameWorld = g_gameManager->loadGameWorld(gameId);
+            state->oldGameState = g_blobCache.intern(g_gameManager->loadGameState(gameId));
+            const WorldCache::Entry &world = g_worldCache.get(gameId);
+            state->gameWorld = world.text;
+            state->worldHash = world.hash;
+
+            // Generation and validation see only the part of the world this turn can touch:
+            // global rules, the current and adjacent locations and the relevant items
+            if (world.index && !state->oldGameState->empty())
+            {
+                std::string slice = world.index->slice(*state->oldGameState);
+                if (slice.size() < world.text->size())
+                {
+                    state->gameWorld = g_blobCache.intern(std::move(slice));
+                    state->worldHash = WorldBlobCache::hashOf(*state->gameWorld);
+                }
+            }
+            const std::string &oldGameState = *state->oldGameState;
+            const std::string &gameWorld = *state->gameWorld;
 
             if (oldGameState.empty() || gameWorld.empty())
             {
@@ -1257,9 +2583,7 @@ void process_game_message(const struct hp_user *user, const std::string &action,
                 state->gameId = gameId;
                 state->playerAction = playerActionText;
                 state->continue_conversation = continue_conversation;
-                state->oldGameState = oldGameState;
-                state->newGameState = oldGameState; // Keep old state
-                state->gameWorld = gameWorld;
+                state->newGameState = state->oldGameState; // Keep old state
             }
             else
             {
@@ -1272,37 +2596,75 @@ void process_game_message(const struct hp_user *user, const std::string &action,
                 std::cout << "Game World Length: " << gameWorld.length() << " chars" << std::endl;
                 std::cout << "========================================\n" << std::endl;
 
-                // Process player action with AI Daemon to get new state
-                std::string actionResult = g_aiClient->processPlayerAction(gameId, playerActionText, oldGameState, gameWorld, continue_conversation);
+                // Mechanical actions (moves, taking items, looking, inventory) on worlds with a
+                // machine-readable map are resolved by rules; the AI Daemon generates the rest
+                std::string actionResult;
+                bool resolvedByRules = world.model && ActionResolver::resolve(*world.model, oldGameState, playerActionText, actionResult);
+                std::string leader = !resolvedByRules && leaderGenerationMode() ? selectTurnLeader(gameId) : "";
+                bool isLeader = leader == hp_get_context()->public_key.data;
+                if (resolvedByRules)
+                {
+                    std::cout << "[Rules] Resolved '" << playerActionText << "' without generation" << std::endl;
+                }
+                else if (!leader.empty() && !isLeader &&
+                         awaitLeaderState(action_idx, leader, oldGameState, peer_count, actionResult))
+                {
+                    std::cout << "[Leader] Adopted the state generated by " << leader.substr(0, 16) << "..." << std::endl;
+                    narrativeDeferred = twoPhaseTurnMode(); // The leader's narrative is relayed to every node
+                }
+                else
+                {
+                    // Process player action with AI Daemon to get new state
+                    narrativeDeferred = twoPhaseTurnMode();
+                    // The daemon's action cache answers near-matches from node-local history, so
+                    // only a turn leader (whose state the followers adopt) or a single-node
+                    // deployment (ACTION_CACHE_MODE) may use it
+                    bool useCache = isLeader || actionCacheMode();
+                    // A conversation is established once for all later turns, so it gets the whole world
+                    actionResult = continue_conversation
+                                       ? g_aiClient->processPlayerAction(gameId, playerActionText, oldGameState, *world.text,
+                                                                         continue_conversation, world.hash, narrativeDeferred, useCache)
+                                       : g_aiClient->processPlayerAction(gameId, playerActionText, oldGameState, gameWorld,
+                                                                         continue_conversation, state->worldHash, narrativeDeferred,
+                                                                         useCache);
+                    if (isLeader)
+                        broadcastLeaderState(action_idx, oldGameState, actionResult);
+                }
 
                 // Always set the context data for voting, regardless of action result
                 state->gameId = gameId;
                 state->playerAction = playerActionText;
-                state->oldGameState = oldGameState;
-                state->gameWorld = gameWorld;
 
                 // Check for error indicators in the text response
                 bool isErrorResponse = false;
                 std::string lowerResponse = actionResult;
                 std::transform(lowerResponse.begin(), lowerResponse.end(), lowerResponse.begin(), ::tolower);
 
-                // Look for common error indicators in the text
-                if (lowerResponse.find("error:") != std::string::npos ||
+                // Look for common error indicators in the text (rule-built states carry none)
+                if (!resolvedByRules && (lowerResponse.find("error:") != std::string::npos ||
                     lowerResponse.find("failed") != std::string::npos ||
                     lowerResponse.find("invalid") != std::string::npos ||
                     lowerResponse.find("cannot") != std::string::npos ||
-                    actionResult.empty())
+                    actionResult.empty()))
                 {
                     isErrorResponse = true;
                 }
 
                 if (!actionResult.empty() && !isErrorResponse)
                 {
-                    newGameState = actionResult;
+                    newGameState = g_blobCache.intern(std::move(actionResult));
                     state->newGameState = newGameState;
+                    if (narrativeDeferred)
+                    {
+                        narrative.round = g_round;
+                        narrative.userKey = user->public_key.data;
+                        narrative.gameId = gameId;
+                        narrative.playerAction = playerActionText;
+                        narrative.oldState = oldGameState;
+                    }
 
                     // Save new state (validation will be handled by AI Jury consensus)
-                    if (!g_gameManager->saveGameState(gameId, newGameState))
+                    if (!g_gameManager->saveGameState(gameId, *state->newGameState))
                     {
                         // File save failed - this will be handled in consensus
                         std::cout << "WARNING: Failed to save game state during processing" << std::endl;
@@ -1311,7 +2673,8 @@ void process_game_message(const struct hp_user *user, const std::string &action,
                 else
                 {
                     // Action processing failed - set old state as new state for consensus
-                    state->newGameState = oldGameState;
+                    state->newGameState = state->oldGameState;
+                    narrativeDeferred = false;
                 }
             }
         }
@@ -1320,37 +2683,26 @@ void process_game_message(const struct hp_user *user, const std::string &action,
     {
         // List available games - NO VOTING NEEDED (read-only operation)
         std::cout << "=== LIST_GAMES (No Voting) ===" << std::endl;
-        std::vector<std::string> games = g_gameManager->listGames();
-        std::string gamesList = "[";
-        for (size_t i = 0; i < games.size(); ++i)
-        {
-            gamesList += "\"" + games[i] + "\"";
-            if (i < games.size() - 1)
-                gamesList += ",";
-        }
-        gamesList += "]";
 
         // Send immediate response - no consensus needed
-        std::string result = "{\"type\":\"gamesList\",\"games\":" + gamesList + "}";
-        hp_write_user_msg(user, result.c_str(), result.length());
+        std::string result = g_gameManager->loadGamesListSnapshot();
+        writeUserMessage(user, result);
         return; // Exit early - no voting needed
     }
     else if (action == "get_game_state")
     {
         // Get game state - NO VOTING NEEDED (read-only operation)
         std::cout << "=== GET_GAME_STATE (No Voting) ===" << std::endl;
-        std::string gameState = g_gameManager->loadGameState(data);
+        std::string result = g_gameManager->loadGameStateSnapshot(data);
 
-        if (!gameState.empty())
+        if (!result.empty())
         {
-            std::string result = "{\"type\":\"gameState\",\"game_id\":\"" + escapeJsonForOutput(data) +
-                                 "\",\"state\":\"" + escapeJsonForOutput(gameState) + "\"}";
-            hp_write_user_msg(user, result.c_str(), result.length());
+            writeUserMessage(user, result);
         }
         else
         {
             std::string error = "{\"type\":\"error\",\"error\":\"Game not found\"}";
-            hp_write_user_msg(user, error.c_str(), error.length());
+            writeUserMessage(user, error);
         }
         return; // Exit early - no voting needed
     }
@@ -1362,22 +2714,23 @@ void process_game_message(const struct hp_user *user, const std::string &action,
         const struct hp_contract_context *ctx = hp_get_context();
         if (!ctx) {
             std::string error = "{\"type\":\"error\",\"error\":\"Contract context not available\"}";
-            hp_write_user_msg(user, error.c_str(), error.length());
+            writeUserMessage(user, error);
             return;
         }
         
         // Check if this is a read-only context (HotPocket read request)
         if (!ctx->readonly) {
             std::string error = "{\"type\":\"error\",\"error\":\"NFT minting is temporarily disabled - only read-only mode supported\"}";
-            hp_write_user_msg(user, error.c_str(), error.length());
+            writeUserMessage(user, error);
             return;
         }
         
         std::cout << "[NFT] Running in read-only mode - performing NFT minting without consensus coordination" << std::endl;
         
-        if (!g_nftMintingClient) {
+        NFTMintingClient *mintingClient = ensureNFTMintingClient();
+        if (!mintingClient) {
             std::string error = "{\"type\":\"error\",\"error\":\"NFT minting client not initialized\"}";
-            hp_write_user_msg(user, error.c_str(), error.length());
+            writeUserMessage(user, error);
             return;
         }
         
@@ -1386,7 +2739,7 @@ void process_game_message(const struct hp_user *user, const std::string &action,
         std::ifstream nftFile(nftFilePath);
         if (!nftFile) {
             std::string error = "{\"type\":\"error\",\"error\":\"NFT data file not found for game: " + data + "\"}";
-            hp_write_user_msg(user, error.c_str(), error.length());
+            writeUserMessage(user, error);
             return;
         }
         
@@ -1398,7 +2751,7 @@ void process_game_message(const struct hp_user *user, const std::string &action,
             nlohmann::json nftData = nlohmann::json::parse(nftContent);
             
             // Check if already minted
-            if (g_nftMintingClient->isAlreadyMinted(nftData)) {
+            if (mintingClient->isAlreadyMinted(nftData)) {
                 nlohmann::json alreadyMintedResult;
                 alreadyMintedResult["type"] = "nft_mint_result";
                 alreadyMintedResult["game_id"] = data;
@@ -1407,13 +2760,13 @@ void process_game_message(const struct hp_user *user, const std::string &action,
                 alreadyMintedResult["message"] = "NFTs already minted for this game";
                 alreadyMintedResult["readonly_mode"] = true;
                 
-                hp_write_user_msg(user, alreadyMintedResult.dump().c_str(), alreadyMintedResult.dump().length());
+                writeUserMessage(user, alreadyMintedResult.dump());
                 return;
             }
             
             // Perform actual NFT minting in read-only mode
             std::cout << "[NFT] Starting NFT minting in read-only mode for game: " << data << std::endl;
-            NFTMintBatch mintResult = g_nftMintingClient->mintNFTsForGame(data, nftData);
+            NFTMintBatch mintResult = mintingClient->mintNFTsForGame(data, nftData);
             std::cout << "[NFT] Minting result: " << mintResult.success << std::endl;
 
             // Prepare result for direct response (no NPL broadcast in read-only mode)
@@ -1456,7 +2809,7 @@ void process_game_message(const struct hp_user *user, const std::string &action,
             }
 
             std::cout << "[NFT] Read-only minting completed" << result.dump() << std::endl;
-            hp_write_user_msg(user, result.dump().c_str(), result.dump().length());
+            writeUserMessage(user, result.dump());
         } catch (const std::exception& e) {
             nlohmann::json errorResult;
             errorResult["type"] = "nft_mint_result";
@@ -1465,7 +2818,7 @@ void process_game_message(const struct hp_user *user, const std::string &action,
             errorResult["readonly_mode"] = true;
             errorResult["error"] = "Failed to parse NFT data: " + std::string(e.what());
             
-            hp_write_user_msg(user, errorResult.dump().c_str(), errorResult.dump().length());
+            writeUserMessage(user, errorResult.dump());
         }
         
         return; // Exit early - no consensus needed
@@ -1474,7 +2827,7 @@ void process_game_message(const struct hp_user *user, const std::string &action,
     {
         // Unknown action
         std::string error = "{\"type\":\"error\",\"error\":\"Unknown action: " + action + "\"}";
-        hp_write_user_msg(user, error.c_str(), error.length());
+        writeUserMessage(user, error);
         return;
     }
 
@@ -1486,17 +2839,41 @@ void process_game_message(const struct hp_user *user, const std::string &action,
     std::cout << "Action: " << action << " requires consensus validation" << std::endl;
 
     // Use AI Jury for validation instead of direct daemon
-    gameWorld = g_gameManager->loadGameWorld(state->gameId);
-    std::string transitionContext = "GameWorld: " + gameWorld + " -> OldState: " + oldGameState + " -> PlayerAction: " + playerActionText + " -> NewState: " + newGameState;
+    // (world and states come from the shared blobs loaded above - one copy, built once).
+    // A hashed world is left out of the statement: the jury daemon puts it back in front
+    // as "GameWorld: <world> -> " and receives the text only if it has not cached it.
+    std::string transitionContext;
+    transitionContext.reserve(state->gameWorld->size() + state->oldGameState->size() + playerActionText.size() +
+                              newGameState->size() + 64);
+    if (state->worldHash.empty())
+        transitionContext.append("GameWorld: ").append(*state->gameWorld).append(" -> ");
+    transitionContext.append("OldState: ").append(*state->oldGameState);
+    transitionContext.append(" -> PlayerAction: ").append(playerActionText);
+    transitionContext.append(" -> NewState: ").append(*newGameState);
 
     // std::string transitionContext = "Old: " + oldGameState + " -> Action: " + playerActionText + " -> New: " + newGameState;
-    g_aiJury->processRequest(user, "validate_game_action", transitionContext, action_idx, peer_count, "game_engine_context");
-
-    // Store state for consensus BEFORE waiting (like legacy contract)
-    g_gameActionHandlers.push_back(std::move(state));
+    bindRequestSlot(action_idx);
+    if (consensusPipelineMode())
+        g_pendingTransitions.markDeferred(action_idx); // Before any vote can complete it
+    ensureAIJury()->processRequest(user, "validate_game_action", transitionContext, action_idx, peer_count, "game_engine_context",
+                                   *state->gameWorld, state->worldHash);
+
+    // Pipelined: the votes are collected by later rounds
+    if (consensusPipelineMode())
+    {
+        if (narrativeDeferred)
+            g_pendingNarratives.add(narrative);
+        deferJuryConsensus(user, *state);
+        return;
+    }
 
     // Wait for AI Jury consensus
+    std::string gameId = state->gameId; // The state is recycled once consensus completes
     waitForJuryConsensus(action_idx, peer_count);
+
+    // A rejected state has been reverted - its narrative is not wanted
+    if (narrativeDeferred && g_gameManager->loadGameState(gameId) == *newGameState)
+        g_pendingNarratives.add(narrative);
 }
 
 // LEGACY VOTING SYSTEM REMOVED - Only AI Jury validation is used now
@@ -1510,6 +2887,22 @@ void juryNPLBroadcast(const std::string &msg)
 // Enhanced AI Jury user response callback that includes game state information
 void juryUserResponse(const hp_user *user, const std::string &response)
 {
+    // The consensus may be completed by another worker's NPL read - answer into the
+    // slot of the input that made the request
+    OutputSlotScope slotScope;
+
+    // A carried-over transition's answer is held for the pending record and sent in its
+    // delivery round (see restorePendingTransitions)
+    AIJury::RequestId answeredRequest = 0;
+    auto send = [&](const std::string &message)
+    {
+        if (user && !g_pendingTransitions.isDeferred(answeredRequest))
+            writeUserMessage(user, message);
+        else if (answeredRequest != 0)
+            g_pendingTransitions.holdResponse(answeredRequest, message);
+        else
+            std::cout << "[GameEngine] Dropping jury response without a user or request ID" << std::endl;
+    };
     try
     {
         // Parse the AI Jury consensus response
@@ -1539,28 +2932,25 @@ void juryUserResponse(const hp_user *user, const std::string &response)
             {
                 consensusDetails = juryResponse;
             }
+            answeredRequest = consensusDetails.value("requestId", static_cast<AIJury::RequestId>(0));
+            slotScope.enter(requestSlot(answeredRequest));
 
             // Check if this is a game action validation
             if (consensusDetails.contains("messageType") && consensusDetails["messageType"] == "validate_game_action")
             {
 
                 // Find the corresponding game action state to get the game state
-                int requestId = consensusDetails.value("requestId", -1);
+                AIJury::RequestId requestId = consensusDetails.value("requestId", static_cast<AIJury::RequestId>(0));
                 bool validAction = consensusDetails.value("decision", "invalid") == "valid";
 
                 std::cout << "[GameEngine] Found game action validation response for request " << requestId
                           << ", valid=" << validAction << std::endl;
 
                 // Find the game action state that matches this request
-                GameActionState *gameState = nullptr;
-                for (auto &handler : g_gameActionHandlers)
+                GameActionState *gameState = g_roundArena.find(requestId);
+                if (gameState)
                 {
-                    if (handler && handler->action_idx == requestId)
-                    {
-                        gameState = handler.get();
-                        std::cout << "[GameEngine] Found matching game state for action: " << gameState->action << std::endl;
-                        break;
-                    }
+                    std::cout << "[GameEngine] Found matching game state for action: " << gameState->action << std::endl;
                 }
 
                 if (gameState && gameState->action == "player_action")
@@ -1570,15 +2960,15 @@ void juryUserResponse(const hp_user *user, const std::string &response)
                     juryResponse["player_action"] = gameState->playerAction;
 
                     // Include the current game state after the action
-                    if (validAction && !gameState->newGameState.empty())
+                    if (validAction && !gameState->newGameState->empty())
                     {
                         // Action was valid - include the new game state
-                        juryResponse["game_state"] = gameState->newGameState;
+                        juryResponse["game_state"] = *gameState->newGameState;
                         juryResponse["action_result"] = "success";
                         std::cout << "[GameEngine] Added new game state (valid action)" << std::endl;
 
                         // Check if game is won and trigger NFT generation
-                        if (gameState->newGameState.find("Game_Status: won") != std::string::npos)
+                        if (gameState->newGameState->find("Game_Status: won") != std::string::npos)
                         {
                             std::cout << "[GameEngine] GAME WON! Triggering player inventory extraction for NFT generation" << std::endl;
                             
@@ -1589,7 +2979,7 @@ void juryUserResponse(const hp_user *user, const std::string &response)
                                     // Extract player inventory from the winning game state
                                     g_valuableItemExtractor->extractPlayerInventory(
                                         gameState->gameId,
-                                        gameState->newGameState,
+                                        *gameState->newGameState,
                                         gameState->playerAction
                                     );
                                     
@@ -1610,15 +3000,17 @@ void juryUserResponse(const hp_user *user, const std::string &response)
                     else
                     {
                         // Action was invalid - include the old game state (no change)
-                        juryResponse["game_state"] = gameState->oldGameState;
+                        juryResponse["game_state"] = *gameState->oldGameState;
                         juryResponse["action_result"] = "failed";
                         std::cout << "[GameEngine] Added old game state (invalid action)" << std::endl;
                         
                         // CRITICAL FIX: Revert the game state file to old state when action is invalid
-                        if (!gameState->gameId.empty() && !gameState->oldGameState.empty())
+                        // (unless a later pipelined action has already moved the game on)
+                        if (!gameState->gameId.empty() && !gameState->oldGameState->empty() &&
+                            g_gameManager->loadGameState(gameState->gameId) == *gameState->newGameState)
                         {
                             std::cout << "[GameEngine] REVERTING game state file for game " << gameState->gameId << std::endl;
-                            g_gameManager->saveGameState(gameState->gameId, gameState->oldGameState);
+                            g_gameManager->saveGameState(gameState->gameId, *gameState->oldGameState);
                             std::cout << "[GameEngine] Successfully reverted to old game state" << std::endl;
                         }
                     }
@@ -1629,7 +3021,7 @@ void juryUserResponse(const hp_user *user, const std::string &response)
                     // Send the enhanced response
                     std::string enhancedResponse = juryResponse.dump();
                     std::cout << "[GameEngine] Sending enhanced response: " << enhancedResponse << std::endl;
-                    hp_write_user_msg(user, enhancedResponse.c_str(), enhancedResponse.length());
+                    send(enhancedResponse);
                     return;
                 }
             }
@@ -1637,34 +3029,86 @@ void juryUserResponse(const hp_user *user, const std::string &response)
 
         // For non-game-action responses or if we can't enhance, send original response
         std::cout << "[GameEngine] Sending original response (not enhanced)" << std::endl;
-        hp_write_user_msg(user, response.c_str(), response.length());
+        send(response);
     }
     catch (const std::exception &e)
     {
         std::cout << "[GameEngine] Error enhancing jury response: " << e.what() << std::endl;
         // Fallback to original response
-        hp_write_user_msg(user, response.c_str(), response.length());
+        send(response);
     }
 }
 
 // AI Jury vote processing (called for each NPL vote)
-void process_jury_vote(const std::string &voteJson, int peer_count)
+void process_jury_vote(const std::string &voteJson, const std::string &sender, int peer_count)
 {
-    if (g_aiJury)
+    // Set up at round start whenever this round has jury work; never lazily here, under
+    // g_nplReadMutex
+    if (!g_aiJury)
     {
-        g_aiJury->processVote(voteJson, peer_count);
+        std::cout << "[Jury] Vote from " << sender.substr(0, 16) << "... ignored - no jury work this round" << std::endl;
+        return;
+    }
+    g_aiJury->processVote(voteJson, sender, peer_count);
+}
+
+// NPL batch handler - routes one message by type. user_data points at the peer count.
+void dispatchNplMessage(const struct hp_npl_msg *msg, void *user_data)
+{
+    int peer_count = *static_cast<int *>(user_data);
+    std::string msgJson(static_cast<const char *>(msg->data), msg->len);
+
+    try {
+        nlohmann::json nplMessage = nlohmann::json::parse(msgJson);
+        
+        // COMMENTED OUT NFT COORDINATION - READ-ONLY MODE ONLY
+        // Check for NFT coordination messages (completely separate system)
+        // if (nplMessage.contains("type") && nplMessage["type"] == "nft_coordination") {
+        //     processNFTCoordinationMessage(msgJson, msg->sender);
+        // }
+        // New state from a turn leader (LEADER_GENERATION_MODE)
+        if (nplMessage.value("type", "") == "leader_state") {
+            g_leaderStates.post(nplMessage.value("request_id", static_cast<AIJury::RequestId>(0)), msg->sender,
+                                nplMessage.value("old_state_hash", ""), nplMessage.value("new_state", ""));
+        }
+        // Narrative of a two-phase turn from the game's narrator (deliverPendingNarratives)
+        else if (nplMessage.value("type", "") == "narrative_relay") {
+            g_relayedNarratives.post(nplMessage.value("ticket", static_cast<uint64_t>(0)), msg->sender, "",
+                                     nplMessage.value("narrative", ""));
+        }
+        // Check for AI Jury votes (separate system)
+        else if (nplMessage.contains("requestId")) {
+            std::cout << "Received jury vote: " << msgJson.substr(0, 100) << "..." << std::endl;
+            process_jury_vote(msgJson, msg->sender, peer_count);
+        }
+        else if (nplMessage.contains("type") && nplMessage["type"] == "nft_coordination") {
+            std::cout << "[NPL] IGNORED: NFT coordination disabled - read-only mode only" << std::endl;
+        }
+        else {
+            std::cout << "[NPL] IGNORED: Unknown message format: " << msgJson.substr(0, 100) << "..." << std::endl;
+        }
+    } catch (const std::exception& e) {
+        // Fallback for JSON parsing errors only - use string search as last resort
+        std::cout << "[NPL] JSON parse failed, attempting string-based detection: " << e.what() << std::endl;
+        
+        if (msgJson.find("\"requestId\":") != std::string::npos) {
+            // Fallback: This is likely an AI Jury vote with malformed JSON
+            std::cout << "[NPL] Fallback: Processing as AI Jury vote" << std::endl;
+            process_jury_vote(msgJson, msg->sender, peer_count);
+        } else if (msgJson.find("\"type\":\"nft_coordination\"") != std::string::npos) {
+            std::cout << "[NPL] IGNORED: NFT coordination disabled - read-only mode only" << std::endl;
+        } else {
+            std::cout << "[NPL] IGNORED: Cannot identify message type even with string search: " << msgJson.substr(0, 100) << "..." << std::endl;
+        }
     }
 }
 
 // Wait for AI Jury consensus (actively processes NPL messages until consensus reached)
-void waitForJuryConsensus(int request_idx, int peer_count)
+void waitForJuryConsensus(AIJury::RequestId request_idx, int peer_count)
 {
     if (!g_aiJury)
         return;
 
-    char sender[HP_PUBLIC_KEY_SIZE];
-    char *npl_msg = (char *)malloc(HP_NPL_MSG_MAX_SIZE);
-
     std::cout << "=== WAITING FOR AI JURY CONSENSUS ===" << std::endl;
     std::cout << "Request ID: " << request_idx << ", Peer count: " << peer_count << std::endl;
 
@@ -1678,66 +3122,356 @@ void waitForJuryConsensus(int request_idx, int peer_count)
             break;
         }
 
-        // Check for incoming NPL messages with short timeout
-        const int npl_len = hp_read_npl_msg(npl_msg, sender, 100); // 100ms timeout
-        if (npl_len > 0)
+        // One waiting worker drains NPL for all of them; votes for other workers'
+        // requests are dispatched to those requests as they arrive
+        std::unique_lock<std::mutex> reader(g_nplReadMutex, std::try_to_lock);
+        if (!reader.owns_lock())
         {
-            std::string voteJson(npl_msg, npl_len);
-            std::cout << "Received jury vote: " << voteJson.substr(0, 100) << "..." << std::endl;
-            process_jury_vote(voteJson, peer_count);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
         }
 
-        // Small delay to prevent busy waiting
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        // Drain all votes that have arrived; the poll inside waits up to 100ms for the first
+        if (hp_read_npl_batch(dispatchNplMessage, &peer_count, 100) < 0)
+        {
+            // Channel error - back off instead of spinning on it
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
     }
 
-    free(npl_msg);
     std::cout << "=== AI JURY CONSENSUS WAIT COMPLETE ===" << std::endl;
 }
 
-// COMMENTED OUT NFT CONSENSUS COORDINATION FUNCTIONS - IMPLEMENTING READ-ONLY MODE ONLY
-
-/*
-// NFT Minting Coordination Functions
-
-// Deterministic node selection based on public key comparison
-std::string selectDeterministicMinter(const std::string &gameId, int peer_count)
+// Pipelined player action: persist the transition with this node's vote and tell the
+// user the answer follows once the peers' votes are in. Also when the votes are already
+// complete here: the answer is held like any other and sent in the delivery round.
+void deferJuryConsensus(const struct hp_user *user, const GameActionState &state)
 {
-    const struct hp_contract_context *ctx = hp_get_context();
-    if (!ctx || ctx->unl.count == 0) {
-        return std::string(ctx->public_key.data); // Fallback to self if no UNL
-    }
-    
-    std::cout << "[NFT] Selecting deterministic minter for game: " << gameId << std::endl;
-    std::cout << "[NFT] UNL count: " << ctx->unl.count << std::endl;
-    
-    // Use lexicographic comparison to select lowest public key
-    std::string selectedMinter = std::string(ctx->public_key.data);
-    
-    // Compare with all UNL nodes to find lowest public key
-    for (size_t i = 0; i < ctx->unl.count; i++) {
-        std::string nodeKey(ctx->unl.list[i].public_key.data);
-        std::cout << "[NFT] Comparing node key: " << nodeKey.substr(0, 16) << "..." << std::endl;
-        
-        if (nodeKey < selectedMinter) {
-            selectedMinter = nodeKey;
-        }
+    if (!g_aiJury)
+        return;
+
+    PendingTransitionStore::Record record;
+    record.requestId = state.action_idx;
+    record.round = g_round;
+    record.userKey = user->public_key.data;
+    record.gameId = state.gameId;
+    record.playerAction = state.playerAction;
+    record.oldState = *state.oldGameState;
+    record.newState = *state.newGameState;
+    g_aiJury->snapshotRequest(record.requestId, record.ownVote, record.votes);
+    {
+        std::lock_guard<std::mutex> lock(g_openTransitionsMutex);
+        g_openTransitions.push_back(record);
     }
-    
-    std::cout << "[NFT] Selected minter: " << selectedMinter.substr(0, 16) << "..." << std::endl;
-    return selectedMinter;
+    std::cout << "[Pipeline] Deferred consensus for request " << record.requestId << " (game " << record.gameId << ")" << std::endl;
+
+    nlohmann::json pending;
+    pending["type"] = "consensus_pending";
+    pending["requestId"] = record.requestId;
+    pending["game_id"] = record.gameId;
+    pending["player_action"] = record.playerAction;
+    writeUserMessage(user, pending.dump());
 }
-*/
 
-/*
-// Process NFT minting request with NPL coordination
-void processNFTMintingRequest(const struct hp_user *user, const std::string &gameId, int peer_count)
+// Round start: deliver answers that are due to users connected this round and register the
+// still-open transitions with the jury (which broadcasts this node's vote again)
+void restorePendingTransitions(const struct hp_contract_context *ctx, int peer_count)
 {
-    const struct hp_contract_context *ctx = hp_get_context();
-    if (!ctx) {
-        std::string error = "{\"type\":\"error\",\"error\":\"Contract context not available\"}";
-        hp_write_user_msg(user, error.c_str(), error.length());
-        return;
+    for (PendingTransitionStore::Record &record : g_pendingTransitions.load())
+    {
+        const struct hp_user *user = nullptr;
+        for (size_t u = 0; u < ctx->users.count; u++)
+        {
+            if (record.userKey == ctx->users.list[u].public_key.data)
+                user = &ctx->users.list[u];
+        }
+
+        if (record.round + PENDING_MAX_ROUNDS < g_round)
+        {
+            std::cout << "[Pipeline] Dropping request " << record.requestId << " from round " << record.round
+                      << " - no consensus within " << PENDING_MAX_ROUNDS << " rounds" << std::endl;
+            g_pendingTransitions.remove(record.requestId);
+            continue;
+        }
+
+        if (!record.response.empty())
+        {
+            if (user && record.round + PENDING_ANSWER_ROUNDS <= g_round)
+            {
+                std::cout << "[Pipeline] Delivering held answer for request " << record.requestId << std::endl;
+                writeUserMessage(user, record.response);
+                g_pendingTransitions.remove(record.requestId);
+            }
+            continue;
+        }
+
+        GameActionState *state = g_roundArena.acquire();
+        state->user = user;
+        state->action = "player_action";
+        state->gameId = record.gameId;
+        state->playerAction = record.playerAction;
+        state->oldGameState = g_blobCache.intern(record.oldState);
+        state->newGameState = g_blobCache.intern(record.newState);
+        state->action_idx = record.requestId;
+        {
+            std::lock_guard<std::mutex> lock(g_openTransitionsMutex);
+            g_openTransitions.push_back(record);
+        }
+        g_pendingTransitions.markDeferred(record.requestId);
+        ensureAIJury()->restoreRequest(user, record.requestId, "validate_game_action", record.ownVote, record.votes, peer_count);
+    }
+}
+
+// Round end: give open transitions a short while for votes, then persist each one
+// still waiting with the votes counted so far and retire the answered ones
+void checkpointPendingTransitions(int peer_count)
+{
+    std::lock_guard<std::mutex> lock(g_openTransitionsMutex);
+    if (g_openTransitions.empty() || !g_aiJury)
+        return;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(PENDING_COLLECT_MS);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        bool open = false;
+        for (const auto &record : g_openTransitions)
+            open = open || !g_aiJury->isConsensusReached(record.requestId);
+        if (!open)
+            break;
+        if (hp_read_npl_batch(dispatchNplMessage, &peer_count, 100) < 0)
+            break;
+    }
+
+    for (auto &record : g_openTransitions)
+    {
+        std::string heldResponse;
+        if (g_aiJury->snapshotRequest(record.requestId, record.ownVote, record.votes))
+        {
+            g_pendingTransitions.save(record);
+        }
+        else if (g_pendingTransitions.takeHeldResponse(record.requestId, heldResponse))
+        {
+            record.response = heldResponse;
+            g_pendingTransitions.save(record);
+        }
+        else
+        {
+            g_pendingTransitions.remove(record.requestId);
+        }
+    }
+    std::cout << "[Pipeline] Checkpointed " << g_openTransitions.size() << " open transition(s)" << std::endl;
+    g_openTransitions.clear();
+}
+
+// Turn leader of a game: the game ID hashed over the sorted UNL keys (this node included),
+// so every node picks the same one
+std::string selectTurnLeader(const std::string &gameId)
+{
+    const struct hp_contract_context *ctx = hp_get_context();
+    std::vector<std::string> keys = {ctx->public_key.data};
+    for (size_t i = 0; i < ctx->unl.count; i++)
+    {
+        std::string key = ctx->unl.list[i].public_key.data;
+        if (std::find(keys.begin(), keys.end(), key) == keys.end())
+            keys.push_back(key);
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys[ContentHash::fnv1a64(gameId) % keys.size()];
+}
+
+// Follower: wait for the leader's state until the round's leader wait runs out, draining NPL like
+// the consensus wait does
+bool awaitLeaderState(AIJury::RequestId requestId, const std::string &leader, const std::string &oldState, int peer_count,
+                      std::string &newState)
+{
+    std::string oldStateHash = ContentHash::hashHex(oldState);
+    while (!g_leaderStates.take(requestId, leader, oldStateHash, newState))
+    {
+        if (std::chrono::steady_clock::now() >= g_leaderWaitDeadline)
+        {
+            std::cout << "[Leader] No state from " << leader.substr(0, 16) << "... within the round's "
+                      << LEADER_WAIT_MS << "ms leader wait - generating locally" << std::endl;
+            return false;
+        }
+
+        std::unique_lock<std::mutex> reader(g_nplReadMutex, std::try_to_lock);
+        if (!reader.owns_lock())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
+        }
+        if (hp_read_npl_batch(dispatchNplMessage, &peer_count, 100) < 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return true;
+}
+
+// Leader: hand the generated state to the followers, tied to the old state it continues
+void broadcastLeaderState(AIJury::RequestId requestId, const std::string &oldState, const std::string &newState)
+{
+    nlohmann::json message;
+    message["type"] = "leader_state";
+    message["request_id"] = requestId;
+    message["old_state_hash"] = ContentHash::hashHex(oldState);
+    message["new_state"] = newState;
+    juryNPLBroadcast(message.dump());
+    std::cout << "[Leader] Broadcast state for request " << requestId << std::endl;
+}
+
+// Round end: send the narratives that are due to their connected users and keep the rest
+// for later rounds. Every node sends the same text: only the game's narrator (its turn
+// leader, which in leader mode is the one node that generated the turn) fetches the
+// narrative from its daemon and relays it over NPL as {"type":"narrative_relay"}; the
+// other nodes send what it relayed. A due narrative is sent or dropped in this round.
+void deliverPendingNarratives(const struct hp_contract_context *ctx, int peer_count)
+{
+    struct Due
+    {
+        PendingNarrativeStore::Record record;
+        const struct hp_user *user;
+        std::string narrator;
+        uint64_t ticket;
+        std::string narrative;
+        bool ready;
+    };
+    std::vector<Due> due;
+    std::vector<PendingNarrativeStore::Record> waiting;
+    for (PendingNarrativeStore::Record &record : g_pendingNarratives.take())
+    {
+        if (record.round + NARRATIVE_MAX_ROUNDS < g_round)
+        {
+            std::cout << "[Narrative] Dropping narrative of game " << record.gameId << " from round " << record.round << std::endl;
+            continue;
+        }
+
+        const struct hp_user *user = nullptr;
+        for (size_t u = 0; u < ctx->users.count; u++)
+        {
+            if (record.userKey == ctx->users.list[u].public_key.data)
+                user = &ctx->users.list[u];
+        }
+        if (!user || record.round + NARRATIVE_DELIVERY_ROUNDS > g_round)
+        {
+            waiting.push_back(std::move(record));
+            continue;
+        }
+        uint64_t ticket = NarrativeTickets::ticketOf(record.gameId, record.oldState, record.playerAction);
+        due.push_back({std::move(record), user, "", ticket, "", false});
+    }
+    g_pendingNarratives.save(waiting);
+    if (due.empty())
+        return;
+
+    // Narrator: fetch (waiting up to NARRATIVE_WAIT_MS in total) and relay
+    auto start = std::chrono::steady_clock::now();
+    auto fetchDeadline = start + std::chrono::milliseconds(NARRATIVE_WAIT_MS);
+    for (Due &item : due)
+    {
+        item.narrator = selectTurnLeader(item.record.gameId);
+        if (item.narrator != ctx->public_key.data || !g_aiClient)
+            continue;
+
+        int waitMs = std::max(0, static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                                                      fetchDeadline - std::chrono::steady_clock::now())
+                                                      .count()));
+        nlohmann::json response = nlohmann::json::parse(
+            g_aiClient->fetchNarrative(item.record.gameId, item.record.playerAction, item.record.oldState, waitMs),
+            nullptr, false);
+        std::string status = response.is_object() ? response.value("status", "") : "";
+        if (status != "ready")
+        {
+            std::cout << "[Narrative] No narrative for game " << item.record.gameId << " ("
+                      << (status.empty() ? "no answer" : status) << ")" << std::endl;
+            continue;
+        }
+        item.narrative = response.value("narrative", "");
+        item.ready = true;
+
+        nlohmann::json relay;
+        relay["type"] = "narrative_relay";
+        relay["ticket"] = item.ticket;
+        relay["narrative"] = item.narrative;
+        juryNPLBroadcast(relay.dump());
+    }
+
+    // Everyone else: the narrator's relay, for as long as the narrator may still be fetching
+    auto relayDeadline = start + std::chrono::milliseconds(NARRATIVE_WAIT_MS + NARRATIVE_RELAY_MS);
+    for (Due &item : due)
+    {
+        while (!item.ready && item.narrator != ctx->public_key.data)
+        {
+            item.ready = g_relayedNarratives.take(item.ticket, item.narrator, "", item.narrative);
+            if (item.ready || std::chrono::steady_clock::now() >= relayDeadline)
+                break;
+
+            std::unique_lock<std::mutex> reader(g_nplReadMutex, std::try_to_lock);
+            if (!reader.owns_lock())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                continue;
+            }
+            if (hp_read_npl_batch(dispatchNplMessage, &peer_count, 100) < 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        if (!item.ready)
+        {
+            std::cout << "[Narrative] Nothing relayed by " << item.narrator.substr(0, 16) << "... for game "
+                      << item.record.gameId << " - not sent" << std::endl;
+            continue;
+        }
+        nlohmann::json message;
+        message["type"] = "narrative";
+        message["game_id"] = item.record.gameId;
+        message["player_action"] = item.record.playerAction;
+        message["narrative"] = item.narrative;
+        writeUserMessage(item.user, message.dump());
+    }
+}
+
+// COMMENTED OUT NFT CONSENSUS COORDINATION FUNCTIONS - IMPLEMENTING READ-ONLY MODE ONLY
+
+/*
+// NFT Minting Coordination Functions
+
+// Deterministic node selection based on public key comparison
+std::string selectDeterministicMinter(const std::string &gameId, int peer_count)
+{
+    const struct hp_contract_context *ctx = hp_get_context();
+    if (!ctx || ctx->unl.count == 0) {
+        return std::string(ctx->public_key.data); // Fallback to self if no UNL
+    }
+    
+    std::cout << "[NFT] Selecting deterministic minter for game: " << gameId << std::endl;
+    std::cout << "[NFT] UNL count: " << ctx->unl.count << std::endl;
+    
+    // Use lexicographic comparison to select lowest public key
+    std::string selectedMinter = std::string(ctx->public_key.data);
+    
+    // Compare with all UNL nodes to find lowest public key
+    for (size_t i = 0; i < ctx->unl.count; i++) {
+        std::string nodeKey(ctx->unl.list[i].public_key.data);
+        std::cout << "[NFT] Comparing node key: " << nodeKey.substr(0, 16) << "..." << std::endl;
+        
+        if (nodeKey < selectedMinter) {
+            selectedMinter = nodeKey;
+        }
+    }
+    
+    std::cout << "[NFT] Selected minter: " << selectedMinter.substr(0, 16) << "..." << std::endl;
+    return selectedMinter;
+}
+*/
+
+/*
+// Process NFT minting request with NPL coordination
+void processNFTMintingRequest(const struct hp_user *user, const std::string &gameId, int peer_count)
+{
+    const struct hp_contract_context *ctx = hp_get_context();
+    if (!ctx) {
+        std::string error = "{\"type\":\"error\",\"error\":\"Contract context not available\"}";
+        hp_write_user_msg(user, error.c_str(), error.length());
+        return;
     }
     
     std::cout << "[NFT] Processing minting request for game: " << gameId << std::endl;
@@ -2016,55 +3750,367 @@ void processNFTCoordinationMessage(const std::string &nplMessageStr, const char
 */
 
 
-// Main contract function
-int main(int argc, char **argv)
+// Handle one user input. Runs on a round worker with t_outputSlot pointing at this
+// input's slot; input_idx is the input's position among the user's inputs.
+void process_user_input(const struct hp_user *user, size_t input_idx, const std::string &message, int peer_count, bool readonly)
 {
-    std::cout << "=== AI GAME CONTRACT (DAEMON-BASED ARCHITECTURE) ===" << std::endl;
-    std::cout << "Starting AI Game Contract with daemon architecture..." << std::endl;
+    std::cout << "Received message: " << message << std::endl;
 
-    // Initialize HotPocket contract
-    if (hp_init_contract() != 0)
+    // Check what patterns are being found
+    bool foundStat = (message.find("\"type\":\"stat\"") != std::string::npos);
+    bool foundQuery = (message.find("\"type\":\"query\"") != std::string::npos);
+    std::cout << "Pattern search results: stat=" << foundStat << ", query=" << foundQuery << std::endl;
+
+    // Simple string-based message type detection
+    if (foundStat)
     {
-        std::cerr << "Failed to initialize HotPocket contract." << std::endl;
-        return 1;
+        std::cout << "=== DETECTED STAT MESSAGE ===" << std::endl;
+        process_stat_message(user);
+        std::cout << "=== STAT MESSAGE PROCESSING COMPLETE ===" << std::endl;
     }
+    else if (foundQuery)
+    {
+        std::cout << "=== DETECTED QUERY MESSAGE ===" << std::endl;
+        if (!readonly)
+        {
+            // Better JSON parsing to match example.js behavior
+            std::cout << "Processing query message: " << message << std::endl;
 
-    // Initialize user input
-    hp_init_user_input_mmap();
+            // First check if data field exists
+            size_t dataPos = message.find("\"data\":");
+            if (dataPos == std::string::npos)
+            {
+                std::string error = "{\"type\":\"error\",\"error\":\"must provide a data field to query message\"}";
+                writeUserMessage(user, error);
+                return;
+            }
 
-    // Initialize systems
-    g_modelDownloader = std::make_unique<ModelDownloader>();
-    g_gameManager = std::make_unique<GameStateManager>();
-    g_aiClient = std::make_unique<AIServiceClient>();
-    g_gameEngineDaemonManager = std::make_unique<GameEngineDaemonManager>();
+            // Find the data object content
+            size_t dataValueStart = message.find(":", dataPos) + 1;
+            // Skip whitespace
+            while (dataValueStart < message.length() &&
+                   (message[dataValueStart] == ' ' || message[dataValueStart] == '\t' || message[dataValueStart] == '\n'))
+            {
+                dataValueStart++;
+            }
 
-    // Initialize Valuable Item Extractor for NFT generation
-    g_valuableItemExtractor = std::make_unique<ValuableItemExtractor>();
-    std::cout << "Valuable Item Extractor initialized for NFT generation" << std::endl;
+            // Check if data is null or empty
+            if (dataValueStart >= message.length() ||
+                message.substr(dataValueStart, 4) == "null" ||
+                message.substr(dataValueStart, 9) == "undefined")
+            {
+                std::string error = "{\"type\":\"error\",\"error\":\"must provide a data field to query message\"}";
+                writeUserMessage(user, error);
+                return;
+            }
 
-    // Initialize NFT Minting Client for Xahau NFT minting
-    g_nftMintingClient = std::make_unique<NFTMintingClient>();
-    
-    // Configure NFT minting client with wallet seed from environment
-    const char* walletSeed = std::getenv("MINTER_WALLET_SEED");
-    if (!walletSeed) {
-        std::cerr << "ERROR: MINTER_WALLET_SEED environment variable not set!" << std::endl;
-        std::cerr << "Please set: export MINTER_WALLET_SEED=<your_wallet_seed>" << std::endl;
-        return 1;
+            // Handle data as string directly or data as object with query field
+            std::string query;
+
+            // Check if data starts with a quote (data is a string directly)
+            if (message[dataValueStart] == '"')
+            {
+                // Case 1: {"type":"query","data":"actual query text"}
+                size_t queryStart = dataValueStart + 1;
+                size_t queryEnd = message.find("\"", queryStart);
+                if (queryEnd != std::string::npos)
+                {
+                    query = message.substr(queryStart, queryEnd - queryStart);
+                    std::cout << "Found query in data string: " << query << std::endl;
+                }
+            }
+            else if (message[dataValueStart] == '{')
+            {
+                // Case 2: {"type":"query","data":{"query":"actual query text"}}
+                size_t queryPos = message.find("\"query\":", dataPos);
+                if (queryPos == std::string::npos)
+                {
+                    // Try without quotes around query key
+                    queryPos = message.find("query:", dataPos);
+                }
+
+                if (queryPos != std::string::npos)
+                {
+                    // Extract the query value from object
+                    size_t queryValueStart = message.find(":", queryPos) + 1;
+                    // Skip whitespace
+                    while (queryValueStart < message.length() &&
+                           (message[queryValueStart] == ' ' || message[queryValueStart] == '\t' || message[queryValueStart] == '\n'))
+                    {
+                        queryValueStart++;
+                    }
+
+                    if (queryValueStart < message.length() && message[queryValueStart] == '"')
+                    {
+                        // Quoted string
+                        size_t queryStart = queryValueStart + 1;
+                        size_t queryEnd = message.find("\"", queryStart);
+                        if (queryEnd != std::string::npos)
+                        {
+                            query = message.substr(queryStart, queryEnd - queryStart);
+                            std::cout << "Found query in data object: " << query << std::endl;
+                        }
+                    }
+                }
+            }
+            else
+            {
+                // Case 3: data is unquoted value
+                size_t queryEnd = message.find_first_of(",}", dataValueStart);
+                if (queryEnd != std::string::npos)
+                {
+                    query = message.substr(dataValueStart, queryEnd - dataValueStart);
+                    // Trim whitespace
+                    query.erase(0, query.find_first_not_of(" \t\n"));
+                    query.erase(query.find_last_not_of(" \t\n") + 1);
+                    std::cout << "Found query as unquoted data: " << query << std::endl;
+                }
+            }
+
+            if (query.empty())
+            {
+                std::string error = "{\"type\":\"error\",\"error\":\"query field cannot be empty\"}";
+                writeUserMessage(user, error);
+                return;
+            }
+
+            std::cout << "Extracted query: " << query << std::endl;
+            // Use AI Jury for query processing
+            if (ensureAIJury())
+            {
+                // Generate unique request ID for this query
+                AIJury::RequestId current_request_id = AIJury::makeRequestId(g_round, user->public_key.data, message, input_idx);
+
+                bindRequestSlot(current_request_id);
+                g_aiJury->processRequest(user, "validate_query", query, current_request_id, peer_count, "query_interface_context");
+                waitForJuryConsensus(current_request_id, peer_count);
+            }
+            else
+            {
+                std::string response = "{\"type\":\"queryResult\",\"result\":\"AI Jury not available\"}";
+                writeUserMessage(user, response);
+            }
+        }
+        else
+        {
+            std::string error = "{\"type\":\"error\",\"error\":\"query interface must not be read only\"}";
+            writeUserMessage(user, error);
+        }
     }
-    
-    g_nftMintingClient->setMinterWallet(walletSeed);
-    
-    std::cout << "NFT Minting Client initialized with environment configuration" << std::endl;
+    else
+    {
+        // Check if it's a JSON game message format
+        bool isJsonGameMessage = false;
+        std::string gameAction;
+        std::string gameData;
 
-    // Initialize AI Jury for validation
-    g_aiJury = AIJury::createAIModelJury();
-    g_aiJury->setNPLBroadcast(juryNPLBroadcast);
-    g_aiJury->setUserResponse(juryUserResponse);
-    std::cout << "AI Jury ID: " << g_aiJury->getJuryId() << std::endl;
+        // Try to parse as JSON game message first
+        if (message.front() == '{' && message.back() == '}')
+        {
+            // Check for game action fields
+            if (message.find("\"create_game\"") != std::string::npos)
+            {
+                gameAction = "create_game";
+                isJsonGameMessage = extractCreateGamePrompt(message, gameData);
+            }
+            else if (message.find("\"game_id\"") != std::string::npos && message.find("\"action\"") != std::string::npos)
+            {
+                gameAction = "player_action";
+                // Extract game_id, action, and continue_conversation from JSON format: {"game_id": "id", "action": "text", "continue_conversation": "true"}
+                size_t gameIdPos = message.find("\"game_id\":");
+                size_t actionPos = message.find("\"action\":");
+                size_t continuePos = message.find("\"continue_conversation\":");
 
-    // Load AI model for jury (starts daemon if needed)
-    g_aiJury->loadAIModel();
+                if (gameIdPos != std::string::npos && actionPos != std::string::npos)
+                {
+                    // Extract game_id
+                    size_t gameIdValueStart = message.find(":", gameIdPos) + 1;
+                    while (gameIdValueStart < message.length() &&
+                           (message[gameIdValueStart] == ' ' || message[gameIdValueStart] == '\t' || message[gameIdValueStart] == '\n'))
+                    {
+                        gameIdValueStart++;
+                    }
+                    if (gameIdValueStart < message.length() && message[gameIdValueStart] == '"')
+                    {
+                        size_t gameIdStart = gameIdValueStart + 1;
+                        size_t gameIdEnd = message.find("\"", gameIdStart);
+
+                        // Extract action
+                        size_t actionValueStart = message.find(":", actionPos) + 1;
+                        while (actionValueStart < message.length() &&
+                               (message[actionValueStart] == ' ' || message[actionValueStart] == '\t' || message[actionValueStart] == '\n'))
+                        {
+                            actionValueStart++;
+                        }
+                        if (actionValueStart < message.length() && message[actionValueStart] == '"')
+                        {
+                            size_t actionStart = actionValueStart + 1;
+                            size_t actionEnd = message.find("\"", actionStart);
+
+                            if (gameIdEnd != std::string::npos && actionEnd != std::string::npos)
+                            {
+                                std::string gameId = message.substr(gameIdStart, gameIdEnd - gameIdStart);
+                                std::string action = message.substr(actionStart, actionEnd - actionStart);
+
+                                // Extract continue_conversation if present
+                                std::string continueConversation = "false"; // default value
+                                if (continuePos != std::string::npos)
+                                {
+                                    size_t continueValueStart = message.find(":", continuePos) + 1;
+                                    while (continueValueStart < message.length() &&
+                                           (message[continueValueStart] == ' ' || message[continueValueStart] == '\t' || message[continueValueStart] == '\n'))
+                                    {
+                                        continueValueStart++;
+                                    }
+                                    if (continueValueStart < message.length() && message[continueValueStart] == '"')
+                                    {
+                                        size_t continueStart = continueValueStart + 1;
+                                        size_t continueEnd = message.find("\"", continueStart);
+                                        if (continueEnd != std::string::npos)
+                                        {
+                                            continueConversation = message.substr(continueStart, continueEnd - continueStart);
+                                        }
+                                    }
+                                }
+
+                                gameData = gameId + ":" + action + ":" + continueConversation;
+                                isJsonGameMessage = true;
+                                std::cout << "Parsed player action - Game ID: " << gameId << ", Action: " << action << ", Continue: " << continueConversation << std::endl;
+                            }
+                        }
+                    }
+                }
+            }
+            else if (message.find("\"list_games\"") != std::string::npos)
+            {
+                gameAction = "list_games";
+                gameData = "";
+                isJsonGameMessage = true;
+            }
+            else if (message.find("\"get_game_state\"") != std::string::npos)
+            {
+                gameAction = "get_game_state";
+                size_t actionPos = message.find("\"get_game_state\":");
+                if (actionPos != std::string::npos)
+                {
+                    size_t valueStart = message.find(":", actionPos) + 1;
+                    while (valueStart < message.length() &&
+                           (message[valueStart] == ' ' || message[valueStart] == '\t' || message[valueStart] == '\n'))
+                    {
+                        valueStart++;
+                    }
+                    if (valueStart < message.length() && message[valueStart] == '"')
+                    {
+                        size_t dataStart = valueStart + 1;
+                        size_t dataEnd = message.find("\"", dataStart);
+                        if (dataEnd != std::string::npos)
+                        {
+                            gameData = message.substr(dataStart, dataEnd - dataStart);
+                            isJsonGameMessage = true;
+                        }
+                    }
+                }
+            }
+            else if (message.find("\"mint_nft\"") != std::string::npos)
+            {
+                gameAction = "mint_nft";
+                size_t actionPos = message.find("\"mint_nft\":");
+                if (actionPos != std::string::npos)
+                {
+                    size_t valueStart = message.find(":", actionPos) + 1;
+                    while (valueStart < message.length() &&
+                           (message[valueStart] == ' ' || message[valueStart] == '\t' || message[valueStart] == '\n'))
+                    {
+                        valueStart++;
+                    }
+                    if (valueStart < message.length() && message[valueStart] == '"')
+                    {
+                        size_t dataStart = valueStart + 1;
+                        size_t dataEnd = message.find("\"", dataStart);
+                        if (dataEnd != std::string::npos)
+                        {
+                            gameData = message.substr(dataStart, dataEnd - dataStart);
+                            isJsonGameMessage = true;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (isJsonGameMessage)
+        {
+            std::cout << "=== DETECTED JSON GAME MESSAGE ===" << std::endl;
+            std::cout << "Game Action: " << gameAction << std::endl;
+            std::cout << "Game Data: " << gameData << std::endl;
+
+            // Process game action with AI validation consensus
+            AIJury::RequestId action_idx = AIJury::makeRequestId(g_round, user->public_key.data, message, input_idx);
+            process_game_message(user, gameAction, gameData, action_idx, peer_count);
+        }
+        else
+        {
+            // Fall back to colon-separated format: "action:data"
+            size_t colonPos = message.find(":");
+            if (colonPos != std::string::npos)
+            {
+                std::string action = message.substr(0, colonPos);
+                std::string data = message.substr(colonPos + 1);
+
+                if (action == "stat")
+                {
+                    process_stat_message(user);
+                }
+                else
+                {
+                    // Process game action with AI validation consensus
+                    // The request ID is derived from round, user and input - identical on every node
+                    AIJury::RequestId action_idx = AIJury::makeRequestId(g_round, user->public_key.data, message, input_idx);
+                    process_game_message(user, action, data, action_idx, peer_count);
+                }
+            }
+            else
+            {
+                // Unknown message type
+                std::string error = "{\"type\":\"error\",\"error\":\"Unsupported message type\"}";
+                writeUserMessage(user, error);
+            }
+        }
+    }
+}
+
+// Main contract function
+// One contract round on an initialized HotPocket context; deinitializes it at the end
+static int runContractRound()
+{
+    std::cout << "=== AI GAME CONTRACT (DAEMON-BASED ARCHITECTURE) ===" << std::endl;
+    std::cout << "Starting AI Game Contract with daemon architecture..." << std::endl;
+
+    // Initialize user input
+    hp_init_user_input_mmap();
+
+    // Read-only rounds that only read game state skip all subsystem setup
+    const struct hp_contract_context *readCtx = hp_get_context();
+    if (readCtx && readCtx->readonly && serveReadOnlyRound(readCtx))
+    {
+        hp_deinit_user_input_mmap();
+        hp_deinit_contract();
+        return 0;
+    }
+
+    // Initialize systems (a contract worker keeps them from its earlier rounds)
+    if (!g_modelDownloader)
+    {
+        g_modelDownloader = std::make_unique<ModelDownloader>();
+        g_gameManager = std::make_unique<GameStateManager>();
+        g_aiClient = std::make_unique<AIServiceClient>();
+        g_gameEngineDaemonManager = std::make_unique<GameEngineDaemonManager>();
+
+        // Initialize Valuable Item Extractor for NFT generation
+        g_valuableItemExtractor = std::make_unique<ValuableItemExtractor>();
+        std::cout << "Valuable Item Extractor initialized for NFT generation" << std::endl;
+    }
+
+    // NFT Minting Client and AI Jury are created on first use (ensureNFTMintingClient / ensureAIJury)
 
     // Get contract context and peer count for consensus
     const struct hp_contract_context *ctx = hp_get_context();
@@ -2086,11 +4132,28 @@ int main(int argc, char **argv)
         std::cout << "No UNL peers found, using default peer_count = 1" << std::endl;
     }
     std::cout << "Final peer_count: " << peer_count << std::endl;
+    g_round = ctx->lcl_seq_no + 1;
+    g_leaderWaitDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(LEADER_WAIT_MS);
     std::cout << "=====================" << std::endl;
 
+    // Nothing of an earlier round's requests survives into this one, so a worker round
+    // sees the same state a fresh process would
+    if (g_aiJury)
+        g_aiJury->beginRound(g_round);
+    g_leaderStates.clear();
+    g_relayedNarratives.clear();
+    g_pendingTransitions.clearHeldResponses();
+    {
+        std::lock_guard<std::mutex> lock(g_outputMutex);
+        g_requestSlots.clear();
+    }
+
     // Initialize model downloading and daemon startup in non-readonly mode
     if (!ctx->readonly)
     {
+        // Index and snapshots for the read-only path (no-op once they exist)
+        g_gameManager->ensureSnapshots();
+
         // Use legacy-style chunked download pattern - downloads one chunk per contract execution
         std::cout << "==================== MODEL VERIFICATION ===================" << std::endl;
         bool model_ready = g_modelDownloader->ensureModelDownloaded();
@@ -2112,6 +4175,10 @@ int main(int argc, char **argv)
             {
                 std::cerr << "WARNING: Failed to start AI Daemon process" << std::endl;
             }
+
+            // Keep the jury daemon process up as well so it loads in the background;
+            // nothing here waits for its model
+            AIJury::startJuryDaemon();
         }
         else
         {
@@ -2129,7 +4196,26 @@ int main(int argc, char **argv)
     std::cout << "Contract initialization complete. Ready for user requests." << std::endl;
     std::cout << "===========================================" << std::endl;
 
-    // Process user messages
+    // A round with inputs sets up the jury here, before anything reads NPL: votes are
+    // dispatched under g_nplReadMutex and must not wait on the daemon start-up the lazy
+    // init may do. Without inputs (or carried-over transitions) there is no jury work.
+    bool roundHasInputs = false;
+    for (size_t u = 0; u < ctx->users.count; u++)
+        roundHasInputs = roundHasInputs || ctx->users.list[u].inputs.count > 0;
+    if (roundHasInputs)
+        ensureAIJury();
+
+    // Carried-over transitions are registered before any NPL read so their votes find them
+    if (!ctx->readonly && consensusPipelineMode())
+        restorePendingTransitions(ctx, peer_count);
+
+    // Generate all worlds requested this round in parallel before the per-input loop
+    pregenerateGameCreations(ctx);
+
+    // Process user messages. Inputs are scheduled per game (see RoundScheduler) and
+    // answered through per-input output slots, flushed below in user/input order.
+    std::deque<OutputSlot> outputSlots;
+    RoundScheduler scheduler;
     for (size_t u = 0; u < ctx->users.count; u++)
     {
         const struct hp_user *user = &ctx->users.list[u];
@@ -2143,415 +4229,279 @@ int main(int argc, char **argv)
             if (len > 0)
             {
                 std::string message(buf, len);
+                OutputSlot *slot = &outputSlots.emplace_back();
+                slot->user = user;
+                bool readonly = ctx->readonly;
+                scheduler.add(inputPartition(message), [=]()
+                              {
+                                  OutputSlotScope scope(slot);
+                                  process_user_input(user, input_idx, message, peer_count, readonly);
+                              });
+            }
+        }
+    }
+    scheduler.run(roundWorkerCount());
 
-                std::cout << "Received message: " << message << std::endl;
-
-                // Check what patterns are being found
-                bool foundStat = (message.find("\"type\":\"stat\"") != std::string::npos);
-                bool foundQuery = (message.find("\"type\":\"query\"") != std::string::npos);
-                std::cout << "Pattern search results: stat=" << foundStat << ", query=" << foundQuery << std::endl;
-
-                // Simple string-based message type detection
-                if (foundStat)
-                {
-                    std::cout << "=== DETECTED STAT MESSAGE ===" << std::endl;
-                    process_stat_message(user);
-                    std::cout << "=== STAT MESSAGE PROCESSING COMPLETE ===" << std::endl;
-                }
-                else if (foundQuery)
-                {
-                    std::cout << "=== DETECTED QUERY MESSAGE ===" << std::endl;
-                    if (!ctx->readonly)
-                    {
-                        // Better JSON parsing to match example.js behavior
-                        std::cout << "Processing query message: " << message << std::endl;
-
-                        // First check if data field exists
-                        size_t dataPos = message.find("\"data\":");
-                        if (dataPos == std::string::npos)
-                        {
-                            std::string error = "{\"type\":\"error\",\"error\":\"must provide a data field to query message\"}";
-                            hp_write_user_msg(user, error.c_str(), error.length());
-                            continue;
-                        }
+    // Narratives of two-phase turns that finished since they were recorded
+    if (!ctx->readonly && twoPhaseTurnMode())
+        deliverPendingNarratives(ctx, peer_count);
 
-                        // Find the data object content
-                        size_t dataValueStart = message.find(":", dataPos) + 1;
-                        // Skip whitespace
-                        while (dataValueStart < message.length() &&
-                               (message[dataValueStart] == ' ' || message[dataValueStart] == '\t' || message[dataValueStart] == '\n'))
-                        {
-                            dataValueStart++;
-                        }
+    // Handle NPL messages (votes from other nodes) - AI Jury only
+    // Wait up to 100ms for the first batch, then keep reading without waiting:
+    // one call handles at most HP_NPL_BATCH_MAX messages.
+    int nplTimeout = 100;
+    while (hp_read_npl_batch(dispatchNplMessage, &peer_count, nplTimeout) > 0)
+        nplTimeout = 0;
+    checkpointPendingTransitions(peer_count);
+
+    // Send every input's responses in user/input order. Only after the last NPL read:
+    // a consensus completed there answers into its input's slot.
+    {
+        std::lock_guard<std::mutex> lock(g_outputMutex);
+        g_requestSlots.clear(); // Anything answered from here on is written directly
+    }
+    for (const OutputSlot &slot : outputSlots)
+    {
+        for (const std::string &response : slot.messages)
+            hp_write_user_msg(slot.user, response.c_str(), response.length());
+    }
 
-                        // Check if data is null or empty
-                        if (dataValueStart >= message.length() ||
-                            message.substr(dataValueStart, 4) == "null" ||
-                            message.substr(dataValueStart, 9) == "undefined")
-                        {
-                            std::string error = "{\"type\":\"error\",\"error\":\"must provide a data field to query message\"}";
-                            hp_write_user_msg(user, error.c_str(), error.length());
-                            continue;
-                        }
+    // Cleanup
+    g_roundArena.reset();
+    hp_deinit_user_input_mmap();
+    hp_deinit_contract();
 
-                        // Handle data as string directly or data as object with query field
-                        std::string query;
+    return 0;
+}
 
-                        // Check if data starts with a quote (data is a string directly)
-                        if (message[dataValueStart] == '"')
-                        {
-                            // Case 1: {"type":"query","data":"actual query text"}
-                            size_t queryStart = dataValueStart + 1;
-                            size_t queryEnd = message.find("\"", queryStart);
-                            if (queryEnd != std::string::npos)
-                            {
-                                query = message.substr(queryStart, queryEnd - queryStart);
-                                std::cout << "Found query in data string: " << query << std::endl;
-                            }
-                        }
-                        else if (message[dataValueStart] == '{')
-                        {
-                            // Case 2: {"type":"query","data":{"query":"actual query text"}}
-                            size_t queryPos = message.find("\"query\":", dataPos);
-                            if (queryPos == std::string::npos)
-                            {
-                                // Try without quotes around query key
-                                queryPos = message.find("query:", dataPos);
-                            }
+// Persistent worker: serves the rounds shims hand over, one at a time, until killed.
+// Between rounds it stays in the node directory the socket lives in, outside the state
+// mount; during a round it works in the shim's directory.
+static int runContractWorker()
+{
+    std::error_code ec;
+    std::filesystem::path socketPath(CONTRACT_WORKER_SOCKET);
+    std::filesystem::path home = std::filesystem::canonical(socketPath.parent_path(), ec);
+    if (ec || chdir(home.c_str()) != 0)
+        return 1;
+    const std::string socketName = socketPath.filename().string();
+    const std::string socketFullPath = (home / socketName).string();
 
-                            if (queryPos != std::string::npos)
-                            {
-                                // Extract the query value from object
-                                size_t queryValueStart = message.find(":", queryPos) + 1;
-                                // Skip whitespace
-                                while (queryValueStart < message.length() &&
-                                       (message[queryValueStart] == ' ' || message[queryValueStart] == '\t' || message[queryValueStart] == '\n'))
-                                {
-                                    queryValueStart++;
-                                }
+    int logFd = open(std::filesystem::path(CONTRACT_WORKER_LOG).filename().c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (logFd >= 0)
+    {
+        dup2(logFd, STDOUT_FILENO);
+        dup2(logFd, STDERR_FILENO);
+        close(logFd);
+    }
+    signal(SIGPIPE, SIG_IGN); // A user or peer gone mid-round must not end the worker
+    signal(SIGCHLD, SIG_IGN); // Daemons started here are reaped, not left as zombies
 
-                                if (queryValueStart < message.length() && message[queryValueStart] == '"')
-                                {
-                                    // Quoted string
-                                    size_t queryStart = queryValueStart + 1;
-                                    size_t queryEnd = message.find("\"", queryStart);
-                                    if (queryEnd != std::string::npos)
-                                    {
-                                        query = message.substr(queryStart, queryEnd - queryStart);
-                                        std::cout << "Found query in data object: " << query << std::endl;
-                                    }
-                                }
-                            }
-                        }
-                        else
-                        {
-                            // Case 3: data is unquoted value
-                            size_t queryEnd = message.find_first_of(",}", dataValueStart);
-                            if (queryEnd != std::string::npos)
-                            {
-                                query = message.substr(dataValueStart, queryEnd - dataValueStart);
-                                // Trim whitespace
-                                query.erase(0, query.find_first_not_of(" \t\n"));
-                                query.erase(query.find_last_not_of(" \t\n") + 1);
-                                std::cout << "Found query as unquoted data: " << query << std::endl;
-                            }
-                        }
+    const std::string binary = ContractWorker::binaryIdentity();
+    int listener = ContractWorker::listenOn(socketName);
+    if (listener < 0)
+    {
+        std::cerr << "[Worker] Cannot listen on " << socketFullPath << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+    std::cout << "[Worker] Contract worker " << getpid() << " listening on " << socketFullPath << std::endl;
 
-                        if (query.empty())
-                        {
-                            std::string error = "{\"type\":\"error\",\"error\":\"query field cannot be empty\"}";
-                            hp_write_user_msg(user, error.c_str(), error.length());
-                            continue;
-                        }
+    while (true)
+    {
+        int conn = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (conn < 0)
+        {
+            if (errno != EINTR)
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            continue;
+        }
 
-                        std::cout << "Extracted query: " << query << std::endl;
-                        // Use AI Jury for query processing
-                        if (g_aiJury)
-                        {
-                            // Generate unique request ID for this query
-                            static int query_request_id = 10000; // Start high to avoid conflicts with game actions
-                            int current_request_id = query_request_id++;
+        ContractWorker::Round round;
+        if (!ContractWorker::receiveRound(conn, round))
+        {
+            std::cerr << "[Worker] Incomplete round hand-off - ignored" << std::endl;
+            close(conn);
+            continue;
+        }
 
-                            g_aiJury->processRequest(user, "validate_query", query, current_request_id, peer_count, "query_interface_context");
-                            waitForJuryConsensus(current_request_id, peer_count);
-                        }
-                        else
-                        {
-                            std::string response = "{\"type\":\"queryResult\",\"result\":\"AI Jury not available\"}";
-                            hp_write_user_msg(user, response.c_str(), response.length());
-                        }
-                    }
-                    else
-                    {
-                        std::string error = "{\"type\":\"error\",\"error\":\"query interface must not be read only\"}";
-                        hp_write_user_msg(user, error.c_str(), error.length());
-                    }
-                }
-                else
-                {
-                    // Check if it's a JSON game message format
-                    bool isJsonGameMessage = false;
-                    std::string gameAction;
-                    std::string gameData;
+        // The contract binary was replaced since this worker started: a newer shim must not
+        // have its round run by old code. Stop listening before refusing, so the shim
+        // starts a worker of its own build.
+        if (round.binary != binary)
+        {
+            std::cout << "[Worker] Contract binary changed - handing over to a new worker" << std::endl;
+            for (int fd : round.fds)
+                close(fd);
+            unlink(socketFullPath.c_str());
+            close(listener);
+            ContractWorker::sendAccepted(conn, false);
+            close(conn);
+            return 0;
+        }
 
-                    // Try to parse as JSON game message first
-                    if (message.front() == '{' && message.back() == '}')
-                    {
-                        // Check for game action fields
-                        if (message.find("\"create_game\"") != std::string::npos)
-                        {
-                            gameAction = "create_game";
-                            size_t actionPos = message.find("\"create_game\":");
-                            if (actionPos != std::string::npos)
+        int status = 1;
+        if (chdir(round.cwd.c_str()) != 0 || hp_init_contract_args(round.args.data(), round.args.size()) != 0)
+        {
+            std::cerr << "[Worker] Cannot enter round in " << round.cwd << std::endl;
+            for (int fd : round.fds)
+                close(fd);
+            ContractWorker::sendAccepted(conn, false);
+            close(conn);
+            chdir(home.c_str());
+            continue;
+        }
+        hp_remap_contract_fds(round.from.data(), round.fds.data(), round.fds.size());
+        ContractWorker::sendAccepted(conn, true);
+
+        // A round whose process Hot Pocket killed (timeout) must not go on writing state
+        // behind the next round. Nothing can be cut short safely inside the round, so the
+        // worker ends as the round process would have; the next shim starts a new one.
+        std::atomic<bool> roundDone{false};
+        std::thread watcher([conn, &roundDone, &socketFullPath]()
                             {
-                                size_t valueStart = message.find(":", actionPos) + 1;
-                                while (valueStart < message.length() &&
-                                       (message[valueStart] == ' ' || message[valueStart] == '\t' || message[valueStart] == '\n'))
-                                {
-                                    valueStart++;
-                                }
-                                if (valueStart < message.length() && message[valueStart] == '"')
+                                while (!roundDone)
                                 {
-                                    size_t dataStart = valueStart + 1;
-                                    size_t dataEnd = message.find("\"", dataStart);
-                                    if (dataEnd != std::string::npos)
+                                    pollfd pfd{conn, POLLRDHUP, 0};
+                                    if (poll(&pfd, 1, 200) > 0 && (pfd.revents & (POLLRDHUP | POLLHUP | POLLERR)))
                                     {
-                                        gameData = message.substr(dataStart, dataEnd - dataStart);
-                                        isJsonGameMessage = true;
+                                        std::cerr << "[Worker] Round process gone - abandoning round " << g_round << std::endl;
+                                        unlink(socketFullPath.c_str());
+                                        _exit(1);
                                     }
-                                }
-                            }
-                        }
-                        else if (message.find("\"game_id\"") != std::string::npos && message.find("\"action\"") != std::string::npos)
-                        {
-                            gameAction = "player_action";
-                            // Extract game_id, action, and continue_conversation from JSON format: {"game_id": "id", "action": "text", "continue_conversation": "true"}
-                            size_t gameIdPos = message.find("\"game_id\":");
-                            size_t actionPos = message.find("\"action\":");
-                            size_t continuePos = message.find("\"continue_conversation\":");
+                                } });
+
+        auto started = std::chrono::steady_clock::now();
+        status = runContractRound();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+        roundDone = true;
+        watcher.join();
+        chdir(home.c_str());
+        std::cout << "[Worker] Round " << g_round << " finished in " << elapsed.count() << "ms (status " << status << ")" << std::endl;
+        ContractWorker::sendStatus(conn, status);
+        close(conn);
+    }
+}
 
-                            if (gameIdPos != std::string::npos && actionPos != std::string::npos)
-                            {
-                                // Extract game_id
-                                size_t gameIdValueStart = message.find(":", gameIdPos) + 1;
-                                while (gameIdValueStart < message.length() &&
-                                       (message[gameIdValueStart] == ' ' || message[gameIdValueStart] == '\t' || message[gameIdValueStart] == '\n'))
-                                {
-                                    gameIdValueStart++;
-                                }
-                                if (gameIdValueStart < message.length() && message[gameIdValueStart] == '"')
-                                {
-                                    size_t gameIdStart = gameIdValueStart + 1;
-                                    size_t gameIdEnd = message.find("\"", gameIdStart);
+// Start the worker as a detached process that holds none of this round's fds
+static void spawnContractWorker()
+{
+    pid_t pid = fork();
+    if (pid != 0)
+    {
+        if (pid > 0)
+            waitpid(pid, nullptr, 0);
+        return;
+    }
 
-                                    // Extract action
-                                    size_t actionValueStart = message.find(":", actionPos) + 1;
-                                    while (actionValueStart < message.length() &&
-                                           (message[actionValueStart] == ' ' || message[actionValueStart] == '\t' || message[actionValueStart] == '\n'))
-                                    {
-                                        actionValueStart++;
-                                    }
-                                    if (actionValueStart < message.length() && message[actionValueStart] == '"')
-                                    {
-                                        size_t actionStart = actionValueStart + 1;
-                                        size_t actionEnd = message.find("\"", actionStart);
+    // Double fork: the worker is orphaned at once and never waited on by a round
+    setsid();
+    if (fork() != 0)
+        _exit(0);
+    int devNull = open("/dev/null", O_RDWR);
+    if (devNull >= 0)
+        dup2(devNull, STDIN_FILENO);
+    for (int fd = STDERR_FILENO + 1; fd < 1024; fd++)
+        close(fd);
+    execl("/proc/self/exe", "ai_contract_worker", "--worker", (char *)nullptr);
+    _exit(1);
+}
 
-                                        if (gameIdEnd != std::string::npos && actionEnd != std::string::npos)
-                                        {
-                                            std::string gameId = message.substr(gameIdStart, gameIdEnd - gameIdStart);
-                                            std::string action = message.substr(actionStart, actionEnd - actionStart);
-                                            
-                                            // Extract continue_conversation if present
-                                            std::string continueConversation = "false"; // default value
-                                            if (continuePos != std::string::npos)
-                                            {
-                                                size_t continueValueStart = message.find(":", continuePos) + 1;
-                                                while (continueValueStart < message.length() &&
-                                                       (message[continueValueStart] == ' ' || message[continueValueStart] == '\t' || message[continueValueStart] == '\n'))
-                                                {
-                                                    continueValueStart++;
-                                                }
-                                                if (continueValueStart < message.length() && message[continueValueStart] == '"')
-                                                {
-                                                    size_t continueStart = continueValueStart + 1;
-                                                    size_t continueEnd = message.find("\"", continueStart);
-                                                    if (continueEnd != std::string::npos)
-                                                    {
-                                                        continueConversation = message.substr(continueStart, continueEnd - continueStart);
-                                                    }
-                                                }
-                                            }
-                                            
-                                            gameData = gameId + ":" + action + ":" + continueConversation;
-                                            isJsonGameMessage = true;
-                                            std::cout << "Parsed player action - Game ID: " << gameId << ", Action: " << action << ", Continue: " << continueConversation << std::endl;
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                        else if (message.find("\"list_games\"") != std::string::npos)
-                        {
-                            gameAction = "list_games";
-                            gameData = "";
-                            isJsonGameMessage = true;
-                        }
-                        else if (message.find("\"get_game_state\"") != std::string::npos)
-                        {
-                            gameAction = "get_game_state";
-                            size_t actionPos = message.find("\"get_game_state\":");
-                            if (actionPos != std::string::npos)
-                            {
-                                size_t valueStart = message.find(":", actionPos) + 1;
-                                while (valueStart < message.length() &&
-                                       (message[valueStart] == ' ' || message[valueStart] == '\t' || message[valueStart] == '\n'))
-                                {
-                                    valueStart++;
-                                }
-                                if (valueStart < message.length() && message[valueStart] == '"')
-                                {
-                                    size_t dataStart = valueStart + 1;
-                                    size_t dataEnd = message.find("\"", dataStart);
-                                    if (dataEnd != std::string::npos)
-                                    {
-                                        gameData = message.substr(dataStart, dataEnd - dataStart);
-                                        isJsonGameMessage = true;
-                                    }
-                                }
-                            }
-                        }
-                        else if (message.find("\"mint_nft\"") != std::string::npos)
-                        {
-                            gameAction = "mint_nft";
-                            size_t actionPos = message.find("\"mint_nft\":");
-                            if (actionPos != std::string::npos)
-                            {
-                                size_t valueStart = message.find(":", actionPos) + 1;
-                                while (valueStart < message.length() &&
-                                       (message[valueStart] == ' ' || message[valueStart] == '\t' || message[valueStart] == '\n'))
-                                {
-                                    valueStart++;
-                                }
-                                if (valueStart < message.length() && message[valueStart] == '"')
-                                {
-                                    size_t dataStart = valueStart + 1;
-                                    size_t dataEnd = message.find("\"", dataStart);
-                                    if (dataEnd != std::string::npos)
-                                    {
-                                        gameData = message.substr(dataStart, dataEnd - dataStart);
-                                        isJsonGameMessage = true;
-                                    }
-                                }
-                            }
-                        }
-                    }
+// A connection to a listening worker, started when there is none
+static int connectContractWorker()
+{
+    int sock = ContractWorker::connectTo(CONTRACT_WORKER_SOCKET);
+    if (sock >= 0)
+        return sock;
+
+    std::cout << "[Worker] No contract worker - starting one" << std::endl;
+    std::cout.flush();
+    spawnContractWorker();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(CONTRACT_WORKER_START_MS);
+    while (sock < 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        sock = ContractWorker::connectTo(CONTRACT_WORKER_SOCKET);
+    }
+    return sock;
+}
 
-                    if (isJsonGameMessage)
-                    {
-                        std::cout << "=== DETECTED JSON GAME MESSAGE ===" << std::endl;
-                        std::cout << "Game Action: " << gameAction << std::endl;
-                        std::cout << "Game Data: " << gameData << std::endl;
+// Shim side: hand the round to the worker (starting it when none is listening, or when
+// the one listening runs another contract build) and wait for its status. False, with
+// the context still initialized, when the round was not handed over and must run in
+// this process.
+static bool delegateRound(int &status)
+{
+    // Each channel once, and only open ones (NPL is absent in some rounds)
+    std::vector<int> all(hp_get_contract_fds(nullptr, 0));
+    hp_get_contract_fds(all.data(), all.size());
+    std::vector<int> fds;
+    for (int fd : all)
+    {
+        if (fd >= 0 && std::find(fds.begin(), fds.end(), fd) == fds.end())
+            fds.push_back(fd);
+    }
 
-                        // Process game action with AI validation consensus
-                        int action_idx = static_cast<int>(u * 1000 + input_idx);
-                        process_game_message(user, gameAction, gameData, action_idx, peer_count);
-                    }
-                    else
-                    {
-                        // Fall back to colon-separated format: "action:data"
-                        size_t colonPos = message.find(":");
-                        if (colonPos != std::string::npos)
-                        {
-                            std::string action = message.substr(0, colonPos);
-                            std::string data = message.substr(colonPos + 1);
+    std::error_code ec;
+    std::string cwd = std::filesystem::current_path(ec).string();
+    uint64_t round = hp_get_context()->lcl_seq_no + 1;
 
-                            if (action == "stat")
-                            {
-                                process_stat_message(user);
-                            }
-                            else
-                            {
-                                // Process game action with AI validation consensus
-                                // Use a unique action index for each user input
-                                int action_idx = static_cast<int>(u * 1000 + input_idx);
-                                process_game_message(user, action, data, action_idx, peer_count);
-                            }
-                        }
-                        else
-                        {
-                            // Unknown message type
-                            std::string error = "{\"type\":\"error\",\"error\":\"Unsupported message type\"}";
-                            hp_write_user_msg(user, error.c_str(), error.length());
-                        }
-                    }
-                }
-            }
+    int sock = -1;
+    for (int attempt = 0; attempt < 2 && sock < 0; attempt++)
+    {
+        sock = connectContractWorker();
+        if (sock < 0)
+            return false;
+        if (!ContractWorker::sendRound(sock, cwd, g_contractArgs, fds) || !ContractWorker::receiveAccepted(sock))
+        {
+            // Refused (an outdated worker, which exits) or cut off - the fds stay ours
+            close(sock);
+            sock = -1;
         }
     }
+    if (sock < 0)
+        return false;
 
-    // Handle NPL messages (votes from other nodes) - AI Jury only
-    char sender[HP_PUBLIC_KEY_SIZE];
-    char *npl_msg = (char *)malloc(HP_NPL_MSG_MAX_SIZE);
-
-    // Check for incoming NPL messages with short timeout
-    const int npl_len = hp_read_npl_msg(npl_msg, sender, 100); // 100ms timeout
-    if (npl_len > 0)
+    // The worker holds the channels now; this process must not keep any of them open
+    hp_deinit_contract();
+    bool answered = ContractWorker::receiveStatus(sock, status);
+    close(sock);
+    if (!answered)
     {
-        std::string msgJson(npl_msg, npl_len);
-
-        try {
-            nlohmann::json nplMessage = nlohmann::json::parse(msgJson);
-            
-            // COMMENTED OUT NFT COORDINATION - READ-ONLY MODE ONLY
-            // Check for NFT coordination messages (completely separate system)
-            // if (nplMessage.contains("type") && nplMessage["type"] == "nft_coordination") {
-            //     processNFTCoordinationMessage(msgJson, sender);
-            // }
-            // Check for AI Jury votes (separate system)
-            if (nplMessage.contains("requestId")) {
-                // This is an AI Jury vote - process in main try block
-                process_jury_vote(msgJson, peer_count);
-            }
-            else if (nplMessage.contains("type") && nplMessage["type"] == "nft_coordination") {
-                std::cout << "[NPL] IGNORED: NFT coordination disabled - read-only mode only" << std::endl;
-            }
-            else {
-                std::cout << "[NPL] IGNORED: Unknown message format: " << msgJson.substr(0, 100) << "..." << std::endl;
-            }
-        } catch (const std::exception& e) {
-            // Fallback for JSON parsing errors only - use string search as last resort
-            std::cout << "[NPL] JSON parse failed, attempting string-based detection: " << e.what() << std::endl;
-            
-            if (msgJson.find("\"requestId\":") != std::string::npos) {
-                // Fallback: This is likely an AI Jury vote with malformed JSON
-                std::cout << "[NPL] Fallback: Processing as AI Jury vote" << std::endl;
-                process_jury_vote(msgJson, peer_count);
-            } else if (msgJson.find("\"type\":\"nft_coordination\"") != std::string::npos) {
-                // COMMENTED OUT NFT COORDINATION - READ-ONLY MODE ONLY
-                // Fallback: This is likely an NFT coordination message with malformed JSON
-                // std::cout << "[NPL] Fallback: Processing as NFT coordination message" << std::endl;
-                // processNFTCoordinationMessage(msgJson, sender);
-                std::cout << "[NPL] IGNORED: NFT coordination disabled - read-only mode only" << std::endl;
-            } else {
-                std::cout << "[NPL] IGNORED: Cannot identify message type even with string search: " << msgJson.substr(0, 100) << "..." << std::endl;
-            }
-        }
+        std::cerr << "[Worker] Contract worker exited during round " << round << std::endl;
+        status = 1;
     }
+    return true;
+}
 
-    free(npl_msg);
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::string(argv[1]) == "--worker")
+        return runContractWorker();
 
-    // Cleanup
-    hp_deinit_user_input_mmap();
-    hp_deinit_contract();
+    // Initialize HotPocket contract
+    char *args = nullptr;
+    size_t argsLen = 0;
+    if (hp_read_contract_args(&args, &argsLen) != 0 || hp_init_contract_args(args, argsLen) != 0)
+    {
+        free(args);
+        std::cerr << "Failed to initialize HotPocket contract." << std::endl;
+        return 1;
+    }
+    g_contractArgs.assign(args, argsLen);
+    free(args);
 
-    return 0;
+    // Consensus rounds go to the persistent worker. Read-only instances, which Hot Pocket
+    // runs alongside rounds, stay in their own process.
+    const struct hp_contract_context *ctx = hp_get_context();
+    int status = 0;
+    if (contractWorkerMode() && !ctx->readonly && delegateRound(status))
+        return status;
+
+    return runContractRound();
 }
 
 void waitForGameConsensus(int action_idx, int peer_count)
 {
-    char sender[HP_PUBLIC_KEY_SIZE];
-    char *npl_msg = (char *)malloc(HP_NPL_MSG_MAX_SIZE);
-
     std::cout << "=== WAITING FOR CONSENSUS (AI JURY ONLY) ===" << std::endl;
     std::cout << "Action index: " << action_idx << ", Peer count: " << peer_count << std::endl;
 
@@ -2559,24 +4509,10 @@ void waitForGameConsensus(int action_idx, int peer_count)
     // This function remains for compatibility but only processes AI Jury votes
     
     // Brief check for any AI Jury votes that might come through this path
-    const int npl_len = hp_read_npl_msg(npl_msg, sender, 100); // Short timeout
-    if (npl_len > 0)
-    {
-        std::string voteJson(npl_msg, npl_len);
-        std::cout << "Received vote: " << voteJson.substr(0, 100) << "..." << std::endl;
+    // (only AI Jury votes are processed; legacy vote formats are ignored)
+    int nplTimeout = 100; // Short timeout for the first batch only
+    while (hp_read_npl_batch(dispatchNplMessage, &peer_count, nplTimeout) > 0)
+        nplTimeout = 0;
 
-        // Only process AI Jury votes now
-        if (voteJson.find("\"requestId\":") != std::string::npos)
-        {
-            std::cout << "Processing AI Jury vote through legacy path" << std::endl;
-            process_jury_vote(voteJson, peer_count);
-        }
-        else
-        {
-            std::cout << "IGNORED: Legacy vote format no longer supported" << std::endl;
-        }
-    }
-
-    free(npl_msg);
     std::cout << "=== LEGACY CONSENSUS WAIT COMPLETE ===" << std::endl;
 }
@@ -17,9 +17,24 @@
 #include <fstream>
 #include <cstring>
 #include <cstdlib>
+#include <cctype>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <random>
 #include <nlohmann/json.hpp>
 #include "../llama.cpp/common/common.h"
 #include "../llama.cpp/include/llama.h"
+#include "stop_sequence_matcher.h"
+#include "prompt_token_cache.h"
+#include "request_scheduler.h"
+#include "request_deadline.h"
+#include "world_pool.h"
+#include "semantic_action_cache.h"
+#include "world_blob_cache.h"
+#include "chat_template.h"
+#include "narrative_tickets.h"
+#include "ai_service_client.h"
 
 // Global flags
 static std::atomic<bool> g_shutdown_requested{false};
@@ -32,6 +47,272 @@ void signal_handler(int signal)
     g_shutdown_requested = true;
 }
 
+// Structural stop sequences for player state generation; the model's end-of-turn
+// texts (ChatFrame::stops) follow the state marker
+enum PlayerStateStop
+{
+    STOP_END_PLAYER_STATE = 0,
+    STOP_END_OF_TURN = 1
+};
+
+// Static prompt fragments - wrapped in the model's chat framing (ChatFrame) and tokenized
+// once per model tier at load time by PromptTokenCache; prompts are assembled by
+// concatenating fragment tokens with the per-request text tokens
+enum PromptFragment
+{
+    FRAGMENT_ACTION_PREFIX = 0,
+    FRAGMENT_ACTION_STATE_HEADER,
+    FRAGMENT_ACTION_ACTION_HEADER,
+    FRAGMENT_ACTION_SUFFIX,
+    FRAGMENT_CONTINUE_PREFIX,
+    FRAGMENT_CONTINUE_SUFFIX,
+    FRAGMENT_CREATE_PREFIX,
+    FRAGMENT_CREATE_SUFFIX,
+    FRAGMENT_NARRATIVE_PREFIX,
+    FRAGMENT_NARRATIVE_STATE_HEADER,
+    FRAGMENT_NARRATIVE_RESULT_HEADER,
+    FRAGMENT_NARRATIVE_SUFFIX
+};
+
+static const std::string PLAYER_ACTION_SYSTEM_PROMPT =
+    "You are a game state processor. Process player actions and return ONLY the updated player state in the exact format specified. Use this format for subsequent entire conversation thread. "
+    "STRICTLY Do not PRODUCE explanations, reasoning, or any other text. Replace bracketed placeholders with actual values based on the action and game rules."
+    "IMPORTANT: If player repeats an action or similar action send the same updated state again without changes.";
+
+// Initial-mode player action prompt, a user message under PLAYER_ACTION_SYSTEM_PROMPT:
+// PREFIX + <game world> + STATE_HEADER + <player state> + ACTION_HEADER + <action> + SUFFIX
+static const std::string PLAYER_ACTION_PREFIX = "GAME WORLD:\n";
+
+static const std::string PLAYER_ACTION_STATE_HEADER = "\n\nCURRENT PLAYER STATE:\n";
+
+static const std::string PLAYER_ACTION_ACTION_HEADER = "\n\nPLAYER ACTION: ";
+
+static const std::string PLAYER_ACTION_SUFFIX =
+    "\n\n"
+    "Return the updated player state in this exact format below:\n"
+
+    "<<BEGIN_PLAYER_STATE>>\n"
+
+    "Player_Location: [location_name]\n"
+    "Player_Health: [number]\n"
+    "Player_Score: [number]\n"
+    "Player_Inventory: [list]\n"
+    "Game_Status: [active/won/lost]\n"
+    "Messages: [\"A narrative of what happens and should be immersive and provides good game play experience\"]\n"
+    "Turn_Count: [number]\n"
+
+    "<<END_PLAYER_STATE>>";
+
+// Continuation prompt, the next user turn: CONTINUE_PREFIX + <action> + CONTINUE_SUFFIX,
+// with the answer opened at the state marker
+static const std::string CONTINUE_PREFIX = "Player Action: ";
+
+static const std::string CONTINUE_SUFFIX = "\n\nUpdate the player state:";
+
+static const std::string CONTINUE_ANSWER_START = "<<BEGIN_PLAYER_STATE>>\n";
+
+// Turns answered outside the conversation (small tier, action cache, two-phase) are
+// replayed into the next continuation turn ahead of its action, up to this many; beyond
+// that the conversation is rebuilt instead
+static constexpr size_t MAX_MISSED_TURNS = 8;
+static const std::string MISSED_TURNS_STATE = "\n\nPlayer state after these actions:\n";
+
+// Two-phase turns ("narrative":"deferred"): the initial-mode prompt answered under this
+// grammar - the state fields only, with an empty Messages list - so the structured state
+// is a short generation. The narrative follows from a background job (see NARRATIVE_*).
+static const char *STRUCTURED_STATE_GRAMMAR = R"GBNF(
+root      ::= "<<BEGIN_PLAYER_STATE>>\n" location health score inventory status "Messages: []\n" turn "<<END_PLAYER_STATE>>"
+location  ::= "Player_Location: " [^\n\[\]]+ "\n"
+health    ::= "Player_Health: " number "\n"
+score     ::= "Player_Score: " number "\n"
+inventory ::= "Player_Inventory: [" [^\n\]]* "]\n"
+status    ::= "Game_Status: " ("active" | "won" | "lost") "\n"
+turn      ::= "Turn_Count: " number "\n"
+number    ::= "-"? [0-9]+
+)GBNF";
+
+// Narrative of a two-phase turn, a user message without system prompt:
+// PREFIX + <game world> + STATE_HEADER + <state before> + ACTION_HEADER + <action>
+// + RESULT_HEADER + <structured state after> + SUFFIX
+static const std::string NARRATIVE_PREFIX = "You narrate a text adventure game.\n\nGAME WORLD:\n";
+
+static const std::string NARRATIVE_STATE_HEADER = "\n\nPLAYER STATE BEFORE THE TURN:\n";
+
+static const std::string NARRATIVE_RESULT_HEADER = "\n\nPLAYER STATE AFTER THE TURN:\n";
+
+static const std::string NARRATIVE_SUFFIX =
+    "\n\n"
+    "In two or three immersive sentences addressed to the player as \"you\", describe what happens on this turn. "
+    "The description must agree with the state after the turn. Reply with the description only.";
+
+// Reasoning effort requested from models that take one (harmony system turn)
+static const char *REASONING_EFFORT = "low";
+
+// Game creation prompt, a user message without system prompt: CREATE_PREFIX + <user request> + CREATE_SUFFIX
+static const std::string CREATE_PREFIX =
+    "Create a complete structured game world for a hybrid AI-governed gaming system. This must be compatible with rule-based processing.\n\n"
+
+    "REQUIRED FORMAT (follow exactly):\n\n"
+
+    "Game Title: [Engaging title]\n\n"
+
+    "World Description: [2-3 sentences describing setting and atmosphere]\n\n"
+
+    "World Lore: [1-2 sentences of background that affects gameplay]\n\n"
+
+    "Objectives: [Primary goal - clear and achievable]\n\n"
+
+    "Win Conditions: [Specific conditions to win]\n\n"
+
+    "Valid Actions: MOVE [direction], EXAMINE [object], TAKE [item], USE [item], TALK [character], ATTACK [target], CAST [spell], OPEN [container]\n\n"
+
+    "Locations:\n"
+    "- [Location 1]: [Description]. Exits: [directions]. Items: [list]. NPCs: [list]\n"
+    "- [Location 2]: [Description]. Exits: [directions]. Items: [list]. NPCs: [list]\n"
+    "- [Add 3-5 connected locations]\n\n"
+
+    "Items:\n"
+    "- [Item 1]: [Description and properties]\n"
+    "- [Item 2]: [Description and properties]\n"
+    "- [Add key items for objectives]\n\n"
+
+    "Game Rules:\n"
+    "- [Rule about movement/exploration]\n"
+    "- [Rule about items/inventory]\n"
+    "- [Rule about winning/losing]\n\n"
+
+    "Starting Location: [Location name]\n\n"
+
+    "Starting Inventory: [List starting items]\n\n"
+
+    "Starting Health: [Number/100]\n\n"
+
+    "Current Situation: [Opening scenario that sets the stage]\n\n"
+
+    "User request: ";
+
+static const std::string CREATE_SUFFIX =
+    "\n\n"
+    "CRITICAL: Follow the exact format above. Create a world that supports structured rule-based gameplay with bounded actions.";
+
+// Upper bound on worlds generated together by create_game_batch (parallel sequences per
+// context), shared with the client that splits batches
+static const size_t MAX_CREATE_BATCH = AIServiceClient::MAX_CREATE_BATCH;
+
+// Ping response snapshot read by read-only contract rounds (next to the PID file)
+static const char *STATUS_FILE = "../../../ai_daemon.status";
+
+// Hot model swap: a daemon told to retire finishes the requests it already accepted for up
+// to this long (past the contract's generation timeout) before it exits
+static const int RETIRE_DRAIN_MS = 200000;
+
+// Model tiers hosted by the daemon - the small model serves simple bounded turns,
+// the large model serves game creation and creative free-form actions
+enum class ModelTier
+{
+    Small,
+    Large
+};
+
+// Route a player action to a model tier based on its leading verb.
+// Short MOVE/TAKE/EXAMINE style commands only need the rules applied, so the
+// small model handles them; anything else is treated as creative input.
+static ModelTier routePlayerAction(const std::string &action)
+{
+    static const std::vector<std::string> simple_verbs = {
+        "MOVE", "GO", "WALK", "RUN", "TAKE", "GET", "GRAB", "PICK",
+        "EXAMINE", "LOOK", "INSPECT", "INVENTORY", "NORTH", "SOUTH", "EAST", "WEST"};
+
+    std::vector<std::string> words;
+    std::string word;
+    for (char c : action)
+    {
+        if (std::isspace(static_cast<unsigned char>(c)))
+        {
+            if (!word.empty())
+            {
+                words.push_back(word);
+                word.clear();
+            }
+        }
+        else
+        {
+            word += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    if (!word.empty())
+    {
+        words.push_back(word);
+    }
+
+    // Long commands are free-form even when they start with a simple verb
+    if (words.empty() || words.size() > 4)
+    {
+        return ModelTier::Large;
+    }
+
+    return std::find(simple_verbs.begin(), simple_verbs.end(), words[0]) != simple_verbs.end()
+               ? ModelTier::Small
+               : ModelTier::Large;
+}
+
+// Structural check used to decide whether a small-model turn must be escalated:
+// both state markers present in order and the mandatory state fields between them
+static bool isStructuredPlayerState(const std::string &response)
+{
+    size_t begin = response.rfind("<<BEGIN_PLAYER_STATE>>");
+    if (begin == std::string::npos)
+    {
+        return false;
+    }
+    size_t end = response.find("<<END_PLAYER_STATE>>", begin);
+    if (end == std::string::npos)
+    {
+        return false;
+    }
+
+    static const char *required_fields[] = {"Player_Location:", "Player_Health:", "Player_Inventory:",
+                                            "Game_Status:", "Turn_Count:"};
+    for (const char *field : required_fields)
+    {
+        size_t pos = response.find(field, begin);
+        if (pos == std::string::npos || pos > end)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Themes kept in the pre-generated world pool. A create_game prompt is served from
+// the pool when all its content words are keywords of one of these themes.
+static const std::vector<WorldTheme> &worldPoolThemes()
+{
+    static const std::vector<WorldTheme> themes = {
+        {"fantasy", "A classic fantasy adventure with a castle, an enchanted forest and a dragon",
+         {"fantasy", "magic", "magical", "medieval", "castle", "dragon", "dragons", "wizard", "forest", "knight", "enchanted", "sword"}},
+        {"scifi", "A science fiction adventure aboard an abandoned space station",
+         {"scifi", "sci", "fi", "science", "fiction", "space", "spaceship", "station", "alien", "aliens", "robot", "robots", "future", "futuristic", "planet"}},
+        {"horror", "A horror adventure in a haunted mansion",
+         {"horror", "haunted", "ghost", "ghosts", "spooky", "scary", "mansion", "zombie", "zombies", "creepy"}},
+        {"mystery", "A detective mystery in a foggy city",
+         {"mystery", "detective", "murder", "crime", "noir", "clue", "clues", "investigation"}},
+        {"pirate", "A pirate adventure hunting for buried treasure on a tropical island",
+         {"pirate", "pirates", "treasure", "island", "ship", "sea", "ocean", "tropical"}}};
+    return themes;
+}
+
+// A generated world is only pooled when it has both the world and the state sections
+// the contract separates on
+static bool isCompleteWorld(const std::string &response)
+{
+    if (response.empty() || response.rfind("{\"error\"", 0) == 0)
+        return false;
+    std::string lower = response;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower.find("game title:") != std::string::npos && lower.find("current situation:") != std::string::npos;
+}
+
 class AIDaemon
 {
 private:
@@ -39,6 +320,13 @@ private:
     int server_socket = -1;
     int port = 8765; // TCP port instead of socket file
 
+    // Hot model swap: a standby daemon loads on another port and leaves the PID and status
+    // files and the world pool to the serving daemon until it is activated; the daemon it
+    // replaces is then retired and hands its narrative tickets to the successor
+    std::atomic<bool> standby{false};
+    std::atomic<bool> retiring{false};
+    std::atomic<int> successor_port{0};
+
     // AI Model components
     llama_model *model = nullptr;
     std::string model_path;
@@ -46,19 +334,77 @@ private:
     std::atomic<bool> model_loading{false};
     std::string model_error = "";
 
+    // Small model tier (optional) - used for simple verb-matched turns
+    llama_model *small_model = nullptr;
+    std::string small_model_path;
+    std::atomic<bool> small_model_loaded{false};
+    std::string small_model_error = "";
+    std::atomic<int> small_tier_turns{0};
+    std::atomic<int> small_tier_escalations{0};
+
+    // Pre-tokenized prompt fragments and cached world tokens, one cache per model vocabulary
+    PromptTokenCache large_prompt_cache;
+    PromptTokenCache small_prompt_cache;
+
+    // Chat framing from each model's own template, and the stop sequences it implies
+    ChatFrame large_chat;
+    ChatFrame small_chat;
+    std::unique_ptr<StopSequenceMatcher> large_stop_matcher;
+    std::unique_ptr<StopSequenceMatcher> small_stop_matcher;
+
     // Conversation continuity components
     llama_context *persistent_ctx = nullptr;
     llama_sampler *persistent_sampler = nullptr;
     std::atomic<bool> conversation_active{false};
     int conversation_position = 0; // Track position in context for continuation
+    std::vector<std::string> missed_turn_actions; // Turns the conversation has not seen yet
+    std::string missed_turn_state;                // Player state after the last of them
 
     // Heartbeat for debugging
     std::atomic<bool> heartbeat_running{true};
     std::thread heartbeat_thread;
 
+    // Priority work queue - per-class {max concurrent, max queued}. Player actions and
+    // conversation resets share the single persistent context, so they run one at a time.
+    RequestScheduler scheduler{{{
+        {4, 64}, // ping / status
+        {4, 32}, // lookup - narrative lookups, which wait up to 5 s for a narrative
+        {1, 1},  // validate (served by the jury daemon)
+        {1, 16}, // player_action / reset_conversation
+        {1, 16}, // narrative of two-phase turns
+        {1, 4},  // create_game
+        {1, 1}   // background (world pool refill)
+    }}};
+
+    // Pre-generated worlds served to matching create_game prompts; persisted outside the
+    // contract state and refilled by a background job whenever generation is idle
+    WorldPool world_pool{"../../../world_pool", worldPoolThemes(), 2};
+    std::mt19937 world_pool_seed{std::random_device{}()}; // Refill thread only
+    std::thread world_pool_thread;
+    std::atomic<bool> background_job_active{false};
+    std::mutex background_mutex;
+    std::mutex status_file_mutex;   // Serializes status snapshot writes
+    std::shared_ptr<RequestCancellation> background_cancellation; // Running refill, preempted by live requests
+
+    // Semantic cache of player-action results: near-identical actions on the same game
+    // state reuse the cached state. Embeddings come from a small dedicated context.
+    SemanticActionCache action_cache;
+    WorldBlobCache world_blobs;     // Game worlds by content hash; player actions send only the hash
+    NarrativeTickets narratives;    // Background narratives of two-phase turns
+    std::mutex embedding_mutex;
+    llama_context *embedding_ctx = nullptr;
+    llama_model *embedding_ctx_model = nullptr; // Model the embedding context was created for
+
+    // Cancellation state of queued/running generation jobs by dedupe key, so coalesced
+    // requests can register their own connection and deadline on the shared job
+    std::mutex cancellations_mutex;
+    std::unordered_map<uint64_t, std::shared_ptr<RequestCancellation>> job_cancellations;
+
 public:
-    AIDaemon(const std::string &modelPath) : model_path(modelPath)
+    AIDaemon(const std::string &modelPath, const std::string &smallModelPath = "", int listenPort = 8765, bool standbyMode = false)
+        : port(listenPort), model_path(modelPath), small_model_path(smallModelPath)
     {
+        standby = standbyMode;
         // Install signal handlers
         signal(SIGTERM, signal_handler);
         signal(SIGINT, signal_handler);
@@ -255,6 +601,10 @@ public:
             std::cout << "[Daemon] Model vocabulary size: " << vocab_size << std::endl;
             std::cout << "[Daemon] STEP 6: ✓ Model verification passed!" << std::endl;
 
+            std::cout << "[Daemon] STEP 7: Pre-tokenizing static prompt fragments..." << std::endl;
+            warmPromptCache(ModelTier::Large, model);
+            std::cout << "[Daemon] STEP 7: ✓ Prompt fragments tokenized!" << std::endl;
+
             model_loaded = true;
             model_loading = false;
 
@@ -280,6 +630,42 @@ public:
         }
     }
 
+    bool loadSmallModel()
+    {
+        std::cout << "[Daemon] ========== Loading Small Model Tier ==========" << std::endl;
+        std::cout << "[Daemon] Small model path: " << small_model_path << std::endl;
+
+        if (!std::filesystem::exists(small_model_path))
+        {
+            small_model_error = "Small model file not found";
+            std::cerr << "[Daemon] WARNING: Small model not found - all turns will use the large model" << std::endl;
+            return false;
+        }
+
+        llama_model_params model_params = llama_model_default_params();
+        model_params.n_gpu_layers = 32;
+        model_params.use_mmap = true;
+        model_params.use_mlock = false;
+
+        small_model = llama_model_load_from_file(small_model_path.c_str(), model_params);
+        if (!small_model || !llama_model_get_vocab(small_model))
+        {
+            small_model_error = "Failed to load small model";
+            std::cerr << "[Daemon] WARNING: Small model loading failed - all turns will use the large model" << std::endl;
+            if (small_model)
+            {
+                llama_model_free(small_model);
+                small_model = nullptr;
+            }
+            return false;
+        }
+
+        warmPromptCache(ModelTier::Small, small_model);
+        small_model_loaded = true;
+        std::cout << "[Daemon] ✓ Small model tier ready" << std::endl;
+        return true;
+    }
+
     void loadModelAsync()
     {
         std::cout << "[Daemon] Starting async model loading thread..." << std::endl;
@@ -291,6 +677,7 @@ public:
             auto start_time = std::chrono::steady_clock::now();
             bool success = loadModel();
             auto end_time = std::chrono::steady_clock::now();
+            writeStatusSnapshot();
             
             auto duration = std::chrono::duration_cast<std::chrono::seconds>(end_time - start_time);
             
@@ -302,27 +689,107 @@ public:
                 std::cout << "[Daemon] Model loading failed! Duration: " << duration.count() << " seconds" << std::endl;
                 std::cout << "[Daemon] Error: " << model_error << std::endl;
             }
+
+            // Small tier loads after the large model so readiness is never delayed by it
+            if (success && !small_model_path.empty()) {
+                loadSmallModel();
+                writeStatusSnapshot();
+            }
             std::cout.flush(); })
             .detach();
         std::cout << "[Daemon] Async model loading thread launched" << std::endl;
     }
 
-    std::string generateResponse(const std::string &prompt, int max_tokens = 800)
+    // Frame the static prompts in the model's chat template and tokenize them for its tier
+    void warmPromptCache(ModelTier tier, llama_model *target)
+    {
+        PromptTokenCache &cache = tier == ModelTier::Small ? small_prompt_cache : large_prompt_cache;
+        ChatFrame &chat = tier == ModelTier::Small ? small_chat : large_chat;
+        chat = ChatFrame::render(target, PLAYER_ACTION_SYSTEM_PROMPT, REASONING_EFFORT);
+        ChatFrame create_chat = ChatFrame::render(target, "", REASONING_EFFORT);
+        std::cout << "[Daemon] Chat framing: " << (chat.templated ? "model template" : "plain text")
+                  << (chat.harmony ? " (harmony, final channel, reasoning " + std::string(REASONING_EFFORT) + ")" : "") << std::endl;
+
+        std::vector<std::string> stops = {"<<END_PLAYER_STATE>>"};
+        stops.insert(stops.end(), chat.stops.begin(), chat.stops.end());
+        (tier == ModelTier::Small ? small_stop_matcher : large_stop_matcher) = std::make_unique<StopSequenceMatcher>(stops);
+
+        cache.bind(llama_model_get_vocab(target));
+        cache.addFragment(FRAGMENT_ACTION_PREFIX, chat.prefix + PLAYER_ACTION_PREFIX, true);
+        cache.addFragment(FRAGMENT_ACTION_STATE_HEADER, PLAYER_ACTION_STATE_HEADER);
+        cache.addFragment(FRAGMENT_ACTION_ACTION_HEADER, PLAYER_ACTION_ACTION_HEADER);
+        cache.addFragment(FRAGMENT_ACTION_SUFFIX, PLAYER_ACTION_SUFFIX + chat.suffix);
+        cache.addFragment(FRAGMENT_CONTINUE_PREFIX, chat.nextTurn + CONTINUE_PREFIX);
+        cache.addFragment(FRAGMENT_CONTINUE_SUFFIX, CONTINUE_SUFFIX + chat.suffix + CONTINUE_ANSWER_START);
+        cache.addFragment(FRAGMENT_CREATE_PREFIX, create_chat.prefix + CREATE_PREFIX, true);
+        cache.addFragment(FRAGMENT_CREATE_SUFFIX, CREATE_SUFFIX + create_chat.suffix);
+        cache.addFragment(FRAGMENT_NARRATIVE_PREFIX, create_chat.prefix + NARRATIVE_PREFIX, true);
+        cache.addFragment(FRAGMENT_NARRATIVE_STATE_HEADER, NARRATIVE_STATE_HEADER);
+        cache.addFragment(FRAGMENT_NARRATIVE_RESULT_HEADER, NARRATIVE_RESULT_HEADER);
+        cache.addFragment(FRAGMENT_NARRATIVE_SUFFIX, NARRATIVE_SUFFIX + create_chat.suffix);
+    }
+
+    PromptTokenCache &promptCache(ModelTier tier)
+    {
+        return (tier == ModelTier::Small && small_model_loaded) ? small_prompt_cache : large_prompt_cache;
+    }
+
+    const ChatFrame &chatFrame(ModelTier tier) const
+    {
+        return (tier == ModelTier::Small && small_model_loaded) ? small_chat : large_chat;
+    }
+
+    const StopSequenceMatcher &stopMatcher(ModelTier tier) const
+    {
+        return (tier == ModelTier::Small && small_model_loaded) ? *small_stop_matcher : *large_stop_matcher;
+    }
+
+    // Assemble the initial-mode player action prompt from cached tokens; only the
+    // player state and action are tokenized per request, the world once per content hash
+    PromptTokenCache::Tokens buildPlayerActionTokens(ModelTier tier, const std::string &game_world,
+                                                     const std::string &game_state, const std::string &action)
+    {
+        PromptTokenCache &cache = promptCache(tier);
+        std::shared_ptr<const PromptTokenCache::Tokens> world_tokens = cache.text(game_world);
+
+        PromptTokenCache::Tokens state_tokens;
+        PromptTokenCache::Tokens action_tokens;
+        cache.tokenize(game_state, false, state_tokens);
+        cache.tokenize(action, false, action_tokens);
+
+        PromptTokenCache::Tokens prompt_tokens;
+        prompt_tokens.reserve(cache.fragment(FRAGMENT_ACTION_PREFIX).size() + world_tokens->size() +
+                              state_tokens.size() + action_tokens.size() +
+                              cache.fragment(FRAGMENT_ACTION_SUFFIX).size() + 16);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_ACTION_PREFIX));
+        PromptTokenCache::append(prompt_tokens, *world_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_ACTION_STATE_HEADER));
+        PromptTokenCache::append(prompt_tokens, state_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_ACTION_ACTION_HEADER));
+        PromptTokenCache::append(prompt_tokens, action_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_ACTION_SUFFIX));
+        return prompt_tokens;
+    }
+
+    // Sample up to max_tokens; a GBNF grammar, when given, constrains the whole answer.
+    // Requests sample with seed 0, so a prompt gets the same answer on every node.
+    std::string generateResponse(PromptTokenCache::Tokens prompt_tokens, int max_tokens = 800, ModelTier tier = ModelTier::Large,
+                                 RequestCancellation *cancel = nullptr, const char *grammar = nullptr, uint32_t seed = 0)
     {
         if (!model_loaded || !model)
         {
             return "{\"error\":\"Model not loaded\"}";
         }
 
-        const llama_vocab *vocab = llama_model_get_vocab(model);
-
-        const int n_prompt = -llama_tokenize(vocab, prompt.c_str(), prompt.size(), NULL, 0, true, true);
-        std::vector<llama_token> prompt_tokens(n_prompt);
+        // Fall back to the large model when the small tier is unavailable
+        llama_model *active_model = (tier == ModelTier::Small && small_model_loaded) ? small_model : model;
+        const llama_vocab *vocab = llama_model_get_vocab(active_model);
 
-        if (llama_tokenize(vocab, prompt.c_str(), prompt.size(), prompt_tokens.data(), prompt_tokens.size(), true, true) < 0)
+        if (prompt_tokens.empty())
         {
             return "{\"error\":\"Failed to tokenize prompt\"}";
         }
+        const int n_prompt = prompt_tokens.size();
 
         llama_context_params ctx_params = llama_context_default_params();
         ctx_params.n_ctx = 8192;                      // FIXED: Increased to 8192 for better context and longer conversations
@@ -330,7 +797,7 @@ public:
         ctx_params.no_perf = true;
         ctx_params.n_threads = 10;       // Use 10 CPU cores for inference
         ctx_params.n_threads_batch = 10; // Use 10 cores for batch processing
-        llama_context *ctx = llama_init_from_model(model, ctx_params);
+        llama_context *ctx = llama_init_from_model(active_model, ctx_params);
         if (!ctx)
         {
             return "{\"error\":\"Failed to create context\"}";
@@ -341,22 +808,46 @@ public:
         sparams.no_perf = true;
         llama_sampler *smpl = llama_sampler_chain_init(sparams);
 
+        if (grammar)
+        {
+            llama_sampler *grammar_sampler = llama_sampler_init_grammar(vocab, grammar, "root");
+            if (grammar_sampler)
+            {
+                llama_sampler_chain_add(smpl, grammar_sampler);
+            }
+            else
+            {
+                std::cout << "[Daemon] WARNING: Grammar failed to parse - sampling unconstrained" << std::endl;
+            }
+        }
+
         // Optimized sampling parameters for instruction following and structured output
         llama_sampler_chain_add(smpl, llama_sampler_init_top_k(20));    // Reduced for more focused responses
         llama_sampler_chain_add(smpl, llama_sampler_init_top_p(0.7f, 1)); // Reduced for more deterministic output
         llama_sampler_chain_add(smpl, llama_sampler_init_temp(0.3f));   // Much lower temperature for instruction following
-        llama_sampler_chain_add(smpl, llama_sampler_init_dist(0));
+        llama_sampler_chain_add(smpl, llama_sampler_init_dist(seed));
 
         llama_batch batch = llama_batch_get_one(prompt_tokens.data(), prompt_tokens.size());
 
         std::string response;
+        response.reserve(max_tokens * 8);
         int n_decode = 0;
 
+        const StopSequenceMatcher &stop_matcher = stopMatcher(tier);
+        StopSequenceMatcher::MatchState stop_state;
+
         // CRITICAL FIX: Add debug logging and more robust token generation
         std::cout << "[Daemon] Starting token generation for " << max_tokens << " tokens..." << std::endl;
 
         for (int n_pos = 0; n_pos + batch.n_tokens < ctx_params.n_ctx && n_decode < max_tokens;)
         {
+            // Checked before every decode, including the prompt decode
+            if (cancel && cancel->shouldStop())
+            {
+                std::cout << "[Daemon] Generation cancelled (" << cancel->reason() << ") after " << n_decode << " tokens" << std::endl;
+                break;
+            }
+
             int decode_result = llama_decode(ctx, batch);
             if (decode_result != 0)
             {
@@ -388,20 +879,18 @@ public:
             int n = llama_token_to_piece(vocab, new_token_id, buf, sizeof(buf), 0, true);
             if (n > 0)
             {
-                std::string token_str(buf, n);
-                response += token_str;
-                
-                // Check for end marker to stop generation early
-                if (response.find("<<END_PLAYER_STATE>>") != std::string::npos)
+                response.append(buf, n);
+
+                // Incremental stop-sequence check over the new piece only
+                int stop = stop_matcher.feed(stop_state, buf, n);
+                if (stop == STOP_END_PLAYER_STATE)
                 {
                     std::cout << "[Daemon] Found end marker, stopping generation at " << n_decode << " tokens" << std::endl;
                     break;
                 }
-                
-                // Check for Llama 3.1 end tokens
-                if (response.find("<|eot_id|>") != std::string::npos)
+                if (stop >= STOP_END_OF_TURN)
                 {
-                    std::cout << "[Daemon] Found Llama 3.1 end token, stopping generation at " << n_decode << " tokens" << std::endl;
+                    std::cout << "[Daemon] Found end-of-turn text, stopping generation at " << n_decode << " tokens" << std::endl;
                     break;
                 }
 
@@ -421,7 +910,12 @@ public:
         llama_sampler_free(smpl);
         llama_free(ctx);
 
-        return response;
+        if (cancel && cancel->isCancelled())
+        {
+            return cancel->errorResponse();
+        }
+
+        return chatFrame(tier).finalText(response);
     }
 
     bool initializePersistentContext()
@@ -483,10 +977,30 @@ public:
 
         conversation_active = false;
         conversation_position = 0;
+        missed_turn_actions.clear();
+        missed_turn_state.clear();
         std::cout << "[Daemon] ✓ Persistent context cleanup complete" << std::endl;
     }
 
-    std::string generateResponseContinue(const std::string &action, int max_tokens = 250)
+    // A turn answered without the large-model conversation: keep the conversation and let
+    // the next continuation catch up on it
+    void noteMissedTurn(const std::string &action, const std::string &new_state)
+    {
+        if (!conversation_active.load())
+        {
+            return;
+        }
+        if (missed_turn_actions.size() >= MAX_MISSED_TURNS)
+        {
+            std::cout << "[Daemon] Conversation missed " << missed_turn_actions.size() << " turns - rebuilding it" << std::endl;
+            cleanupPersistentContext();
+            return;
+        }
+        missed_turn_actions.push_back(action);
+        missed_turn_state = new_state;
+    }
+
+    std::string generateResponseContinue(const std::string &action, int max_tokens = 250, RequestCancellation *cancel = nullptr)
     {
         if (!model_loaded || !model)
         {
@@ -503,30 +1017,50 @@ public:
 
         const llama_vocab *vocab = llama_model_get_vocab(model);
 
-        // Create lightweight continuation prompt using Llama 3.1 format
-        std::string continuation_prompt = 
-            "<|start_header_id|>user<|end_header_id|>\n\n"
-            "Player Action: " + action + "\n\n"
-            "Update the player state:<|eot_id|><|start_header_id|>assistant<|end_header_id|>\n\n"
-            "<<BEGIN_PLAYER_STATE>>\n";
-
-        // Tokenize the continuation prompt
-        const int n_prompt = -llama_tokenize(vocab, continuation_prompt.c_str(), continuation_prompt.size(), NULL, 0, true, true);
-        std::vector<llama_token> prompt_tokens(n_prompt);
-
-        if (llama_tokenize(vocab, continuation_prompt.c_str(), continuation_prompt.size(), prompt_tokens.data(), prompt_tokens.size(), true, true) < 0)
+        // Lightweight continuation prompt (next user turn of the chat) from pre-tokenized fragments
+        PromptTokenCache &cache = large_prompt_cache;
+        std::string turn_text = action;
+        if (!missed_turn_actions.empty())
+        {
+            turn_text = missed_turn_actions.front();
+            for (size_t i = 1; i < missed_turn_actions.size(); i++)
+            {
+                turn_text += "\n" + CONTINUE_PREFIX + missed_turn_actions[i];
+            }
+            turn_text += MISSED_TURNS_STATE + missed_turn_state + "\n\n" + CONTINUE_PREFIX + action;
+            std::cout << "[Daemon] Replaying " << missed_turn_actions.size() << " turns the conversation missed" << std::endl;
+        }
+        PromptTokenCache::Tokens action_tokens;
+        if (!cache.tokenize(turn_text, false, action_tokens))
         {
             return "{\"error\":\"Failed to tokenize continuation prompt\"}";
         }
 
+        PromptTokenCache::Tokens prompt_tokens;
+        prompt_tokens.reserve(cache.fragment(FRAGMENT_CONTINUE_PREFIX).size() + action_tokens.size() +
+                              cache.fragment(FRAGMENT_CONTINUE_SUFFIX).size());
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_CONTINUE_PREFIX));
+        PromptTokenCache::append(prompt_tokens, action_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_CONTINUE_SUFFIX));
+
         // Process the continuation prompt
         llama_batch batch = llama_batch_get_one(prompt_tokens.data(), prompt_tokens.size());
         
         std::string response;
+        response.reserve(max_tokens * 8);
         int n_decode = 0;
 
+        const StopSequenceMatcher &stop_matcher = stopMatcher(ModelTier::Large);
+        StopSequenceMatcher::MatchState stop_state;
+
         std::cout << "[Daemon] Starting continuation token generation for " << max_tokens << " tokens..." << std::endl;
 
+        if (cancel && cancel->shouldStop())
+        {
+            std::cout << "[Daemon] Continuation cancelled before prompt decode (" << cancel->reason() << ")" << std::endl;
+            return cancel->errorResponse();
+        }
+
         // Process the prompt first
         int decode_result = llama_decode(persistent_ctx, batch);
         if (decode_result != 0)
@@ -536,10 +1070,18 @@ public:
         }
 
         conversation_position += batch.n_tokens;
+        missed_turn_actions.clear();
+        missed_turn_state.clear();
 
         // Generate response tokens
         for (int n_pos = conversation_position; n_pos < 8192 && n_decode < max_tokens;)
         {
+            if (cancel && cancel->shouldStop())
+            {
+                std::cout << "[Daemon] Continuation cancelled (" << cancel->reason() << ") after " << n_decode << " tokens" << std::endl;
+                break;
+            }
+
             llama_token new_token_id = llama_sampler_sample(persistent_sampler, persistent_ctx, -1);
 
             // Check for end of generation
@@ -562,20 +1104,18 @@ public:
             int n = llama_token_to_piece(vocab, new_token_id, buf, sizeof(buf), 0, true);
             if (n > 0)
             {
-                std::string token_str(buf, n);
-                response += token_str;
-                
-                // Check for end marker to stop generation early
-                if (response.find("<<END_PLAYER_STATE>>") != std::string::npos)
+                response.append(buf, n);
+
+                // Incremental stop-sequence check over the new piece only
+                int stop = stop_matcher.feed(stop_state, buf, n);
+                if (stop == STOP_END_PLAYER_STATE)
                 {
                     std::cout << "[Daemon] Found end marker in continuation, stopping generation at " << n_decode << " tokens" << std::endl;
                     break;
                 }
-                
-                // Check for Llama 3.1 end tokens
-                if (response.find("<|eot_id|>") != std::string::npos)
+                if (stop >= STOP_END_OF_TURN)
                 {
-                    std::cout << "[Daemon] Found Llama 3.1 end token in continuation, stopping generation at " << n_decode << " tokens" << std::endl;
+                    std::cout << "[Daemon] Found end-of-turn text in continuation, stopping generation at " << n_decode << " tokens" << std::endl;
                     break;
                 }
 
@@ -602,153 +1142,617 @@ public:
         std::cout << "[Daemon] Continuation generation completed. Generated " << n_decode << " tokens, response length: " << response.length() << std::endl;
         std::cout << "[Daemon] Conversation position now at: " << conversation_position << std::endl;
 
-        return response;
+        // A half-generated turn is already in the KV cache; the conversation must be rebuilt
+        if (cancel && cancel->isCancelled())
+        {
+            cleanupPersistentContext();
+            return cancel->errorResponse();
+        }
+
+        return large_chat.finalText(response);
     }
 
-    std::string processGameCreation(const nlohmann::json &request)
+    std::string processGameCreation(const nlohmann::json &request, RequestCancellation *cancel = nullptr)
     {
         std::string prompt = request["prompt"];
-        std::string game_prompt =
-            "Create a complete structured game world for a hybrid AI-governed gaming system. This must be compatible with rule-based processing.\n\n"
-            
-            "REQUIRED FORMAT (follow exactly):\n\n"
-            
-            "Game Title: [Engaging title]\n\n"
-            
-            "World Description: [2-3 sentences describing setting and atmosphere]\n\n"
-            
-            "World Lore: [1-2 sentences of background that affects gameplay]\n\n"
-            
-            "Objectives: [Primary goal - clear and achievable]\n\n"
-            
-            "Win Conditions: [Specific conditions to win]\n\n"
-            
-            "Valid Actions: MOVE [direction], EXAMINE [object], TAKE [item], USE [item], TALK [character], ATTACK [target], CAST [spell], OPEN [container]\n\n"
-            
-            "Locations:\n"
-            "- [Location 1]: [Description]. Exits: [directions]. Items: [list]. NPCs: [list]\n"
-            "- [Location 2]: [Description]. Exits: [directions]. Items: [list]. NPCs: [list]\n"
-            "- [Add 3-5 connected locations]\n\n"
-            
-            "Items:\n"
-            "- [Item 1]: [Description and properties]\n"
-            "- [Item 2]: [Description and properties]\n"
-            "- [Add key items for objectives]\n\n"
-            
-            "Game Rules:\n"
-            "- [Rule about movement/exploration]\n"
-            "- [Rule about items/inventory]\n"
-            "- [Rule about winning/losing]\n\n"
-            
-            "Starting Location: [Location name]\n\n"
-            
-            "Starting Inventory: [List starting items]\n\n"
-            
-            "Starting Health: [Number/100]\n\n"
-            
-            "Current Situation: [Opening scenario that sets the stage]\n\n"
-            
-            "User request: " + prompt + "\n\n"
-            "CRITICAL: Follow the exact format above. Create a world that supports structured rule-based gameplay with bounded actions.";
 
-        std::string ai_response = generateResponse(game_prompt, 500);
+        // A pooled world matching the prompt answers instantly. Opt-in: pooled worlds are
+        // node-local, so consensus rounds must generate live.
+        std::string pooled_world;
+        if (request.value("use_pool", false) && world_pool.take(prompt, pooled_world))
+        {
+            std::cout << "[Daemon] Serving create_game from the world pool" << std::endl;
+            return pooled_world;
+        }
 
-        // For text format, we don't need JSON cleaning - just return the narrative
-        return ai_response;
+        return generateWorld(prompt, cancel);
     }
 
-    std::string processPlayerAction(const nlohmann::json &request)
+    std::string generateWorld(const std::string &prompt, RequestCancellation *cancel = nullptr, uint32_t seed = 0)
     {
-        std::string action = request["action"];
-        std::string game_state = request.value("game_state", "");
-        std::string game_world = request.value("game_world", "");
-        bool continue_conversation = request.value("continue_conversation", false);
+        // Template tokens are cached; only the user request is tokenized here
+        PromptTokenCache &cache = large_prompt_cache;
+        PromptTokenCache::Tokens request_tokens;
+        cache.tokenize(prompt, false, request_tokens);
 
-        std::string ai_response;
+        PromptTokenCache::Tokens game_prompt_tokens;
+        game_prompt_tokens.reserve(cache.fragment(FRAGMENT_CREATE_PREFIX).size() + request_tokens.size() +
+                                   cache.fragment(FRAGMENT_CREATE_SUFFIX).size());
+        PromptTokenCache::append(game_prompt_tokens, cache.fragment(FRAGMENT_CREATE_PREFIX));
+        PromptTokenCache::append(game_prompt_tokens, request_tokens);
+        PromptTokenCache::append(game_prompt_tokens, cache.fragment(FRAGMENT_CREATE_SUFFIX));
 
-        // Determine which mode to use
-        // || !conversation_active.load()
-        if (!continue_conversation)
-        {
-            // INITIAL MODE - Full context establishment
-            std::cout << "[Daemon] Using initial mode - establishing full context" << std::endl;
-            
-            std::string system_prompt = 
-                "You are a game state processor. Process player actions and return ONLY the updated player state in the exact format specified. Use this format for subsequent entire conversation thread. "
-                "STRICTLY Do not PRODUCE explanations, reasoning, or any other text. Replace bracketed placeholders with actual values based on the action and game rules."
-                "IMPORTANT: If player repeats an action or similar action send the same updated state again without changes.";
-            
-            std::string user_content = 
-                "GAME WORLD:\n" + game_world + "\n\n"
-                "CURRENT PLAYER STATE:\n" + game_state + "\n\n"
-                "PLAYER ACTION: " + action + "\n\n"
-                "Return the updated player state in this exact format below:\n"
+        // World creation is always creative work for the large model
+        std::string ai_response = generateResponse(std::move(game_prompt_tokens), 500, ModelTier::Large, cancel, nullptr, seed);
 
-                "<<BEGIN_PLAYER_STATE>>\n"
-                
-                "Player_Location: [location_name]\n"
-                "Player_Health: [number]\n"
-                "Player_Score: [number]\n"
-                "Player_Inventory: [list]\n"
-                "Game_Status: [active/won/lost]\n"
-                "Messages: [\"A narrative of what happens and should be immersive and provides good game play experience\"]\n"
-                "Turn_Count: [number]\n"
-
-                "<<END_PLAYER_STATE>>";
-            
-            // Format as Llama 3.1 chat template
-            std::string prompt = 
-                "<|begin_of_text|><|start_header_id|>system<|end_header_id|>\n\n" + 
-                system_prompt + "<|eot_id|><|start_header_id|>user<|end_header_id|>\n\n" + 
-                user_content + "<|eot_id|><|start_header_id|>assistant<|end_header_id|>\n\n";
+        // For text format, we don't need JSON cleaning - just return the narrative
+        return ai_response;
+    }
 
-            ai_response = generateResponse(prompt, 400);
+    // Generate several worlds as parallel sequences of one context. The creation template
+    // is decoded once on sequence 0 and its KV cells are shared with the other sequences;
+    // each sequence then decodes its own user request and samples independently, one
+    // token per live sequence per decode call.
+    std::string processGameCreationBatch(const nlohmann::json &request, RequestCancellation *cancel = nullptr)
+    {
+        if (!model_loaded || !model)
+        {
+            return "{\"error\":\"Model not loaded\"}";
+        }
 
-            // After successful initial response, set up persistent context for future continuations
-            // continue_conversation && 
-            if (!conversation_active.load())
+        std::vector<std::string> prompts;
+        if (request.contains("prompts") && request["prompts"].is_array())
+        {
+            for (const auto &prompt : request["prompts"])
             {
-                if (initializePersistentContext())
-                {
-                    std::cout << "[Daemon] Initializing conversation context with full prompt..." << std::endl;
-                    
-                    // Process the full initial prompt through persistent context to establish conversation
-                    const llama_vocab *vocab = llama_model_get_vocab(model);
-                    const int n_prompt = -llama_tokenize(vocab, prompt.c_str(), prompt.size(), NULL, 0, true, true);
-                    std::vector<llama_token> prompt_tokens(n_prompt);
-
-                    if (llama_tokenize(vocab, prompt.c_str(), prompt.size(), prompt_tokens.data(), prompt_tokens.size(), true, true) >= 0)
-                    {
-                        llama_batch batch = llama_batch_get_one(prompt_tokens.data(), prompt_tokens.size());
-                        int decode_result = llama_decode(persistent_ctx, batch);
-                        
-                        if (decode_result == 0)
-                        {
-                            conversation_position = batch.n_tokens;
-                            conversation_active = true;
-                            std::cout << "[Daemon] ✓ Conversation context established, position: " << conversation_position << std::endl;
-                        }
-                        else
-                        {
-                            std::cout << "[Daemon] WARNING: Failed to establish conversation context" << std::endl;
-                            cleanupPersistentContext();
-                        }
-                    }
-                    else
-                    {
-                        std::cout << "[Daemon] WARNING: Failed to tokenize initial prompt for conversation setup" << std::endl;
-                        cleanupPersistentContext();
-                    }
-                }
+                prompts.push_back(prompt.is_string() ? prompt.get<std::string>() : std::string());
             }
         }
-        else
+        if (prompts.empty())
         {
-            // CONTINUATION MODE - Lightweight conversation continuation
-            std::cout << "[Daemon] Using continuation mode - lightweight conversation" << std::endl;
-            ai_response = generateResponseContinue(action, 400);
-
-            // If continuation fails, fall back to initial mode
+            return "{\"error\":\"No prompts provided for batch creation\"}";
+        }
+        if (prompts.size() > MAX_CREATE_BATCH)
+        {
+            return "{\"error\":\"Batch too large (max " + std::to_string(MAX_CREATE_BATCH) + " prompts)\"}";
+        }
+
+        // Prompts matching the world pool are answered from it; only the rest are generated
+        std::vector<std::string> results(prompts.size());
+        std::vector<size_t> pending;
+        for (size_t i = 0; i < prompts.size(); i++)
+        {
+            if (!request.value("use_pool", false) || !world_pool.take(prompts[i], results[i]))
+            {
+                pending.push_back(i);
+            }
+        }
+        if (pending.empty())
+        {
+            nlohmann::json result;
+            result["results"] = results;
+            return result.dump();
+        }
+
+        const int n_seq = pending.size();
+        const int max_tokens = 500;
+        const llama_vocab *vocab = llama_model_get_vocab(model);
+        PromptTokenCache &cache = large_prompt_cache;
+
+        const PromptTokenCache::Tokens &prefix_tokens = cache.fragment(FRAGMENT_CREATE_PREFIX);
+        const PromptTokenCache::Tokens &suffix_tokens = cache.fragment(FRAGMENT_CREATE_SUFFIX);
+        std::vector<PromptTokenCache::Tokens> tail_tokens(n_seq);
+        size_t tail_total = 0;
+        size_t tail_longest = 0;
+        for (int s = 0; s < n_seq; s++)
+        {
+            cache.tokenize(prompts[pending[s]], false, tail_tokens[s]);
+            PromptTokenCache::append(tail_tokens[s], suffix_tokens);
+            tail_total += tail_tokens[s].size();
+            tail_longest = std::max(tail_longest, tail_tokens[s].size());
+        }
+        if (prefix_tokens.empty())
+        {
+            return "{\"error\":\"Failed to tokenize prompt\"}";
+        }
+
+        std::cout << "[Daemon] Batch game creation: " << n_seq << " prompts generated ("
+                  << prompts.size() - n_seq << " from pool), shared prefix "
+                  << prefix_tokens.size() << " tokens" << std::endl;
+
+        // Unified KV cache so the copied prefix cells are shared, not duplicated per sequence
+        llama_context_params ctx_params = llama_context_default_params();
+        ctx_params.n_ctx = prefix_tokens.size() + n_seq * (tail_longest + max_tokens) + 64;
+        ctx_params.n_batch = std::max<size_t>(512, std::max(prefix_tokens.size(), tail_total));
+        ctx_params.n_seq_max = n_seq;
+        ctx_params.kv_unified = true;
+        ctx_params.no_perf = true;
+        ctx_params.n_threads = 10;
+        ctx_params.n_threads_batch = 10;
+        llama_context *ctx = llama_init_from_model(model, ctx_params);
+        if (!ctx)
+        {
+            return "{\"error\":\"Failed to create context\"}";
+        }
+
+        // Same sampling as single creation, one chain per sequence
+        std::vector<llama_sampler *> samplers(n_seq);
+        for (int s = 0; s < n_seq; s++)
+        {
+            auto sparams = llama_sampler_chain_default_params();
+            sparams.no_perf = true;
+            samplers[s] = llama_sampler_chain_init(sparams);
+            llama_sampler_chain_add(samplers[s], llama_sampler_init_top_k(20));
+            llama_sampler_chain_add(samplers[s], llama_sampler_init_top_p(0.7f, 1));
+            llama_sampler_chain_add(samplers[s], llama_sampler_init_temp(0.3f));
+            llama_sampler_chain_add(samplers[s], llama_sampler_init_dist(0));
+        }
+
+        llama_batch batch = llama_batch_init(ctx_params.n_batch, 0, n_seq);
+        std::vector<std::string> responses(n_seq);
+        std::vector<int> n_past(n_seq, prefix_tokens.size());
+        std::vector<int> logit_index(n_seq, -1);   // Batch slot holding each live sequence's logits
+        std::vector<int> n_decoded(n_seq, 0);
+        std::string error;
+
+        // Shared template prefix, decoded once
+        for (size_t i = 0; i < prefix_tokens.size(); i++)
+        {
+            common_batch_add(batch, prefix_tokens[i], i, {0}, false);
+        }
+        if (cancel && cancel->shouldStop())
+        {
+            error = cancel->errorResponse();
+        }
+        else if (llama_decode(ctx, batch) != 0)
+        {
+            error = "{\"error\":\"Failed to decode shared creation prefix\"}";
+        }
+
+        if (error.empty())
+        {
+            llama_memory_t mem = llama_get_memory(ctx);
+            for (int s = 1; s < n_seq; s++)
+            {
+                llama_memory_seq_cp(mem, 0, s, -1, -1);
+            }
+
+            // Per-sequence user requests in one batch; only the last token of each needs logits
+            common_batch_clear(batch);
+            for (int s = 0; s < n_seq; s++)
+            {
+                for (size_t i = 0; i < tail_tokens[s].size(); i++)
+                {
+                    bool last = (i + 1 == tail_tokens[s].size());
+                    common_batch_add(batch, tail_tokens[s][i], n_past[s]++, {s}, last);
+                    if (last)
+                        logit_index[s] = batch.n_tokens - 1;
+                }
+            }
+            if (llama_decode(ctx, batch) != 0)
+            {
+                error = "{\"error\":\"Failed to decode creation prompts\"}";
+            }
+        }
+
+        int live = n_seq;
+        while (error.empty() && live > 0)
+        {
+            if (cancel && cancel->shouldStop())
+            {
+                std::cout << "[Daemon] Batch creation cancelled (" << cancel->reason() << ")" << std::endl;
+                error = cancel->errorResponse();
+                break;
+            }
+
+            common_batch_clear(batch);
+            for (int s = 0; s < n_seq; s++)
+            {
+                if (logit_index[s] < 0)
+                    continue;
+
+                llama_token new_token_id = llama_sampler_sample(samplers[s], ctx, logit_index[s]);
+                logit_index[s] = -1;
+
+                bool finished = false;
+                if (llama_vocab_is_eog(vocab, new_token_id))
+                {
+                    // Never fed back into the sequence; one that ends on its first token has no
+                    // world and is answered with an empty result
+                    finished = true;
+                }
+                else
+                {
+                    char buf[128];
+                    int n = llama_token_to_piece(vocab, new_token_id, buf, sizeof(buf), 0, true);
+                    if (n > 0)
+                    {
+                        responses[s].append(buf, n);
+                    }
+                    n_decoded[s]++;
+                    finished = n_decoded[s] >= max_tokens || n_past[s] + 1 >= (int)ctx_params.n_ctx;
+                }
+
+                if (finished)
+                {
+                    live--;
+                    std::cout << "[Daemon] Batch sequence " << s << " finished after " << n_decoded[s] << " tokens" << std::endl;
+                    continue;
+                }
+
+                common_batch_add(batch, new_token_id, n_past[s]++, {s}, true);
+                logit_index[s] = batch.n_tokens - 1;
+            }
+
+            if (batch.n_tokens == 0)
+                break;
+            if (llama_decode(ctx, batch) != 0)
+            {
+                // Every live sequence was in this batch, so none of them can be finished
+                std::cout << "[Daemon] ERROR: llama_decode failed during batch creation" << std::endl;
+                error = "{\"error\":\"Failed to decode batch creation tokens\"}";
+            }
+        }
+
+        llama_batch_free(batch);
+        for (llama_sampler *smpl : samplers)
+        {
+            llama_sampler_free(smpl);
+        }
+        llama_free(ctx);
+
+        if (!error.empty())
+        {
+            return error;
+        }
+
+        for (int s = 0; s < n_seq; s++)
+        {
+            results[pending[s]] = n_decoded[s] > 0 ? large_chat.finalText(responses[s]) : std::string();
+        }
+
+        nlohmann::json result;
+        result["results"] = results;
+        return result.dump();
+    }
+
+    // Mean-pooled, normalized embedding of a player action. Uses the small model when it
+    // is loaded (one short forward pass), otherwise the large model.
+    bool embedAction(const std::string &action, SemanticActionCache::Embedding &embedding)
+    {
+        if (!model_loaded || !model)
+            return false;
+
+        bool use_small = small_model_loaded.load();
+        llama_model *embed_model = use_small ? small_model : model;
+
+        std::lock_guard<std::mutex> lock(embedding_mutex);
+        if (embedding_ctx && embedding_ctx_model != embed_model)
+        {
+            llama_free(embedding_ctx);
+            embedding_ctx = nullptr;
+        }
+        if (!embedding_ctx)
+        {
+            llama_context_params ctx_params = llama_context_default_params();
+            ctx_params.n_ctx = 256;
+            ctx_params.n_batch = 256;
+            ctx_params.n_ubatch = 256;
+            ctx_params.embeddings = true;
+            ctx_params.pooling_type = LLAMA_POOLING_TYPE_MEAN;
+            ctx_params.no_perf = true;
+            ctx_params.n_threads = 4;
+            ctx_params.n_threads_batch = 4;
+            embedding_ctx = llama_init_from_model(embed_model, ctx_params);
+            if (!embedding_ctx)
+            {
+                std::cout << "[Daemon] WARNING: Failed to create embedding context - action cache disabled" << std::endl;
+                return false;
+            }
+            embedding_ctx_model = embed_model;
+        }
+
+        // Case and surrounding whitespace do not change the meaning of an action
+        std::string normalized = action;
+        std::transform(normalized.begin(), normalized.end(), normalized.begin(), ::tolower);
+        size_t start = normalized.find_first_not_of(" \t\n\r");
+        size_t end = normalized.find_last_not_of(" \t\n\r.!");
+        normalized = (start == std::string::npos || end < start) ? "" : normalized.substr(start, end - start + 1);
+        if (normalized.empty())
+            return false;
+
+        PromptTokenCache::Tokens tokens;
+        promptCache(use_small ? ModelTier::Small : ModelTier::Large).tokenize(normalized, true, tokens);
+        if (tokens.empty())
+            return false;
+        if (tokens.size() > 256)
+            tokens.resize(256);
+
+        llama_memory_clear(llama_get_memory(embedding_ctx), true);
+        llama_batch batch = llama_batch_get_one(tokens.data(), tokens.size());
+        if (llama_decode(embedding_ctx, batch) != 0)
+            return false;
+
+        const float *values = llama_get_embeddings_seq(embedding_ctx, 0);
+        if (!values)
+            return false;
+        embedding.assign(values, values + llama_model_n_embd(embed_model));
+        SemanticActionCache::normalize(embedding);
+        return true;
+    }
+
+    // Player action with the semantic cache in front: a near-identical action on the same
+    // game world and state returns the cached state; freshly extracted states are cached.
+    // Opt-in (use_cache): a hit answers a different action text than the one asked, so it
+    // is only for callers whose answer no other node has to reproduce.
+    std::string processPlayerAction(const nlohmann::json &request, RequestCancellation *cancel = nullptr)
+    {
+        std::string game_id = request.value("game_id", "");
+        std::string action = request.value("action", "");
+        std::string game_state = request.value("game_state", "");
+        std::string game_world = request.value("game_world", "");
+        bool use_cache = request.value("use_cache", false) && !game_id.empty();
+        bool deferred_narrative = request.value("narrative", "") == "deferred";
+
+        uint64_t state_hash = 0;
+        SemanticActionCache::Embedding embedding;
+        if (use_cache)
+        {
+            uint64_t world_hash = ContentHash::fnv1a64(game_world);
+            state_hash = ContentHash::fnv1a64(game_state.data(), game_state.size(), world_hash);
+            use_cache = embedAction(action, embedding);
+
+            std::string cached;
+            float similarity = 0.0f;
+            if (use_cache && action_cache.lookup(game_id, state_hash, action, embedding, cached, &similarity))
+            {
+                std::cout << "[Daemon] Action cache hit (similarity " << similarity << ") for: " << action << std::endl;
+                noteMissedTurn(action, cached);
+                return cached;
+            }
+        }
+
+        bool extracted = false;
+        std::string response = deferred_narrative ? generateStructuredState(request, cancel, extracted)
+                                                  : generatePlayerAction(request, cancel, extracted);
+        if (!extracted || (cancel && cancel->isCancelled()))
+        {
+            return response;
+        }
+        if (deferred_narrative)
+        {
+            // Cached states must carry their narrative, so structured-only states are not stored
+            queueNarrative(request, response);
+        }
+        else if (use_cache)
+        {
+            action_cache.store(game_id, state_hash, action, embedding, response);
+        }
+        return response;
+    }
+
+    // First phase of a two-phase turn: the state fields only, grammar-constrained and
+    // stateless (initial-mode prompt), on the tier the action routes to
+    std::string generateStructuredState(const nlohmann::json &request, RequestCancellation *cancel, bool &extracted)
+    {
+        std::string action = request["action"];
+        std::string game_state = request.value("game_state", "");
+        std::string game_world = request.value("game_world", "");
+        bool small_tier = request.value("tier", "") != "large" && small_model_loaded &&
+                          routePlayerAction(action) == ModelTier::Small;
+
+        std::cout << "[Daemon] Two-phase turn - generating structured state on the " << (small_tier ? "small" : "large")
+                  << " model tier" << std::endl;
+        std::string ai_response;
+        if (small_tier)
+        {
+            small_tier_turns++;
+            ai_response = generateResponse(buildPlayerActionTokens(ModelTier::Small, game_world, game_state, action), 160,
+                                           ModelTier::Small, cancel, STRUCTURED_STATE_GRAMMAR);
+            if (cancel && cancel->isCancelled())
+            {
+                return ai_response;
+            }
+            if (!isStructuredPlayerState(ai_response))
+            {
+                small_tier_escalations++;
+                std::cout << "[Daemon] Small model output failed structural checks - escalating to large model" << std::endl;
+                small_tier = false;
+            }
+        }
+        if (!small_tier)
+        {
+            ai_response = generateResponse(buildPlayerActionTokens(ModelTier::Large, game_world, game_state, action), 160,
+                                           ModelTier::Large, cancel, STRUCTURED_STATE_GRAMMAR);
+            if (cancel && cancel->isCancelled())
+            {
+                return ai_response;
+            }
+        }
+
+        std::string new_state = extractPlayerState(ai_response, extracted);
+        if (extracted)
+        {
+            noteMissedTurn(action, new_state);
+        }
+        return new_state;
+    }
+
+    // Second phase of a two-phase turn: queue the narrative behind live player actions.
+    // It runs on the small tier when one is loaded, leaving the large model to the next turn.
+    void queueNarrative(const nlohmann::json &request, const std::string &new_state)
+    {
+        std::string game_id = request.value("game_id", "");
+        std::string game_state = request.value("game_state", "");
+        std::string action = request.value("action", "");
+        std::string game_world = request.value("game_world", "");
+        uint64_t ticket = NarrativeTickets::ticketOf(game_id, game_state, action);
+        if (!narratives.open(ticket))
+        {
+            return; // A retried turn - its narrative is already pending or done
+        }
+
+        RequestScheduler::Admission admission = scheduler.submit(
+            RequestClass::Narrative, 0,
+            [this, ticket, game_world, game_state, action, new_state]()
+            {
+                std::string narrative = generateNarrative(game_world, game_state, action, new_state);
+                std::cout << "[Daemon] Narrative " << (narrative.empty() ? "failed" : "ready") << " for ticket "
+                          << ContentHash::toHex(ticket) << std::endl;
+                narratives.complete(ticket, narrative);
+                return std::string();
+            },
+            [](const std::string &) {});
+
+        if (admission == RequestScheduler::Admission::Rejected)
+        {
+            std::cout << "[Daemon] Narrative queue full - turn left without narrative" << std::endl;
+            narratives.complete(ticket, "");
+        }
+    }
+
+    std::string generateNarrative(const std::string &game_world, const std::string &old_state,
+                                  const std::string &action, const std::string &new_state)
+    {
+        ModelTier tier = small_model_loaded ? ModelTier::Small : ModelTier::Large;
+        PromptTokenCache &cache = promptCache(tier);
+        std::shared_ptr<const PromptTokenCache::Tokens> world_tokens = cache.text(game_world);
+
+        PromptTokenCache::Tokens old_tokens, action_tokens, new_tokens;
+        cache.tokenize(old_state, false, old_tokens);
+        cache.tokenize(action, false, action_tokens);
+        cache.tokenize(new_state, false, new_tokens);
+
+        PromptTokenCache::Tokens prompt_tokens;
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_NARRATIVE_PREFIX));
+        PromptTokenCache::append(prompt_tokens, *world_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_NARRATIVE_STATE_HEADER));
+        PromptTokenCache::append(prompt_tokens, old_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_ACTION_ACTION_HEADER));
+        PromptTokenCache::append(prompt_tokens, action_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_NARRATIVE_RESULT_HEADER));
+        PromptTokenCache::append(prompt_tokens, new_tokens);
+        PromptTokenCache::append(prompt_tokens, cache.fragment(FRAGMENT_NARRATIVE_SUFFIX));
+
+        std::string narrative = generateResponse(prompt_tokens, 160, tier);
+        if (narrative.find("{\"error\"") == 0)
+        {
+            return "";
+        }
+
+        // One paragraph, without the quotes some models wrap it in
+        size_t paragraph_end = narrative.find("\n\n", narrative.find_first_not_of(" \t\n\r") + 1);
+        if (paragraph_end != std::string::npos)
+        {
+            narrative.erase(paragraph_end);
+        }
+        size_t start = narrative.find_first_not_of(" \t\n\r\"");
+        if (start == std::string::npos)
+        {
+            return "";
+        }
+        size_t end = narrative.find_last_not_of(" \t\n\r\"");
+        return narrative.substr(start, end - start + 1);
+    }
+
+    std::string generatePlayerAction(const nlohmann::json &request, RequestCancellation *cancel, bool &extracted)
+    {
+        std::string action = request["action"];
+        std::string game_state = request.value("game_state", "");
+        std::string game_world = request.value("game_world", "");
+        bool continue_conversation = request.value("continue_conversation", false);
+        bool force_large = request.value("tier", "") == "large";
+
+        std::string ai_response;
+        bool small_tier_handled = false;
+
+        // SMALL TIER - simple verb-matched turns run statelessly on the small model
+        if (!force_large && small_model_loaded && routePlayerAction(action) == ModelTier::Small)
+        {
+            std::cout << "[Daemon] Routing action to small model tier: " << action << std::endl;
+            small_tier_turns++;
+
+            std::string small_response = generateResponse(buildPlayerActionTokens(ModelTier::Small, game_world, game_state, action), 400, ModelTier::Small, cancel);
+            if (cancel && cancel->isCancelled())
+            {
+                return small_response; // Nobody is waiting - do not escalate
+            }
+            if (isStructuredPlayerState(small_response))
+            {
+                ai_response = small_response;
+                small_tier_handled = true;
+            }
+            else
+            {
+                small_tier_escalations++;
+                std::cout << "[Daemon] Small model output failed structural checks - escalating to large model" << std::endl;
+            }
+        }
+
+        // Determine which mode to use
+        // || !conversation_active.load()
+        if (small_tier_handled)
+        {
+            std::cout << "[Daemon] Small model tier produced a valid state" << std::endl;
+        }
+        else if (!continue_conversation)
+        {
+            // INITIAL MODE - Full context establishment
+            std::cout << "[Daemon] Using initial mode - establishing full context" << std::endl;
+
+            PromptTokenCache::Tokens prompt_tokens = buildPlayerActionTokens(ModelTier::Large, game_world, game_state, action);
+
+            ai_response = generateResponse(prompt_tokens, 400, ModelTier::Large, cancel);
+            if (cancel && cancel->isCancelled())
+            {
+                return ai_response;
+            }
+
+            // After successful initial response, set up persistent context for future continuations
+            // continue_conversation && 
+            if (!conversation_active.load())
+            {
+                if (initializePersistentContext())
+                {
+                    std::cout << "[Daemon] Initializing conversation context with full prompt..." << std::endl;
+                    
+                    // Process the full initial prompt through persistent context to establish conversation
+                    if (!prompt_tokens.empty())
+                    {
+                        llama_batch batch = llama_batch_get_one(prompt_tokens.data(), prompt_tokens.size());
+                        int decode_result = llama_decode(persistent_ctx, batch);
+                        
+                        if (decode_result == 0)
+                        {
+                            conversation_position = batch.n_tokens;
+                            conversation_active = true;
+                            std::cout << "[Daemon] ✓ Conversation context established, position: " << conversation_position << std::endl;
+                        }
+                        else
+                        {
+                            std::cout << "[Daemon] WARNING: Failed to establish conversation context" << std::endl;
+                            cleanupPersistentContext();
+                        }
+                    }
+                    else
+                    {
+                        std::cout << "[Daemon] WARNING: Failed to tokenize initial prompt for conversation setup" << std::endl;
+                        cleanupPersistentContext();
+                    }
+                }
+            }
+        }
+        else
+        {
+            // CONTINUATION MODE - Lightweight conversation continuation
+            std::cout << "[Daemon] Using continuation mode - lightweight conversation" << std::endl;
+            ai_response = generateResponseContinue(action, 400, cancel);
+            if (cancel && cancel->isCancelled())
+            {
+                return ai_response;
+            }
+
+            // If continuation fails, fall back to initial mode
             if (ai_response.find("{\"error\"") != std::string::npos)
             {
                 std::cout << "[Daemon] Continuation failed, falling back to initial mode..." << std::endl;
@@ -757,11 +1761,25 @@ public:
                 // Recursive call with continue_conversation = false
                 nlohmann::json fallback_request = request;
                 fallback_request["continue_conversation"] = false;
-                return processPlayerAction(fallback_request);
+                fallback_request["tier"] = "large";
+                return generatePlayerAction(fallback_request, cancel, extracted);
             }
         }
 
-        // Post-process to extract only the player state (same for both modes) - ROBUST MARKER DETECTION
+        // Post-process to extract only the player state (same for both modes)
+        std::string new_state = extractPlayerState(ai_response, extracted);
+        if (small_tier_handled && extracted)
+        {
+            // The large-model conversation did not see this turn; it catches up on the next one
+            noteMissedTurn(action, new_state);
+        }
+        return new_state;
+    }
+
+    // Player state between the state markers - ROBUST MARKER DETECTION; the raw response
+    // when the markers are missing
+    std::string extractPlayerState(const std::string &ai_response, bool &extracted)
+    {
         std::string begin_marker_text = "<<BEGIN_PLAYER_STATE>>";
         std::string end_marker_text = "<<END_PLAYER_STATE>>";
         
@@ -797,6 +1815,7 @@ public:
             std::cout << "[Daemon] Begin marker found at position: " << begin_marker << std::endl;
             std::cout << "[Daemon] End marker found at position: " << end_marker << std::endl;
             std::cout << "[Daemon] Extracted content: " << clean_response.substr(0, 100) << "..." << std::endl;
+            extracted = true;
             return clean_response;
         }
         
@@ -807,7 +1826,7 @@ public:
         return ai_response;
     }
 
-    std::string handleRequest(const std::string &request_str)
+    std::string handleRequest(const std::string &request_str, RequestCancellation *cancel = nullptr)
     {
         try
         {
@@ -816,11 +1835,37 @@ public:
 
             if (type == "create_game")
             {
-                return processGameCreation(request);
+                return processGameCreation(request, cancel);
+            }
+            else if (type == "create_game_batch")
+            {
+                return processGameCreationBatch(request, cancel);
             }
             else if (type == "player_action")
             {
-                return processPlayerAction(request);
+                // The world may have been evicted while the request was queued
+                if (!world_blobs.resolve(request))
+                {
+                    return WorldBlobCache::missResponse(request.value("world_hash", ""));
+                }
+                return processPlayerAction(request, cancel);
+            }
+            else if (type == "narrative")
+            {
+                // Narrative of a two-phase turn, addressed by the turn it belongs to
+                uint64_t ticket = NarrativeTickets::ticketOf(request.value("game_id", ""), request.value("game_state", ""),
+                                                             request.value("action", ""));
+                int wait_ms = std::min(std::max(request.value("wait_ms", 0), 0), 5000);
+                std::string narrative;
+                NarrativeTickets::Status status = narratives.wait(ticket, wait_ms, narrative);
+
+                nlohmann::json response;
+                response["status"] = NarrativeTickets::statusName(status);
+                if (status == NarrativeTickets::Status::Ready)
+                {
+                    response["narrative"] = narrative;
+                }
+                return response.dump();
             }
             else if (type == "reset_conversation")
             {
@@ -830,21 +1875,51 @@ public:
             }
             else if (type == "ping")
             {
-                std::string status = "loading";
-                if (model_loaded)
+                return statusJson();
+            }
+            else if (type == "activate")
+            {
+                // Hot model swap: this standby now serves contract traffic
+                if (standby.exchange(false))
                 {
-                    status = "ready";
+                    std::cout << "[Daemon] Standby activated - serving contract traffic on port " << port << std::endl;
+                    writePidFile();
+                    writeStatusSnapshot();
+                    startWorldPoolRefill();
                 }
-                else if (!model_loading && !model_error.empty())
+                return statusJson();
+            }
+            else if (type == "retire")
+            {
+                // Hot model swap: a successor serves new traffic. Tickets are handed over before
+                // the reply, so a narrative lookup never reaches the successor ahead of them;
+                // accepted requests are finished once the accept loop has stopped.
+                successor_port = request.value("successor_port", 0);
+                handOverNarratives();
+                retiring = true;
+                running = false;
+                shutdown(server_socket, SHUT_RDWR); // Wakes the accept loop
+                std::cout << "[Daemon] Retiring in favour of the daemon on port " << successor_port.load() << std::endl;
+                return "{\"status\":\"retiring\"}";
+            }
+            else if (type == "adopt_narratives")
+            {
+                // Narrative tickets of a retiring predecessor: pending ones are opened here and
+                // completed by a later hand-over
+                size_t adopted = 0;
+                for (const auto &entry : request.value("narratives", nlohmann::json::array()))
                 {
-                    status = "error";
+                    uint64_t ticket = entry.value("ticket", static_cast<uint64_t>(0));
+                    std::string status = entry.value("status", "");
+                    narratives.open(ticket);
+                    if (status != NarrativeTickets::statusName(NarrativeTickets::Status::Pending))
+                    {
+                        narratives.complete(ticket, entry.value("narrative", ""));
+                    }
+                    adopted++;
                 }
-
-                return "{\"status\":\"" + status + "\"" +
-                       ",\"model_loaded\":" + std::string(model_loaded ? "true" : "false") +
-                       ",\"model_loading\":" + std::string(model_loading ? "true" : "false") +
-                       (model_error.empty() ? "" : ",\"error\":\"" + model_error + "\"") +
-                       "}";
+                std::cout << "[Daemon] Adopted " << adopted << " narrative ticket(s) from the previous daemon" << std::endl;
+                return "{\"status\":\"adopted\",\"count\":" + std::to_string(adopted) + "}";
             }
             else
             {
@@ -857,57 +1932,344 @@ public:
         }
     }
 
-    void handleClient(int client_socket)
+    std::string statusJson()
+    {
+        std::string status = "loading";
+        if (model_loaded)
+        {
+            status = "ready";
+        }
+        else if (!model_loading && !model_error.empty())
+        {
+            status = "error";
+        }
+
+        return "{\"status\":\"" + status + "\"" +
+               ",\"model_loaded\":" + std::string(model_loaded ? "true" : "false") +
+               ",\"model_loading\":" + std::string(model_loading ? "true" : "false") +
+               ",\"small_model_loaded\":" + std::string(small_model_loaded ? "true" : "false") +
+               ",\"small_tier_turns\":" + std::to_string(small_tier_turns.load()) +
+               ",\"small_tier_escalations\":" + std::to_string(small_tier_escalations.load()) +
+               ",\"queues\":{" + scheduler.metricsJson() + "}" +
+               ",\"world_pool\":" + world_pool.metricsJson() +
+               ",\"action_cache\":" + action_cache.metricsJson() +
+               ",\"world_cache\":" + world_blobs.metricsJson() +
+               (model_error.empty() ? "" : ",\"error\":\"" + model_error + "\"") +
+               "}";
+    }
+
+    // Ping response mirrored to disk so read-only contract rounds can report daemon
+    // status without connecting. Rewritten on model state changes and every few seconds.
+    void writeStatusSnapshot()
+    {
+        if (standby)
+            return; // The serving daemon owns the snapshot
+        std::lock_guard<std::mutex> lock(status_file_mutex);
+        std::string tmp_path = std::string(STATUS_FILE) + ".tmp";
+        {
+            std::ofstream status_file(tmp_path, std::ios::trunc);
+            status_file << statusJson();
+            if (!status_file)
+                return;
+        }
+        std::rename(tmp_path.c_str(), STATUS_FILE);
+    }
+
+    static RequestClass classifyRequest(const std::string &type)
     {
-        std::cout << "[Daemon] Handling client (fd=" << client_socket << ", thread_id=" << std::this_thread::get_id() << ")" << std::endl;
+        if (type == "player_action" || type == "reset_conversation")
+            return RequestClass::PlayerAction;
+        if (type == "create_game" || type == "create_game_batch")
+            return RequestClass::CreateGame;
+        if (type == "narrative")
+            return RequestClass::Lookup; // May wait for the narrative - never in a ping slot
+        return RequestClass::Ping; // ping, hot-swap control and malformed requests are answered cheaply
+    }
 
+    // Read one request message: a JSON document terminated by a newline (clients serialize
+    // without raw newlines). Only the bytes of each new chunk are scanned for the end; a
+    // request without the terminator is checked once, when the client stops sending.
+    bool readRequest(int client_socket, std::string &request)
+    {
         char buffer[8192];
-        ssize_t bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
+        while (true)
+        {
+            ssize_t bytes_received = recv(client_socket, buffer, sizeof(buffer), 0);
+            if (bytes_received == 0)
+            {
+                if (request.empty())
+                    std::cout << "[Daemon] Client closed connection" << std::endl;
+                return !request.empty();
+            }
+            if (bytes_received < 0)
+            {
+                std::cerr << "[Daemon] Failed to receive data: " << strerror(errno) << std::endl;
+                return !request.empty() && nlohmann::json::accept(request);
+            }
+            request.append(buffer, bytes_received);
+            const char *end = static_cast<const char *>(memchr(buffer, '\n', bytes_received));
+            if (end)
+            {
+                request.resize(request.size() - bytes_received + (end - buffer));
+                return true;
+            }
+        }
+    }
 
-        if (bytes_received > 0)
+    void sendResponse(int client_socket, const std::string &response)
+    {
+        std::cout << "[Daemon] Generated response (" << response.length() << " bytes)" << std::endl;
+        std::cout << "[Daemon] Response preview: " << response.substr(0, 100) << "..." << std::endl;
+
+        ssize_t bytes_sent = send(client_socket, response.c_str(), response.length(), MSG_NOSIGNAL);
+        if (bytes_sent == -1)
+        {
+            std::cerr << "[Daemon] Failed to send response: " << strerror(errno) << std::endl;
+        }
+        else
         {
-            buffer[bytes_received] = '\0';
-            std::string request(buffer);
+            std::cout << "[Daemon] Sent " << bytes_sent << " bytes successfully" << std::endl;
+        }
 
-            std::cout << "[Daemon] Received " << bytes_received << " bytes" << std::endl;
-            std::cout << "[Daemon] Request preview: " << request.substr(0, 100) << "..." << std::endl;
+        close(client_socket);
+        std::cout << "[Daemon] Client connection closed (fd=" << client_socket << ")" << std::endl;
+    }
 
-            std::string response = handleRequest(request);
+    // Read the request on the connection's reader thread and hand it to the priority
+    // scheduler. The response is written by the worker that runs the job, or immediately
+    // when the request class is saturated.
+    void dispatchClient(int client_socket)
+    {
+        // Bound how long a stalled client can hold its reader thread
+        struct timeval timeout;
+        timeout.tv_sec = 5;
+        timeout.tv_usec = 0;
+        setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        std::string request;
+        if (!readRequest(client_socket, request))
+        {
+            close(client_socket);
+            return;
+        }
 
-            std::cout << "[Daemon] Generated response (" << response.length() << " bytes)" << std::endl;
-            std::cout << "[Daemon] Response preview: " << response.substr(0, 100) << "..." << std::endl;
+        std::cout << "[Daemon] Received " << request.length() << " bytes" << std::endl;
+        std::cout << "[Daemon] Request preview: " << request.substr(0, 100) << "..." << std::endl;
 
-            ssize_t bytes_sent = send(client_socket, response.c_str(), response.length(), 0);
-            if (bytes_sent == -1)
+        RequestClass request_class = RequestClass::Ping;
+        uint64_t dedupe_key = 0;
+        int64_t deadline_ms = 0;
+        try
+        {
+            nlohmann::json parsed = nlohmann::json::parse(request);
+            std::string type = parsed.value("type", "");
+            request_class = classifyRequest(type);
+            deadline_ms = parsed.value("deadline_ms", static_cast<int64_t>(0));
+
+            // A player action naming an unknown world is answered right away so the
+            // client resends it with the world text
+            if (type == "player_action" && !world_blobs.admit(parsed))
             {
-                std::cerr << "[Daemon] Failed to send response: " << strerror(errno) << std::endl;
+                std::cout << "[Daemon] World not cached - asking client for the world text" << std::endl;
+                sendResponse(client_socket, WorldBlobCache::missResponse(parsed.value("world_hash", "")));
+                return;
             }
-            else
+
+            // Identical generation requests (e.g. a contract retry) share one job; the
+            // retry carries a fresh deadline, so it is left out of the key. The world
+            // hash stands in for the world text whether or not the text was sent.
+            if (type == "player_action" || type == "create_game" || type == "create_game_batch")
             {
-                std::cout << "[Daemon] Sent " << bytes_sent << " bytes successfully" << std::endl;
+                parsed.erase("deadline_ms");
+                if (parsed.contains("world_hash"))
+                    parsed.erase("game_world");
+                dedupe_key = ContentHash::fnv1a64(parsed.dump());
             }
         }
-        else if (bytes_received == 0)
+        catch (...)
+        {
+            // handleRequest reports the parse error
+        }
+
+        // Live generation takes precedence over pool refills
+        if (request_class == RequestClass::PlayerAction || request_class == RequestClass::CreateGame)
         {
-            std::cout << "[Daemon] Client closed connection" << std::endl;
+            preemptBackgroundWork();
+        }
+
+        if (deadline_ms > 0 && RequestCancellation::nowUnixMs() >= deadline_ms)
+        {
+            std::cout << "[Daemon] Request arrived past its deadline - not queued" << std::endl;
+            sendResponse(client_socket, "{\"error\":\"cancelled\",\"reason\":\"deadline_exceeded\"}");
+            return;
+        }
+
+        // Attach to the cancellation state of an identical in-flight job, or start a new one
+        std::shared_ptr<RequestCancellation> cancellation;
+        bool registered = false;
+        if (dedupe_key != 0)
+        {
+            std::lock_guard<std::mutex> lock(cancellations_mutex);
+            auto existing = job_cancellations.find(dedupe_key);
+            if (existing != job_cancellations.end())
+            {
+                cancellation = existing->second;
+                cancellation->addClient(client_socket, deadline_ms);
+            }
+            else
+            {
+                cancellation = std::make_shared<RequestCancellation>(client_socket, deadline_ms);
+                job_cancellations[dedupe_key] = cancellation;
+                registered = true;
+            }
         }
         else
         {
-            std::cerr << "[Daemon] Failed to receive data: " << strerror(errno) << std::endl;
+            cancellation = std::make_shared<RequestCancellation>(client_socket, deadline_ms);
         }
 
-        close(client_socket);
-        std::cout << "[Daemon] Client connection closed (fd=" << client_socket << ")" << std::endl;
+        RequestScheduler::Admission admission = scheduler.submit(
+            request_class, dedupe_key,
+            [this, request, cancellation, dedupe_key]()
+            {
+                // Clients may have given up while the job waited in the queue
+                std::string response = cancellation->shouldStop() ? cancellation->errorResponse()
+                                                                   : handleRequest(request, cancellation.get());
+                releaseCancellation(dedupe_key, cancellation);
+                return response;
+            },
+            [this, client_socket](const std::string &response)
+            { sendResponse(client_socket, response); });
+
+        if (admission == RequestScheduler::Admission::Rejected)
+        {
+            if (registered)
+            {
+                releaseCancellation(dedupe_key, cancellation);
+            }
+
+            int retry_after_ms = scheduler.retryAfterMs(request_class);
+            std::cout << "[Daemon] Queue full for " << requestClassName(request_class)
+                      << " - rejecting with retry_after_ms=" << retry_after_ms << std::endl;
+            sendResponse(client_socket, "{\"status\":\"busy\",\"error\":\"busy\"" +
+                                            std::string(",\"request_class\":\"") + requestClassName(request_class) + "\"" +
+                                            ",\"retry_after_ms\":" + std::to_string(retry_after_ms) + "}");
+        }
+        else if (admission == RequestScheduler::Admission::Coalesced)
+        {
+            std::cout << "[Daemon] Identical " << requestClassName(request_class)
+                      << " request already in progress - attached to existing job" << std::endl;
+        }
     }
 
-    bool startServer()
+    void preemptBackgroundWork()
     {
-        std::cout << "[Daemon] ========== Starting TCP Server ==========" << std::endl;
-        std::cout << "[Daemon] Port: " << port << std::endl;
-        std::cout << "[Daemon] Process ID: " << getpid() << std::endl;
-        std::cout << "[Daemon] Current working directory: " << std::filesystem::current_path() << std::endl;
+        std::lock_guard<std::mutex> lock(background_mutex);
+        if (background_cancellation)
+        {
+            std::cout << "[Daemon] Preempting world pool refill for a live request" << std::endl;
+            background_cancellation->cancel("preempted");
+        }
+    }
 
-        // Create PID file for debugging
+    // Idle-time pool refill: every few seconds, if the model is loaded, no generation
+    // is queued or running and a theme is below target, queue one background world
+    void startWorldPoolRefill()
+    {
+        world_pool.load();
+        std::cout << "[Daemon] World pool loaded: " << world_pool.metricsJson() << std::endl;
+
+        world_pool_thread = std::thread([this]()
+                                        {
+            int idle_ticks = 0;
+            while (running && !g_shutdown_requested) {
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                if (++idle_ticks < 10) continue;
+                idle_ticks = 0;
+                writeStatusSnapshot();
+
+                if (!model_loaded || background_job_active) continue;
+                if (scheduler.activeJobs(RequestClass::PlayerAction) > 0 ||
+                    scheduler.activeJobs(RequestClass::CreateGame) > 0) continue;
+
+                const WorldTheme *theme = world_pool.nextRefill();
+                if (!theme) continue;
+                queueWorldPoolRefill(theme->name, theme->seedPrompt);
+            } });
+    }
+
+    void queueWorldPoolRefill(const std::string &theme, const std::string &seed_prompt)
+    {
+        auto cancellation = std::make_shared<RequestCancellation>();
+        {
+            std::lock_guard<std::mutex> lock(background_mutex);
+            background_cancellation = cancellation;
+        }
+        background_job_active = true;
+
+        // A fresh sampling seed per refill, or every world of a theme would be the same one
+        uint32_t seed = world_pool_seed();
+        std::cout << "[Daemon] Generating pooled world for theme: " << theme << " (seed " << seed << ")" << std::endl;
+        RequestScheduler::Admission admission = scheduler.submit(
+            RequestClass::Background, 0,
+            [this, cancellation, theme, seed_prompt, seed]()
+            {
+                std::string world = generateWorld(seed_prompt, cancellation.get(), seed);
+                if (cancellation->isCancelled())
+                {
+                    std::cout << "[Daemon] World pool refill " << cancellation->reason() << std::endl;
+                }
+                else if (isCompleteWorld(world) && world_pool.add(theme, world))
+                {
+                    std::cout << "[Daemon] ✓ Added world to pool (" << theme << ")" << std::endl;
+                }
+                else
+                {
+                    std::cout << "[Daemon] WARNING: Generated world incomplete - not pooled" << std::endl;
+                }
+                finishBackgroundJob();
+                return std::string();
+            },
+            [](const std::string &) {});
+
+        if (admission == RequestScheduler::Admission::Rejected)
+        {
+            finishBackgroundJob();
+        }
+    }
+
+    void finishBackgroundJob()
+    {
+        {
+            std::lock_guard<std::mutex> lock(background_mutex);
+            background_cancellation.reset();
+        }
+        background_job_active = false;
+    }
+
+    void stopWorldPoolRefill()
+    {
+        preemptBackgroundWork();
+        if (world_pool_thread.joinable())
+        {
+            world_pool_thread.join();
+        }
+    }
+
+    void releaseCancellation(uint64_t dedupe_key, const std::shared_ptr<RequestCancellation> &cancellation)
+    {
+        if (dedupe_key == 0)
+            return;
+        std::lock_guard<std::mutex> lock(cancellations_mutex);
+        auto it = job_cancellations.find(dedupe_key);
+        if (it != job_cancellations.end() && it->second == cancellation)
+        {
+            job_cancellations.erase(it);
+        }
+    }
+
+    void writePidFile()
+    {
         std::cout << "[Daemon] Creating PID file..." << std::endl;
         try
         {
@@ -927,6 +2289,90 @@ public:
         {
             std::cerr << "[Daemon] WARNING: Exception creating PID file: " << e.what() << std::endl;
         }
+    }
+
+    // One request to another daemon on this host (the successor of a hot swap)
+    static std::string sendToDaemon(int daemon_port, const std::string &request)
+    {
+        int sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (sock == -1)
+            return "";
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = inet_addr("127.0.0.1");
+        addr.sin_port = htons(daemon_port);
+        std::string response;
+        std::string framed = request + "\n"; // See readRequest
+        if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) == 0 &&
+            send(sock, framed.c_str(), framed.length(), MSG_NOSIGNAL) == static_cast<ssize_t>(framed.length()))
+        {
+            char buffer[8192];
+            ssize_t bytes_received;
+            while ((bytes_received = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+                response.append(buffer, bytes_received);
+        }
+        close(sock);
+        return response;
+    }
+
+    // Send every narrative ticket held here to the successor daemon
+    void handOverNarratives()
+    {
+        if (successor_port <= 0)
+            return;
+        nlohmann::json request;
+        request["type"] = "adopt_narratives";
+        request["narratives"] = nlohmann::json::array();
+        for (const auto &ticket : narratives.snapshot())
+        {
+            request["narratives"].push_back({{"ticket", ticket.ticket},
+                                             {"status", NarrativeTickets::statusName(ticket.status)},
+                                             {"narrative", ticket.narrative}});
+        }
+        if (request["narratives"].empty())
+            return;
+        std::string response = sendToDaemon(successor_port, request.dump());
+        std::cout << "[Daemon] Narrative hand-over to port " << successor_port.load() << ": "
+                  << (response.empty() ? "no reply" : response) << std::endl;
+    }
+
+    // Retirement after a hot swap: finish the accepted requests (pending narratives
+    // included), then hand the narratives they produced to the successor
+    void drainForRetirement()
+    {
+        std::cout << "[Daemon] Retiring - finishing accepted requests..." << std::endl;
+        stopWorldPoolRefill();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(RETIRE_DRAIN_MS);
+        while (!g_shutdown_requested && std::chrono::steady_clock::now() < deadline)
+        {
+            size_t active = 0;
+            for (size_t i = 0; i < kRequestClassCount; i++)
+            {
+                RequestClass request_class = static_cast<RequestClass>(i);
+                if (request_class != RequestClass::Background)
+                    active += scheduler.activeJobs(request_class);
+            }
+            if (active == 0)
+                break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+        handOverNarratives();
+        std::cout << "[Daemon] Retirement drain complete" << std::endl;
+    }
+
+    bool startServer()
+    {
+        std::cout << "[Daemon] ========== Starting TCP Server ==========" << std::endl;
+        std::cout << "[Daemon] Port: " << port << std::endl;
+        std::cout << "[Daemon] Process ID: " << getpid() << std::endl;
+        std::cout << "[Daemon] Current working directory: " << std::filesystem::current_path() << std::endl;
+
+        // Create PID file for debugging (a standby writes it when activated)
+        if (!standby)
+        {
+            writePidFile();
+        }
 
         // Create TCP socket
         std::cout << "[Daemon] STEP 1: Creating TCP socket..." << std::endl;
@@ -966,7 +2412,7 @@ public:
 
         // Listen for connections
         std::cout << "[Daemon] STEP 4: Starting to listen for connections..." << std::endl;
-        if (listen(server_socket, 5) == -1)
+        if (listen(server_socket, SOMAXCONN) == -1)
         {
             std::cerr << "[Daemon] ERROR: Failed to listen on socket: " << strerror(errno) << std::endl;
             close(server_socket);
@@ -994,8 +2440,18 @@ public:
         std::cout << "[Daemon] Beginning model loading in background..." << std::endl;
 
         // Start model loading asynchronously - don't block!
+        writeStatusSnapshot();
         loadModelAsync();
 
+        // Start the bounded worker pool for queued requests
+        scheduler.start();
+
+        // Keep the pre-generated world pool topped up while idle (a standby once activated)
+        if (!standby)
+        {
+            startWorldPoolRefill();
+        }
+
         std::cout << "[Daemon] ========== Daemon Ready for Requests ==========" << std::endl;
         std::cout << "[Daemon] Model loading in progress - accepting connections" << std::endl;
         std::cout << "[Daemon] TCP server listening on port: " << port << std::endl;
@@ -1045,16 +2501,19 @@ public:
             std::string status = model_loaded ? "ready" : (model_loading ? "loading" : "error");
             std::cout << "[Daemon] Current model status: " << status << std::endl;
 
-            // Handle client in separate thread for concurrency
-            std::thread client_thread(&AIDaemon::handleClient, this, client_socket);
-            client_thread.detach();
-
-            std::cout << "[Daemon] Client handler thread started for connection " << connection_count << std::endl;
+            // Read on a thread of its own, so a slow client never holds up accepting the
+            // next one; the request is then queued by priority class
+            std::thread(&AIDaemon::dispatchClient, this, client_socket).detach();
             std::cout.flush();
         }
 
         std::cout << "[Daemon] Exiting main server loop (running=" << running
                   << ", shutdown_requested=" << g_shutdown_requested.load() << ")" << std::endl;
+
+        if (retiring)
+        {
+            drainForRetirement();
+        }
     }
 
     void stop()
@@ -1072,10 +2531,25 @@ public:
 
         stopHeartbeat();
         stop();
+        stopWorldPoolRefill();
+        scheduler.stop();
 
         // Clean up persistent context first
         cleanupPersistentContext();
 
+        if (embedding_ctx)
+        {
+            llama_free(embedding_ctx);
+            embedding_ctx = nullptr;
+        }
+
+        if (small_model)
+        {
+            std::cout << "[Daemon] Freeing small model..." << std::endl;
+            llama_model_free(small_model);
+            small_model = nullptr;
+        }
+
         if (model)
         {
             std::cout << "[Daemon] Freeing model..." << std::endl;
@@ -1086,8 +2560,16 @@ public:
         std::cout << "[Daemon] Freeing llama backend..." << std::endl;
         llama_backend_free();
 
-        std::cout << "[Daemon] Removing PID file..." << std::endl;
-        unlink("../../../ai_daemon.pid");
+        // A retired, replaced or never activated daemon leaves the files of the serving one alone
+        pid_t pid_in_file = -1;
+        std::ifstream pid_file("../../../ai_daemon.pid");
+        pid_file >> pid_in_file;
+        if (pid_in_file == getpid())
+        {
+            std::cout << "[Daemon] Removing PID file..." << std::endl;
+            unlink("../../../ai_daemon.pid");
+            unlink(STATUS_FILE);
+        }
 
         std::cout << "[Daemon] Cleanup complete" << std::endl;
     }
@@ -1096,6 +2578,9 @@ public:
 int main(int argc, char *argv[])
 {
     std::string model_path = "../../../model/gpt-oss-20b-Q5_K_M.gguf";
+    std::string small_model_path = ""; // Optional small model tier
+    int port = 8765;
+    bool standby = false;
 
     // Parse command line arguments
     for (int i = 1; i < argc; i++)
@@ -1110,6 +2595,18 @@ int main(int argc, char *argv[])
         {
             model_path = arg.substr(8); // Skip "--model="
         }
+        else if (arg.find("--small-model=") == 0)
+        {
+            small_model_path = arg.substr(14); // Skip "--small-model="
+        }
+        else if (arg.find("--port=") == 0)
+        {
+            port = std::atoi(arg.substr(7).c_str()); // Skip "--port="
+        }
+        else if (arg == "--standby")
+        {
+            standby = true; // Hot model swap: load next to the serving daemon until activated
+        }
         else if (i == 1 && arg[0] != '-')
         {
             // First non-flag argument is model path (backward compatibility)
@@ -1119,6 +2616,8 @@ int main(int argc, char *argv[])
 
     std::cout << "[Daemon] ========== AI DAEMON STARTUP ==========" << std::endl;
     std::cout << "[Daemon] Starting AI Daemon with model: " << model_path << std::endl;
+    std::cout << "[Daemon] Small model tier: " << (small_model_path.empty() ? "disabled" : small_model_path) << std::endl;
+    std::cout << "[Daemon] Port: " << port << (standby ? " (standby)" : "") << std::endl;
     std::cout << "[Daemon] Process ID: " << getpid() << std::endl;
     std::cout << "[Daemon] Working directory: " << std::filesystem::current_path() << std::endl;
     std::cout << "[Daemon] Test mode: " << (g_test_mode ? "ENABLED" : "DISABLED") << std::endl;
@@ -1133,7 +2632,7 @@ int main(int argc, char *argv[])
     try
     {
         std::cout << "[Daemon] Creating daemon instance..." << std::endl;
-        AIDaemon daemon(model_path);
+        AIDaemon daemon(model_path, small_model_path, port, standby);
 
         std::cout << "[Daemon] Starting daemon run loop..." << std::endl;
         daemon.run();
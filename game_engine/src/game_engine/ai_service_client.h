@@ -5,20 +5,78 @@
 
 #include <string>
 #include <filesystem>
+#include <fstream>
+#include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <nlohmann/json.hpp>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "request_deadline.h"
+
+// Which AI Daemon serves contract traffic. The daemon manager records the serving daemon
+// in ../../../ai_daemon.endpoint; during a hot model swap the standby loading next to it is
+// recorded in ../../../ai_daemon.standby and promoted by renaming that file over the
+// endpoint file, so every connection goes either to the old daemon or to the new one.
+struct DaemonEndpoint {
+    static constexpr const char* ACTIVE_FILE = "../../../ai_daemon.endpoint";
+    static constexpr const char* STANDBY_FILE = "../../../ai_daemon.standby";
+    static constexpr int DEFAULT_PORT = 8765;
+
+    int port = DEFAULT_PORT;
+    pid_t pid = -1;
+    std::string identity;   // Model and daemon binary the process was started with
+
+    static bool load(const std::string& path, DaemonEndpoint& endpoint) {
+        std::ifstream file(path);
+        if (!file) return false;
+        nlohmann::json j = nlohmann::json::parse(file, nullptr, false);
+        if (!j.is_object()) return false;
+        endpoint.port = j.value("port", DEFAULT_PORT);
+        endpoint.pid = j.value("pid", -1);
+        endpoint.identity = j.value("identity", "");
+        return true;
+    }
+
+    bool save(const std::string& path) const {
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::trunc);
+            if (!file) return false;
+            file << nlohmann::json{{"port", port}, {"pid", pid}, {"identity", identity}}.dump();
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        return !ec;
+    }
+
+    static int activePort() {
+        DaemonEndpoint endpoint;
+        return load(ACTIVE_FILE, endpoint) ? endpoint.port : DEFAULT_PORT;
+    }
+
+    // A standby always listens on the port the serving daemon does not use
+    static int otherPort(int port) {
+        return port == DEFAULT_PORT ? DEFAULT_PORT + 1 : DEFAULT_PORT;
+    }
+};
 
 class AIServiceClient {
 private:
     std::string daemon_host = "127.0.0.1";
-    int daemon_port = 8765;
     int connect_timeout_ms = 5000;
+    int generation_timeout_ms = 180000;   // Stamped on generation requests as deadline_ms
     
-    int connectToDaemon() {
+    // The serving daemon unless a port is given
+    int connectToDaemon(int daemon_port = 0) {
+        if (daemon_port <= 0) {
+            daemon_port = DaemonEndpoint::activePort();
+        }
         int sock = socket(AF_INET, SOCK_STREAM, 0);
         if (sock == -1) {
             std::cerr << "[Client] Failed to create socket: " << strerror(errno) << std::endl;
@@ -41,8 +99,34 @@ private:
         return sock;
     }
     
+    // Send a request, honouring the daemon's admission control: a "busy" reply
+    // carries retry_after_ms, so back off and retry a bounded number of times
     std::string sendRequest(const std::string& request, bool isStatusRequest = false) {
-        int sock = connectToDaemon();
+        const int maxAttempts = 3;
+        std::string response;
+        for (int attempt = 1; attempt <= maxAttempts; attempt++) {
+            response = sendRequestOnce(request, isStatusRequest);
+            if (response.find("\"status\":\"busy\"") == std::string::npos) {
+                return response;
+            }
+
+            int retryAfterMs = 1000;
+            try {
+                retryAfterMs = nlohmann::json::parse(response).value("retry_after_ms", 1000);
+            } catch (...) {}
+            retryAfterMs = std::min(std::max(retryAfterMs, 100), 5000);
+
+            std::cout << "[Client] Daemon busy - retrying in " << retryAfterMs << "ms (attempt "
+                      << attempt << "/" << maxAttempts << ")" << std::endl;
+            if (attempt < maxAttempts) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(retryAfterMs));
+            }
+        }
+        return response;
+    }
+
+    std::string sendRequestOnce(const std::string& request, bool isStatusRequest, int daemon_port = 0) {
+        int sock = connectToDaemon(daemon_port);
         if (sock == -1) {
             // For status requests, distinguish between "daemon not running" and "socket not ready"
             if (isStatusRequest) {
@@ -57,8 +141,14 @@ private:
             return "{\"error\":\"Failed to connect to AI daemon\"}";
         }
         
-        // Send request
-        if (send(sock, request.c_str(), request.length(), 0) == -1) {
+        // Send request - newline-terminated, the daemon reads up to the newline
+        std::string framed = request + "\n";
+        size_t sent = 0;
+        ssize_t n = 0;
+        while (sent < framed.length() && (n = send(sock, framed.c_str() + sent, framed.length() - sent, MSG_NOSIGNAL)) > 0) {
+            sent += n;
+        }
+        if (sent < framed.length()) {
             std::cerr << "[Client] Failed to send request" << std::endl;
             close(sock);
             if (isStatusRequest) {
@@ -78,12 +168,22 @@ private:
             timeout.tv_sec = 10;  // 10 seconds for status requests
             timeout.tv_usec = 0;
             setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        } else {
+            // Wait slightly past the request deadline so the daemon's cancellation reply arrives first
+            struct timeval timeout;
+            timeout.tv_sec = generation_timeout_ms / 1000 + 5;
+            timeout.tv_usec = 0;
+            setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
         }
         
-        bytes_received = recv(sock, buffer, sizeof(buffer) - 1, 0);
+        // The daemon closes the connection after replying - read until EOF
+        std::string response;
+        while ((bytes_received = recv(sock, buffer, sizeof(buffer), 0)) > 0) {
+            response.append(buffer, bytes_received);
+        }
         close(sock);
         
-        if (bytes_received <= 0) {
+        if (response.empty()) {
             if (isStatusRequest) {
                 if (bytes_received == 0) {
                     return "{\"status\":\"socket_unavailable\",\"error\":\"Daemon closed connection - may be busy loading model\"}";
@@ -94,11 +194,13 @@ private:
             return "{\"error\":\"Failed to receive response\"}";
         }
         
-        buffer[bytes_received] = '\0';
-        return std::string(buffer);
+        return response;
     }
     
 public:
+    // Upper bound on worlds in one create_game_batch request; the daemon rejects larger ones
+    static constexpr size_t MAX_CREATE_BATCH = 4;
+
     // Test daemon connectivity with model loading awareness
     bool isDaemonRunning() {
         nlohmann::json request;
@@ -170,12 +272,38 @@ public:
         }
     }
     
-    // Game creation (replaces AIGameEngine::createGame)
-    std::string createGame(const std::string& userPrompt, const std::string& userIdHex = "") {
+    // Hot model swap: requests to one daemon by port rather than to the serving one.
+    // Status of that daemon ("ready", "loading", "error"), empty when it cannot be reached.
+    std::string daemonStatusOn(int port) {
+        std::string response = sendRequestOnce("{\"type\":\"ping\"}", true, port);
+        nlohmann::json resp_json = nlohmann::json::parse(response, nullptr, false);
+        std::string status = resp_json.is_object() ? resp_json.value("status", "") : "";
+        return status == "socket_unavailable" ? "" : status;
+    }
+
+    // Let a standby daemon write the PID and status files and refill the world pool
+    bool activateDaemon(int port) {
+        return sendRequestOnce("{\"type\":\"activate\"}", true, port).find("\"model_loaded\"") != std::string::npos;
+    }
+
+    // Ask a replaced daemon to hand its narrative tickets to the successor, finish what it
+    // accepted and exit
+    bool retireDaemon(int port, int successorPort) {
+        nlohmann::json request;
+        request["type"] = "retire";
+        request["successor_port"] = successorPort;
+        return sendRequestOnce(request.dump(), true, port).find("\"retiring\"") != std::string::npos;
+    }
+
+    // Game creation (replaces AIGameEngine::createGame). usePool lets the daemon answer from
+    // its node-local world pool, so only callers that accept a node-specific world set it.
+    std::string createGame(const std::string& userPrompt, const std::string& userIdHex = "", bool usePool = false) {
         nlohmann::json request;
         request["type"] = "create_game";
         request["prompt"] = userPrompt;
         request["user_id"] = userIdHex;
+        request["use_pool"] = usePool;
+        request["deadline_ms"] = RequestCancellation::deadlineIn(generation_timeout_ms);
         
         std::cout << "[Client] Requesting game creation..." << std::endl;
         std::string response = sendRequest(request.dump());
@@ -184,25 +312,87 @@ public:
         return response;
     }
     
-    // Player action processing (replaces AIGameEngine::processPlayerAction)
+    // Batched game creation - the daemon generates all worlds as parallel sequences
+    // sharing the creation template. Returns one response per prompt, in order (empty for a
+    // prompt the batch produced nothing for), or an empty vector if the batch failed;
+    // callers fall back to createGame for those prompts.
+    std::vector<std::string> createGames(const std::vector<std::string>& userPrompts, bool usePool = false) {
+        nlohmann::json request;
+        request["type"] = "create_game_batch";
+        request["prompts"] = userPrompts;
+        request["use_pool"] = usePool;
+        request["deadline_ms"] = RequestCancellation::deadlineIn(generation_timeout_ms);
+
+        std::cout << "[Client] Requesting batched creation of " << userPrompts.size() << " games..." << std::endl;
+        std::string response = sendRequest(request.dump());
+
+        std::vector<std::string> results;
+        try {
+            nlohmann::json resp_json = nlohmann::json::parse(response);
+            if (resp_json.contains("results") && resp_json["results"].is_array() &&
+                resp_json["results"].size() == userPrompts.size()) {
+                results = resp_json["results"].get<std::vector<std::string>>();
+            } else {
+                std::cout << "[Client] Batched creation failed: " << response.substr(0, 200) << std::endl;
+            }
+        } catch (...) {
+            std::cout << "[Client] Failed to parse batched creation response" << std::endl;
+        }
+        return results;
+    }
+
+    // Player action processing (replaces AIGameEngine::processPlayerAction).
+    // With a world hash the world text is only sent when the daemon does not have it cached.
+    // With deferNarrative the daemon answers with the structured state and an empty Messages
+    // list; the narrative is fetched afterwards with fetchNarrative. useCache lets the
+    // daemon answer from its semantic action cache (a node-local, near-match answer).
     std::string processPlayerAction(const std::string& gameId, const std::string& action, 
                                   const std::string& currentGameState = "", const std::string& gameWorld = "",
-                                  bool continue_conversation = false) {
+                                  bool continue_conversation = false, const std::string& worldHash = "",
+                                  bool deferNarrative = false, bool useCache = false) {
         nlohmann::json request;
         request["type"] = "player_action";
         request["game_id"] = gameId;
         request["action"] = action;
         request["game_state"] = currentGameState;
-        request["game_world"] = gameWorld;
+        if (worldHash.empty()) {
+            request["game_world"] = gameWorld;
+        } else {
+            request["world_hash"] = worldHash;
+        }
         request["continue_conversation"] = continue_conversation;
+        request["use_cache"] = useCache;
+        if (deferNarrative) {
+            request["narrative"] = "deferred";
+        }
+        request["deadline_ms"] = RequestCancellation::deadlineIn(generation_timeout_ms);
         
         std::cout << "[Client] Processing player action..." << std::endl;
         std::string response = sendRequest(request.dump());
+        if (!worldHash.empty() && response.find("\"status\":\"world_cache_miss\"") != std::string::npos) {
+            std::cout << "[Client] Daemon does not have world " << worldHash << " cached - resending with the world" << std::endl;
+            request["game_world"] = gameWorld;
+            response = sendRequest(request.dump());
+        }
         std::cout << "[Client] Action processing response received" << std::endl;
         
         return response;
     }
     
+    // Narrative of a two-phase turn, addressed by the turn (game, state before it, action).
+    // {"status":"ready","narrative":...}, or "pending" / "failed" / "unknown" after waiting up to waitMs.
+    std::string fetchNarrative(const std::string& gameId, const std::string& action,
+                               const std::string& gameStateBefore, int waitMs = 0) {
+        nlohmann::json request;
+        request["type"] = "narrative";
+        request["game_id"] = gameId;
+        request["action"] = action;
+        request["game_state"] = gameStateBefore;
+        request["wait_ms"] = waitMs;
+
+        return sendRequest(request.dump(), true);  // Cheap lookup - status request timeouts
+    }
+
     // Get daemon status information
     std::string getDaemonStatus() {
         nlohmann::json request;
@@ -7,7 +7,9 @@
 #include <unistd.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
 #include <poll.h>
+#include <sys/socket.h>
 #include <sys/uio.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
@@ -27,6 +29,7 @@ const char *__HP_PATCH_FILE_PATH = "../patch.cfg";
 #define HP_PRIVATE_KEY_SIZE 130 // Hex public_key size. (128 char key + 2 chars for key type prefix)
 #define HP_HASH_SIZE 64         // Hex hash size.
 #define HP_CONTRACT_ID_SIZE 36  // Contract Id UUIDv4 string length.
+#define HP_NPL_BATCH_MAX 32     // Max NPL messages drained by one hp_read_npl_batch call.
 const char *HP_POST_EXEC_SCRIPT_NAME = "post_exec.sh";
 
 #define __HP_ASSIGN_STRING(dest, elem)                                                        \
@@ -224,15 +227,51 @@ struct hp_contract_context
     struct hp_unl_collection unl;
 };
 
+// A received NPL message. Both pointers borrow from the NPL arena and stay valid
+// until the next hp_read_npl_batch call.
+struct hp_npl_msg
+{
+    const char *sender; // Sender public_key (hex), null terminated.
+    const void *data;
+    size_t len;
+};
+
+typedef void (*hp_npl_msg_handler)(const struct hp_npl_msg *msg, void *user_data);
+
+// Receive buffers for batched NPL reads. Allocated on first use and reused by every
+// batch until hp_deinit_contract. Packet slots alternate public_key and data.
+struct __hp_npl_arena
+{
+    char *keys; // HP_NPL_BATCH_MAX slots of HP_PUBLIC_KEY_SIZE + 1
+    char *data; // HP_NPL_BATCH_MAX slots of HP_NPL_MSG_MAX_SIZE
+    struct iovec iovs[HP_NPL_BATCH_MAX * 2];
+    struct mmsghdr msgs[HP_NPL_BATCH_MAX * 2];
+};
+
+// Single allocation holding the contract context and its user, input and unl lists.
+// Sized from the parsed args before anything is copied, released in one free.
+struct __hp_args_arena
+{
+    char *base;
+    size_t size;
+    size_t used;
+};
+
 struct __hp_contract
 {
     struct hp_contract_context *cctx;
     int control_fd;
     void *user_inmap;
     size_t user_inmap_size;
+    struct __hp_args_arena args_arena;
+    struct __hp_npl_arena npl_arena;
 };
 
 int hp_init_contract();
+int hp_read_contract_args(char **args, size_t *args_len);
+int hp_init_contract_args(const char *args, const size_t len);
+size_t hp_get_contract_fds(int *fds, const size_t max);
+void hp_remap_contract_fds(const int *from, const int *to, const size_t count);
 int hp_deinit_contract();
 const struct hp_contract_context *hp_get_context();
 const void *hp_init_user_input_mmap();
@@ -242,6 +281,7 @@ int hp_writev_user_msg(const struct hp_user *user, const struct iovec *bufs, con
 int hp_write_npl_msg(const void *buf, const uint32_t len);
 int hp_writev_npl_msg(const struct iovec *bufs, const int buf_count);
 int hp_read_npl_msg(void *msg_buf, char *public_key_buf, const int timeout);
+int hp_read_npl_batch(hp_npl_msg_handler handler, void *user_data, const int timeout);
 struct hp_config *hp_get_config();
 int hp_update_config(const struct hp_config *config);
 int hp_update_peers(const char *add_peers[], const size_t add_peers_count, const char *remove_peers[], const size_t remove_peers_count);
@@ -250,7 +290,10 @@ void hp_set_config_unl(struct hp_config *config, const struct hp_public_key *new
 void hp_free_config(struct hp_config *config);
 
 void __hp_parse_args_json(const struct json_object_s *object);
+size_t __hp_get_args_arena_size(const struct json_object_s *object);
+void *__hp_args_arena_alloc(const size_t size);
 int __hp_write_control_msg(const void *buf, const uint32_t len);
+int __hp_remap_fd(const int fd, const int *from, const int *to, const size_t count);
 void __hp_populate_patch_from_json_object(struct hp_config *config, const struct json_object_s *object);
 int __hp_write_to_patch_file(const int fd, const struct hp_config *config);
 struct hp_config *__hp_read_from_patch_file(const int fd);
@@ -264,6 +307,23 @@ int hp_init_contract()
     if (__hpc.cctx)
         return -1; // Already initialized.
 
+    char *buf = NULL;
+    size_t len = 0;
+    if (hp_read_contract_args(&buf, &len) != 0)
+        return -1;
+
+    const int res = hp_init_contract_args(buf, len);
+    __HP_FREE(buf);
+    return res;
+}
+
+/**
+ * Read the contract args JSON Hot Pocket writes to stdin.
+ * @param args Set to a malloc'ed buffer the caller frees.
+ * @return 0 on success, -1 on error.
+ */
+int hp_read_contract_args(char **args, size_t *args_len)
+{
     // Check whether we are running from terminal and produce warning.
     if (isatty(STDIN_FILENO) == 1)
     {
@@ -271,33 +331,132 @@ int hp_init_contract()
         return -1;
     }
 
-    char buf[4096];
-    const ssize_t len = read(STDIN_FILENO, buf, sizeof(buf));
-    if (len == -1)
+    // Read the args to EOF. They grow with the UNL and user count, so no fixed buffer fits.
+    size_t capacity = 4096;
+    size_t len = 0;
+    char *buf = (char *)malloc(capacity);
+    while (buf)
+    {
+        const ssize_t res = read(STDIN_FILENO, buf + len, capacity - len);
+        if (res == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("Error when reading stdin.");
+            __HP_FREE(buf);
+            return -1;
+        }
+        if (res == 0)
+            break;
+
+        len += res;
+        if (len == capacity)
+        {
+            capacity *= 2;
+            char *grown = (char *)realloc(buf, capacity);
+            if (!grown)
+                __HP_FREE(buf);
+            buf = grown;
+        }
+    }
+    if (!buf)
     {
-        perror("Error when reading stdin.");
+        fprintf(stderr, "Error allocating contract args buffer.\n");
         return -1;
     }
 
-    struct json_value_s *root = json_parse(buf, len);
+    *args = buf;
+    *args_len = len;
+    return 0;
+}
+
+/**
+ * Initialize the contract from args read earlier (possibly by another process, see
+ * hp_remap_contract_fds).
+ * @return 0 on success, -1 on error.
+ */
+int hp_init_contract_args(const char *args, const size_t len)
+{
+    if (__hpc.cctx)
+        return -1; // Already initialized.
+
+    struct json_value_s *root = json_parse(args, len);
 
     if (root && root->type == json_type_object)
     {
         struct json_object_s *object = (struct json_object_s *)root->payload;
         if (object->length > 0)
         {
-            // Create and populate hotpocket context.
-            __hpc.cctx = (struct hp_contract_context *)malloc(sizeof(struct hp_contract_context));
-            __hp_parse_args_json(object);
-            __HP_FREE(root);
+            // Create and populate hotpocket context inside one zeroed arena sized for all its lists.
+            __hpc.args_arena.size = __hp_get_args_arena_size(object);
+            __hpc.args_arena.used = 0;
+            __hpc.args_arena.base = (char *)calloc(1, __hpc.args_arena.size);
+            if (__hpc.args_arena.base)
+            {
+                __hpc.cctx = (struct hp_contract_context *)__hp_args_arena_alloc(sizeof(struct hp_contract_context));
+                __hp_parse_args_json(object);
+                __HP_FREE(root);
 
-            return 0;
+                return 0;
+            }
         }
     }
     __HP_FREE(root);
     return -1;
 }
 
+/**
+ * The channel descriptors of the round (user input, user outputs, NPL, control).
+ * @return Number of descriptors, which may exceed max (only max are written).
+ */
+size_t hp_get_contract_fds(int *fds, const size_t max)
+{
+    struct hp_contract_context *cctx = __hpc.cctx;
+    if (!cctx)
+        return 0;
+
+    size_t count = 0;
+    const int single[3] = {cctx->users.in_fd, cctx->unl.npl_fd, __hpc.control_fd};
+    for (size_t i = 0; i < 3; i++, count++)
+    {
+        if (count < max)
+            fds[count] = single[i];
+    }
+    for (size_t u = 0; u < cctx->users.count; u++, count++)
+    {
+        if (count < max)
+            fds[count] = cctx->users.list[u].outfd;
+    }
+    return count;
+}
+
+/**
+ * Point the context at other descriptors for the same channels. Used by a process that
+ * received the round's fds over a Unix socket (SCM_RIGHTS), where they have new numbers.
+ */
+void hp_remap_contract_fds(const int *from, const int *to, const size_t count)
+{
+    struct hp_contract_context *cctx = __hpc.cctx;
+    if (!cctx)
+        return;
+
+    cctx->users.in_fd = __hp_remap_fd(cctx->users.in_fd, from, to, count);
+    for (size_t u = 0; u < cctx->users.count; u++)
+        cctx->users.list[u].outfd = __hp_remap_fd(cctx->users.list[u].outfd, from, to, count);
+    cctx->unl.npl_fd = __hp_remap_fd(cctx->unl.npl_fd, from, to, count);
+    __hpc.control_fd = __hp_remap_fd(__hpc.control_fd, from, to, count);
+}
+
+int __hp_remap_fd(const int fd, const int *from, const int *to, const size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (fd == from[i])
+            return to[i];
+    }
+    return fd;
+}
+
 int hp_deinit_contract()
 {
     struct hp_contract_context *cctx = __hpc.cctx;
@@ -314,18 +473,14 @@ int hp_deinit_contract()
         close(cctx->users.list[i].outfd);
     close(cctx->unl.npl_fd);
 
-    // Cleanup user list allocation.
-    if (cctx->users.list)
-    {
-        for (size_t i = 0; i < cctx->users.count; i++)
-            __HP_FREE(cctx->users.list[i].inputs.list);
-
-        __HP_FREE(cctx->users.list);
-    }
-    // Cleanup unl list allocation.
-    __HP_FREE(cctx->unl.list);
-    // Cleanup contract context.
-    __HP_FREE(cctx);
+    // Cleanup NPL arena.
+    __HP_FREE(__hpc.npl_arena.keys);
+    __HP_FREE(__hpc.npl_arena.data);
+    // Cleanup contract context along with its user, input and unl lists.
+    __HP_FREE(__hpc.args_arena.base);
+    __hpc.args_arena.size = 0;
+    __hpc.args_arena.used = 0;
+    __hpc.cctx = NULL;
 
     close(__hpc.control_fd);
     return 0;
@@ -490,6 +645,104 @@ int hp_read_npl_msg(void *msg_buf, char *public_key_buf, const int timeout)
     return 0;
 }
 
+/**
+ * Reads up to HP_NPL_BATCH_MAX ready NPL messages in one pass, waiting up to 'timeout'
+ * milliseconds for the first one. Public_key and data packets are received together
+ * with recvmmsg into the reusable NPL arena, and each complete message is passed to
+ * 'handler' in arrival order. Messages beyond the cap stay queued; to drain the
+ * channel, call again with timeout 0 until it returns 0.
+ * @param handler Called once per message. The message borrows arena memory.
+ * @param user_data Passed through to the handler.
+ * @param timeout Maximum milliseconds to wait until a message arrives. If 0, returns immediately.
+ *                If -1, waits forever until message arrives.
+ * @return Number of messages handled. 0 if no message arrived within timeout. -1 on error.
+ */
+int hp_read_npl_batch(hp_npl_msg_handler handler, void *user_data, const int timeout)
+{
+    struct __hp_npl_arena *arena = &__hpc.npl_arena;
+    if (!arena->keys)
+    {
+        // Untouched pages of the data slots are never committed, so sizing for a full batch is cheap.
+        arena->keys = (char *)malloc(HP_NPL_BATCH_MAX * (HP_PUBLIC_KEY_SIZE + 1));
+        arena->data = (char *)malloc((size_t)HP_NPL_BATCH_MAX * HP_NPL_MSG_MAX_SIZE);
+        if (!arena->keys || !arena->data)
+        {
+            __HP_FREE(arena->keys);
+            __HP_FREE(arena->data);
+            fprintf(stderr, "NPL arena allocation failed.\n");
+            return -1;
+        }
+        for (int i = 0; i < HP_NPL_BATCH_MAX; i++)
+        {
+            arena->iovs[i * 2].iov_base = arena->keys + i * (HP_PUBLIC_KEY_SIZE + 1);
+            arena->iovs[i * 2].iov_len = HP_PUBLIC_KEY_SIZE;
+            arena->iovs[i * 2 + 1].iov_base = arena->data + (size_t)i * HP_NPL_MSG_MAX_SIZE;
+            arena->iovs[i * 2 + 1].iov_len = HP_NPL_MSG_MAX_SIZE;
+        }
+    }
+
+    struct pollfd pfd = {__hpc.cctx->unl.npl_fd, POLLIN, 0};
+    if (poll(&pfd, 1, timeout) == -1)
+    {
+        perror("NPL channel batch poll error");
+        return -1;
+    }
+    else if (pfd.revents & (POLLHUP | POLLERR | POLLNVAL))
+    {
+        fprintf(stderr, "NPL channel batch poll returned error: %d\n", pfd.revents);
+        return -1;
+    }
+    else if (!(pfd.revents & POLLIN))
+    {
+        return 0;
+    }
+
+    memset(arena->msgs, 0, sizeof(arena->msgs));
+    for (int i = 0; i < HP_NPL_BATCH_MAX * 2; i++)
+    {
+        arena->msgs[i].msg_hdr.msg_iov = &arena->iovs[i];
+        arena->msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int packets = recvmmsg(pfd.fd, arena->msgs, HP_NPL_BATCH_MAX * 2, MSG_DONTWAIT, NULL);
+    if (packets == -1)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return 0;
+        perror("Error reading NPL batch");
+        return -1;
+    }
+
+    // The batch may end between a public_key and its data packet. The data follows
+    // immediately, so wait briefly for it as hp_read_npl_msg does.
+    if (packets % 2 == 1)
+    {
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 100) > 0 && (pfd.revents & POLLIN))
+        {
+            const ssize_t readres = read(pfd.fd, arena->iovs[packets].iov_base, HP_NPL_MSG_MAX_SIZE);
+            if (readres >= 0)
+            {
+                arena->msgs[packets].msg_len = (unsigned int)readres;
+                packets++;
+            }
+        }
+        if (packets % 2 == 1)
+            packets--; // Drop the public_key without data.
+    }
+
+    const int count = packets / 2;
+    for (int i = 0; i < count; i++)
+    {
+        char *sender = (char *)arena->iovs[i * 2].iov_base;
+        sender[arena->msgs[i * 2].msg_len] = '\0';
+
+        struct hp_npl_msg msg = {sender, arena->iovs[i * 2 + 1].iov_base, arena->msgs[i * 2 + 1].msg_len};
+        handler(&msg, user_data);
+    }
+    return count;
+}
+
 /**
  * Get the existing config file values.
  * @return returns a pointer to a config structure, returns NULL on error.
@@ -1051,6 +1304,58 @@ void __hp_populate_patch_from_json_object(struct hp_config *config, const struct
     } while (elem);
 }
 
+#define __HP_ARENA_ALIGN(x) (((x) + 15) & ~((size_t)15))
+
+/**
+ * Bytes needed by the args arena: the context plus the user, input and unl lists
+ * described by the args, each aligned.
+ */
+size_t __hp_get_args_arena_size(const struct json_object_s *object)
+{
+    size_t size = __HP_ARENA_ALIGN(sizeof(struct hp_contract_context));
+
+    for (const struct json_object_element_s *elem = object->start; elem; elem = elem->next)
+    {
+        if (strcmp(elem->name->string, "users") == 0 && elem->value->type == json_type_object)
+        {
+            const struct json_object_s *user_object = (struct json_object_s *)elem->value->payload;
+            size += __HP_ARENA_ALIGN(sizeof(struct hp_user) * user_object->length);
+
+            for (const struct json_object_element_s *user_elem = user_object->start; user_elem; user_elem = user_elem->next)
+            {
+                if (user_elem->value->type == json_type_array)
+                {
+                    const struct json_array_s *arr = (struct json_array_s *)user_elem->value->payload;
+                    if (arr->length > 1)
+                        size += __HP_ARENA_ALIGN(sizeof(struct hp_user_input) * (arr->length - 1));
+                }
+            }
+        }
+        else if (strcmp(elem->name->string, "unl") == 0 && elem->value->type == json_type_object)
+        {
+            const struct json_object_s *unl_obj = (struct json_object_s *)elem->value->payload;
+            size += __HP_ARENA_ALIGN(sizeof(struct hp_unl_node) * unl_obj->length);
+        }
+    }
+    return size;
+}
+
+/**
+ * Carves a zeroed block out of the args arena. Returns NULL if the arena is exhausted,
+ * which cannot happen for blocks accounted for by __hp_get_args_arena_size.
+ */
+void *__hp_args_arena_alloc(const size_t size)
+{
+    struct __hp_args_arena *arena = &__hpc.args_arena;
+    const size_t aligned = __HP_ARENA_ALIGN(size);
+    if (arena->used + aligned > arena->size)
+        return NULL;
+
+    void *ptr = arena->base + arena->used;
+    arena->used += aligned;
+    return ptr;
+}
+
 void __hp_parse_args_json(const struct json_object_s *object)
 {
     const struct json_object_element_s *elem = object->start;
@@ -1100,7 +1405,7 @@ void __hp_parse_args_json(const struct json_object_s *object)
                 const size_t user_count = user_object->length;
 
                 cctx->users.count = user_count;
-                cctx->users.list = user_count ? (struct hp_user *)malloc(sizeof(struct hp_user) * user_count) : NULL;
+                cctx->users.list = user_count ? (struct hp_user *)__hp_args_arena_alloc(sizeof(struct hp_user) * user_count) : NULL;
 
                 if (user_count > 0)
                 {
@@ -1121,7 +1426,7 @@ void __hp_parse_args_json(const struct json_object_s *object)
 
                             // Subsequent elements are tupels of [offset, size] of input messages for this user.
                             user->inputs.count = arr->length - 1;
-                            user->inputs.list = user->inputs.count ? (struct hp_user_input *)malloc(user->inputs.count * sizeof(struct hp_user_input)) : NULL;
+                            user->inputs.list = user->inputs.count ? (struct hp_user_input *)__hp_args_arena_alloc(user->inputs.count * sizeof(struct hp_user_input)) : NULL;
                             for (size_t i = 0; i < user->inputs.count; i++)
                             {
                                 if (arr_elem->value->type == json_type_array)
@@ -1154,7 +1459,7 @@ void __hp_parse_args_json(const struct json_object_s *object)
                 const size_t unl_count = unl_obj->length;
 
                 cctx->unl.count = unl_count;
-                cctx->unl.list = unl_count ? (struct hp_unl_node *)malloc(sizeof(struct hp_unl_node) * unl_count) : NULL;
+                cctx->unl.list = unl_count ? (struct hp_unl_node *)__hp_args_arena_alloc(sizeof(struct hp_unl_node) * unl_count) : NULL;
 
                 if (unl_count > 0)
                 {
@@ -0,0 +1,133 @@
+#ifndef NARRATIVE_TICKETS_H
+#define NARRATIVE_TICKETS_H
+
+// Narratives of two-phase player turns in the AI daemon. A deferred-narrative turn
+// answers with the structured state right away and leaves the narrative to a
+// background job; the job and its result are addressed by a ticket derived from the
+// turn itself (game id, state before the turn, action), so the contract can ask for
+// it in a later round without the turn response carrying anything extra.
+// Finished narratives are kept for a bounded number of turns, oldest dropped first.
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "content_hash.h"
+
+class NarrativeTickets {
+public:
+    enum class Status {
+        Ready,     // Narrative generated
+        Pending,   // Job queued or running
+        Failed,    // Generation produced nothing usable
+        Unknown    // Never opened here, or already dropped
+    };
+
+    explicit NarrativeTickets(size_t maxTickets = 128) : maxEntries(maxTickets) {}
+
+    static uint64_t ticketOf(const std::string& gameId, const std::string& gameState, const std::string& action) {
+        uint64_t hash = ContentHash::fnv1a64(gameId);
+        hash = ContentHash::fnv1a64(gameState.data(), gameState.size(), hash);
+        return ContentHash::fnv1a64(action.data(), action.size(), hash);
+    }
+
+    static const char* statusName(Status status) {
+        switch (status) {
+            case Status::Ready: return "ready";
+            case Status::Pending: return "pending";
+            case Status::Failed: return "failed";
+            case Status::Unknown: return "unknown";
+        }
+        return "unknown";
+    }
+
+    // Register a job for the ticket. False when it is already pending or done
+    // (a retried turn), in which case no second job should be started.
+    bool open(uint64_t ticket) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (entries.count(ticket)) return false;
+        entries[ticket] = Entry{};
+        order.push_back(ticket);
+        evict();
+        return true;
+    }
+
+    void complete(uint64_t ticket, const std::string& narrative) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = entries.find(ticket);
+            if (it == entries.end()) return;
+            it->second.status = narrative.empty() ? Status::Failed : Status::Ready;
+            it->second.narrative = narrative;
+        }
+        ready.notify_all();
+    }
+
+    // Status of a ticket, waiting up to waitMs while its job is still pending
+    Status wait(uint64_t ticket, int waitMs, std::string& narrative) {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto done = [this, ticket] {
+            auto it = entries.find(ticket);
+            return it == entries.end() || it->second.status != Status::Pending;
+        };
+        if (waitMs > 0) {
+            ready.wait_for(lock, std::chrono::milliseconds(waitMs), done);
+        }
+        auto it = entries.find(ticket);
+        if (it == entries.end()) return Status::Unknown;
+        narrative = it->second.narrative;
+        return it->second.status;
+    }
+
+    struct Ticket {
+        uint64_t ticket;
+        Status status;
+        std::string narrative;
+    };
+
+    // Every ticket held, oldest first - handed to a successor daemon on a hot swap,
+    // which takes them over with open() and, once finished, complete()
+    std::vector<Ticket> snapshot() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<Ticket> tickets;
+        for (uint64_t ticket : order) {
+            auto it = entries.find(ticket);
+            if (it != entries.end()) tickets.push_back({ticket, it->second.status, it->second.narrative});
+        }
+        return tickets;
+    }
+
+private:
+    struct Entry {
+        Status status = Status::Pending;
+        std::string narrative;
+    };
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::unordered_map<uint64_t, Entry> entries;
+    std::deque<uint64_t> order;   // Oldest ticket first
+    size_t maxEntries;
+
+    // Drop the oldest finished tickets beyond the bound; running jobs keep theirs
+    void evict() {
+        size_t scanned = 0;
+        while (entries.size() > maxEntries && scanned < order.size()) {
+            uint64_t oldest = order.front();
+            order.pop_front();
+            auto it = entries.find(oldest);
+            if (it != entries.end() && it->second.status == Status::Pending) {
+                order.push_back(oldest);
+                scanned++;
+            } else {
+                entries.erase(oldest);
+            }
+        }
+    }
+};
+
+#endif // NARRATIVE_TICKETS_H
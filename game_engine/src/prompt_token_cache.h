@@ -0,0 +1,129 @@
+#ifndef PROMPT_TOKEN_CACHE_H
+#define PROMPT_TOKEN_CACHE_H
+
+// Token cache for prompt assembly in the AI daemons.
+// Static prompt fragments (system prompts, templates, jury instructions) are tokenized
+// once per model vocabulary and kept for the daemon lifetime. Large dynamic texts such
+// as game worlds are tokenized once and cached by content hash with LRU eviction; an entry
+// keeps its text and is only reused for an identical one.
+// Prompts are then assembled by concatenating token vectors instead of re-tokenizing
+// the full concatenated string on every request.
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "content_hash.h"
+#include "../llama.cpp/include/llama.h"
+
+class PromptTokenCache {
+public:
+    using Tokens = std::vector<llama_token>;
+
+    explicit PromptTokenCache(size_t maxCachedTexts = 32) : maxEntries(maxCachedTexts) {}
+
+    // Bind to a model vocabulary; cached tokens are dropped if the vocabulary changes
+    void bind(const llama_vocab* newVocab) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (vocab != newVocab) {
+            vocab = newVocab;
+            fragments.clear();
+            texts.clear();
+            lru.clear();
+        }
+    }
+
+    bool isBound() const { return vocab != nullptr; }
+
+    // Register a static fragment; tokenized immediately so the request path never does
+    void addFragment(int id, const std::string& text, bool addSpecial = false) {
+        Tokens tokens;
+        tokenize(text, addSpecial, tokens);
+        std::lock_guard<std::mutex> lock(mutex);
+        fragments[id] = std::move(tokens);
+    }
+
+    // Tokens of a registered fragment (empty if never registered)
+    const Tokens& fragment(int id) const {
+        static const Tokens empty;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = fragments.find(id);
+        return it == fragments.end() ? empty : it->second;
+    }
+
+    // Tokens of a large dynamic text, cached by content hash
+    std::shared_ptr<const Tokens> text(const std::string& content) {
+        uint64_t key = ContentHash::fnv1a64(content);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = texts.find(key);
+            if (it != texts.end() && it->second.content == content) {
+                lru.splice(lru.begin(), lru, it->second.lruPosition);
+                hits++;
+                return it->second.tokens;
+            }
+        }
+
+        auto tokens = std::make_shared<Tokens>();
+        tokenize(content, false, *tokens);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        misses++;
+        auto it = texts.find(key);
+        if (it != texts.end()) {
+            if (it->second.content == content) {
+                return it->second.tokens;  // Another request tokenized it meanwhile
+            }
+            lru.erase(it->second.lruPosition);  // Hash collision: the newer text takes the slot
+            texts.erase(it);
+        }
+        lru.push_front(key);
+        texts[key] = {content, tokens, lru.begin()};
+        while (texts.size() > maxEntries) {
+            texts.erase(lru.back());
+            lru.pop_back();
+        }
+        return tokens;
+    }
+
+    // Single-pass tokenization: size the buffer from the byte count (a token never
+    // covers less than one byte) instead of calling llama_tokenize twice
+    bool tokenize(const std::string& content, bool addSpecial, Tokens& out) const {
+        out.resize(content.size() + 2);
+        int n = llama_tokenize(vocab, content.c_str(), content.size(), out.data(), out.size(), addSpecial, true);
+        if (n < 0) {
+            out.resize(-n);
+            n = llama_tokenize(vocab, content.c_str(), content.size(), out.data(), out.size(), addSpecial, true);
+        }
+        out.resize(n > 0 ? n : 0);
+        return n >= 0;
+    }
+
+    // Append tokens to a prompt under assembly
+    static void append(Tokens& prompt, const Tokens& part) {
+        prompt.insert(prompt.end(), part.begin(), part.end());
+    }
+
+    size_t hitCount() const { return hits; }
+    size_t missCount() const { return misses; }
+
+private:
+    struct CachedText {
+        std::string content;
+        std::shared_ptr<const Tokens> tokens;
+        std::list<uint64_t>::iterator lruPosition;
+    };
+
+    const llama_vocab* vocab = nullptr;
+    size_t maxEntries;
+    mutable std::mutex mutex;
+    std::unordered_map<int, Tokens> fragments;
+    std::unordered_map<uint64_t, CachedText> texts;
+    std::list<uint64_t> lru;
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+#endif // PROMPT_TOKEN_CACHE_H
@@ -0,0 +1,130 @@
+#ifndef REQUEST_DEADLINE_H
+#define REQUEST_DEADLINE_H
+
+// Request deadlines and cooperative cancellation for the AI daemons.
+// Clients stamp each request with "deadline_ms" (absolute Unix epoch milliseconds,
+// the moment they stop waiting for the reply). The daemon attaches a
+// RequestCancellation to the job and the decode loops poll shouldStop(): generation
+// aborts once the deadline has passed or every client waiting on the job has closed
+// its connection, so abandoned work releases its context and worker slot immediately.
+// Coalesced requests register additional clients; the job keeps running while any of
+// them is still connected and within its deadline.
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+
+class RequestCancellation {
+public:
+    RequestCancellation() = default;
+
+    RequestCancellation(int clientFd, int64_t deadlineMs) {
+        addClient(clientFd, deadlineMs);
+    }
+
+    static int64_t nowUnixMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Deadline stamp for a client that will wait timeoutMs for the reply
+    static int64_t deadlineIn(int64_t timeoutMs) {
+        return nowUnixMs() + timeoutMs;
+    }
+
+    // Register a client waiting on this job. deadlineMs 0 means no deadline.
+    void addClient(int clientFd, int64_t deadlineMs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        clients.push_back({clientFd, deadlineMs, true});
+    }
+
+    // Cheap enough to call once per generated token: one clock read plus a
+    // non-blocking poll per registered client
+    bool shouldStop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (cancelled) return true;
+        if (clients.empty()) return false;
+
+        int64_t now = nowUnixMs();
+        bool anyoneWaiting = false;
+        bool anyoneInTime = false;
+        for (auto& client : clients) {
+            if (client.connected && client.fd >= 0 && !isSocketAlive(client.fd)) {
+                client.connected = false;
+            }
+            if (client.connected) {
+                anyoneWaiting = true;
+                if (client.deadlineMs == 0 || now < client.deadlineMs) {
+                    anyoneInTime = true;
+                }
+            }
+        }
+
+        if (!anyoneWaiting) {
+            cancelled = true;
+            stopReason = "client_disconnected";
+        } else if (!anyoneInTime) {
+            cancelled = true;
+            stopReason = "deadline_exceeded";
+        }
+        return cancelled;
+    }
+
+    // Cancel from outside the job, e.g. to preempt background work
+    void cancel(const std::string& why) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!cancelled) {
+            cancelled = true;
+            stopReason = why;
+        }
+    }
+
+    bool isCancelled() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return cancelled;
+    }
+
+    std::string reason() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stopReason;
+    }
+
+    std::string errorResponse() const {
+        return "{\"error\":\"cancelled\",\"reason\":\"" + reason() + "\"}";
+    }
+
+    // A connected peer with nothing to read polls as not readable; a closed peer
+    // reports hang-up or reads zero bytes
+    static bool isSocketAlive(int fd) {
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = POLLIN | POLLRDHUP;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 0) < 0) return true;
+        if (pfd.revents & (POLLRDHUP | POLLHUP | POLLERR | POLLNVAL)) return false;
+        if (pfd.revents & POLLIN) {
+            char probe;
+            ssize_t n = recv(fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+            return n != 0;
+        }
+        return true;
+    }
+
+private:
+    struct Client {
+        int fd;
+        int64_t deadlineMs;
+        bool connected;
+    };
+
+    mutable std::mutex mutex;
+    std::vector<Client> clients;
+    bool cancelled = false;
+    std::string stopReason;
+};
+
+#endif // REQUEST_DEADLINE_H
@@ -0,0 +1,264 @@
+#ifndef REQUEST_SCHEDULER_H
+#define REQUEST_SCHEDULER_H
+
+// Bounded priority work queue with admission control for the AI daemons.
+// Requests are grouped into priority classes (ping/status, blocking lookups, jury
+// validate, player action, turn narrative, game creation, background maintenance). Each class has its own concurrency limit and queue bound;
+// the worker pool is sized to the sum of the limits so a busy class can never starve
+// a higher-priority one (pings are answered while long generations run).
+// When a class queue is full the request is rejected immediately with a retry hint
+// instead of timing out on the contract side. Identical requests (same dedupe key)
+// that are already queued or running are coalesced onto the existing job, so a
+// contract that re-sends after a timeout attaches to the work instead of duplicating it.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Ordered by priority: lower value is served first
+enum class RequestClass {
+    Ping = 0,
+    Lookup = 1,      // Cheap but may wait on other work (narrative lookups), kept apart from pings
+    Validate = 2,
+    PlayerAction = 3,
+    Narrative = 4,   // Deferred narrative of a two-phase player turn
+    CreateGame = 5,
+    Background = 6   // Daemon-internal idle work (e.g. world pool refill)
+};
+
+static constexpr size_t kRequestClassCount = 7;
+
+inline const char* requestClassName(RequestClass cls) {
+    switch (cls) {
+        case RequestClass::Ping: return "ping";
+        case RequestClass::Lookup: return "lookup";
+        case RequestClass::Validate: return "validate";
+        case RequestClass::PlayerAction: return "player_action";
+        case RequestClass::Narrative: return "narrative";
+        case RequestClass::CreateGame: return "create_game";
+        case RequestClass::Background: return "background";
+    }
+    return "unknown";
+}
+
+class RequestScheduler {
+public:
+    using Work = std::function<std::string()>;
+    using Completion = std::function<void(const std::string&)>;
+
+    struct ClassLimits {
+        int maxConcurrent;   // Jobs of this class running at once
+        int maxQueued;       // Jobs waiting before new ones are rejected
+    };
+
+    enum class Admission {
+        Queued,      // New job accepted
+        Coalesced,   // Attached to an identical queued/running job
+        Rejected     // Class queue full - caller should answer busy
+    };
+
+    explicit RequestScheduler(const std::array<ClassLimits, kRequestClassCount>& limits) {
+        for (size_t i = 0; i < kRequestClassCount; i++) {
+            classes[i].limits = limits[i];
+        }
+    }
+
+    ~RequestScheduler() { stop(); }
+
+    void start() {
+        int workerCount = 0;
+        for (const auto& state : classes) {
+            workerCount += state.limits.maxConcurrent;
+        }
+        running = true;
+        for (int i = 0; i < workerCount; i++) {
+            workers.emplace_back(&RequestScheduler::workerLoop, this);
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!running) return;
+            running = false;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) {
+            if (worker.joinable()) worker.join();
+        }
+        workers.clear();
+    }
+
+    // Submit work for a class. dedupeKey 0 disables coalescing for this request.
+    // The completion runs on a worker thread with the work's result.
+    Admission submit(RequestClass cls, uint64_t dedupeKey, Work work, Completion done) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ClassState& state = classes[static_cast<size_t>(cls)];
+
+        if (dedupeKey != 0) {
+            auto existing = inflight.find(dedupeKey);
+            if (existing != inflight.end()) {
+                existing->second->waiters.push_back(std::move(done));
+                state.coalesced++;
+                return Admission::Coalesced;
+            }
+        }
+
+        if (static_cast<int>(state.queue.size()) >= state.limits.maxQueued) {
+            state.rejected++;
+            return Admission::Rejected;
+        }
+
+        auto job = std::make_shared<Job>();
+        job->cls = cls;
+        job->dedupeKey = dedupeKey;
+        job->work = std::move(work);
+        job->waiters.push_back(std::move(done));
+        job->enqueuedAt = std::chrono::steady_clock::now();
+
+        state.queue.push_back(job);
+        if (dedupeKey != 0) {
+            inflight[dedupeKey] = job;
+        }
+        wake.notify_one();
+        return Admission::Queued;
+    }
+
+    // Suggested client back-off for a class: expected wait for the queue ahead to drain
+    int retryAfterMs(RequestClass cls) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        const ClassState& state = classes[static_cast<size_t>(cls)];
+        double serviceMs = state.avgServiceMs > 0 ? state.avgServiceMs : 1000.0;
+        double waitMs = serviceMs * (state.queue.size() + state.running) / std::max(1, state.limits.maxConcurrent);
+        return std::max(100, static_cast<int>(waitMs));
+    }
+
+    size_t queueDepth(RequestClass cls) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return classes[static_cast<size_t>(cls)].queue.size();
+    }
+
+    // Queued plus running jobs of a class
+    size_t activeJobs(RequestClass cls) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        const ClassState& state = classes[static_cast<size_t>(cls)];
+        return state.queue.size() + state.running;
+    }
+
+    // Per-class queue metrics as a JSON object body, e.g. "ping":{...},"validate":{...}
+    std::string metricsJson() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string json;
+        for (size_t i = 0; i < kRequestClassCount; i++) {
+            const ClassState& state = classes[i];
+            if (!json.empty()) json += ",";
+            json += "\"" + std::string(requestClassName(static_cast<RequestClass>(i))) + "\":{" +
+                    "\"queued\":" + std::to_string(state.queue.size()) +
+                    ",\"running\":" + std::to_string(state.running) +
+                    ",\"max_concurrent\":" + std::to_string(state.limits.maxConcurrent) +
+                    ",\"max_queued\":" + std::to_string(state.limits.maxQueued) +
+                    ",\"completed\":" + std::to_string(state.completed) +
+                    ",\"rejected\":" + std::to_string(state.rejected) +
+                    ",\"coalesced\":" + std::to_string(state.coalesced) +
+                    ",\"avg_service_ms\":" + std::to_string(static_cast<int>(state.avgServiceMs)) +
+                    ",\"avg_wait_ms\":" + std::to_string(static_cast<int>(state.avgWaitMs)) + "}";
+        }
+        return json;
+    }
+
+private:
+    struct Job {
+        RequestClass cls;
+        uint64_t dedupeKey = 0;
+        Work work;
+        std::vector<Completion> waiters;
+        std::chrono::steady_clock::time_point enqueuedAt;
+    };
+
+    struct ClassState {
+        ClassLimits limits{1, 1};
+        std::deque<std::shared_ptr<Job>> queue;
+        int running = 0;
+        uint64_t completed = 0;
+        uint64_t rejected = 0;
+        uint64_t coalesced = 0;
+        double avgServiceMs = 0.0;   // Exponentially weighted
+        double avgWaitMs = 0.0;
+    };
+
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::array<ClassState, kRequestClassCount> classes;
+    std::unordered_map<uint64_t, std::shared_ptr<Job>> inflight;
+    std::vector<std::thread> workers;
+    bool running = false;
+
+    // Highest-priority class with queued work and a free concurrency slot
+    std::shared_ptr<Job> takeNextJob() {
+        for (auto& state : classes) {
+            if (!state.queue.empty() && state.running < state.limits.maxConcurrent) {
+                std::shared_ptr<Job> job = state.queue.front();
+                state.queue.pop_front();
+                state.running++;
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    void workerLoop() {
+        while (true) {
+            std::shared_ptr<Job> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this, &job] {
+                    if (!running) return true;
+                    job = takeNextJob();
+                    return job != nullptr;
+                });
+                if (!job) return;  // Stopping
+            }
+
+            auto startedAt = std::chrono::steady_clock::now();
+            std::string result = job->work();
+            auto finishedAt = std::chrono::steady_clock::now();
+
+            std::vector<Completion> waiters;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ClassState& state = classes[static_cast<size_t>(job->cls)];
+                state.running--;
+                state.completed++;
+
+                double serviceMs = std::chrono::duration<double, std::milli>(finishedAt - startedAt).count();
+                double waitMs = std::chrono::duration<double, std::milli>(startedAt - job->enqueuedAt).count();
+                state.avgServiceMs = state.avgServiceMs == 0.0 ? serviceMs : 0.8 * state.avgServiceMs + 0.2 * serviceMs;
+                state.avgWaitMs = state.avgWaitMs == 0.0 ? waitMs : 0.8 * state.avgWaitMs + 0.2 * waitMs;
+
+                if (job->dedupeKey != 0) {
+                    inflight.erase(job->dedupeKey);
+                }
+                waiters.swap(job->waiters);
+            }
+            // A slot was freed - another worker may now take a job of this class
+            wake.notify_all();
+
+            for (auto& done : waiters) {
+                done(result);
+            }
+        }
+    }
+};
+
+#endif // REQUEST_SCHEDULER_H
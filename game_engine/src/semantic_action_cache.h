@@ -0,0 +1,164 @@
+#ifndef SEMANTIC_ACTION_CACHE_H
+#define SEMANTIC_ACTION_CACHE_H
+
+// Semantic cache of player-action results for the game engine daemon.
+// Players send many near-identical actions ("go north", "move north", "walk nroth").
+// Each generated state is cached per game under the hash of the (world, state) it was
+// generated from, together with the embedding of the action. A later action on the
+// same state whose embedding is close enough (cosine similarity) returns the cached
+// state instead of running generation. Actions naming different directions never
+// match each other, however close their embeddings are.
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SemanticActionCache {
+public:
+    using Embedding = std::vector<float>;
+
+    SemanticActionCache(float minSimilarity = 0.92f, size_t maxEntriesPerGame = 64, size_t maxGames = 256)
+        : threshold(minSimilarity), maxPerGame(maxEntriesPerGame), maxGameCount(maxGames) {}
+
+    // L2-normalize in place so similarity is a plain dot product
+    static void normalize(Embedding& embedding) {
+        double norm = 0.0;
+        for (float v : embedding) norm += static_cast<double>(v) * v;
+        norm = std::sqrt(norm);
+        if (norm > 0.0) {
+            for (float& v : embedding) v = static_cast<float>(v / norm);
+        }
+    }
+
+    // Cached result for an action on this game state, if a close enough action was seen
+    bool lookup(const std::string& gameId, uint64_t stateHash, const std::string& action,
+                const Embedding& embedding, std::string& result, float* similarity = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto game = games.find(gameId);
+        if (game == games.end()) {
+            misses++;
+            return false;
+        }
+        touchGame(game->second);
+
+        std::set<std::string> directions = directionWords(action);
+        const Entry* best = nullptr;
+        float bestScore = threshold;
+        for (const Entry& entry : game->second.entries) {
+            if (entry.stateHash != stateHash || entry.directions != directions) continue;
+            float score = dot(entry.embedding, embedding);
+            if (score >= bestScore) {
+                bestScore = score;
+                best = &entry;
+            }
+        }
+        if (!best) {
+            misses++;
+            return false;
+        }
+        result = best->result;
+        if (similarity) *similarity = bestScore;
+        hits++;
+        return true;
+    }
+
+    void store(const std::string& gameId, uint64_t stateHash, const std::string& action,
+               const Embedding& embedding, const std::string& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto game = games.find(gameId);
+        if (game == games.end()) {
+            gameOrder.push_front(gameId);
+            game = games.emplace(gameId, GameEntries{{}, gameOrder.begin()}).first;
+            while (games.size() > maxGameCount) {
+                games.erase(gameOrder.back());
+                gameOrder.pop_back();
+            }
+        } else {
+            touchGame(game->second);
+        }
+
+        auto& entries = game->second.entries;
+        entries.push_front({stateHash, directionWords(action), embedding, result});
+        if (entries.size() > maxPerGame) {
+            entries.pop_back();
+        }
+    }
+
+    std::string metricsJson() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t entryCount = 0;
+        for (const auto& game : games) entryCount += game.second.entries.size();
+        return "{\"games\":" + std::to_string(games.size()) +
+               ",\"entries\":" + std::to_string(entryCount) +
+               ",\"hits\":" + std::to_string(hits) +
+               ",\"misses\":" + std::to_string(misses) + "}";
+    }
+
+private:
+    struct Entry {
+        uint64_t stateHash;
+        std::set<std::string> directions;
+        Embedding embedding;
+        std::string result;
+    };
+
+    struct GameEntries {
+        std::list<Entry> entries;                        // Most recent first
+        std::list<std::string>::iterator orderPosition;  // Position in gameOrder
+    };
+
+    float threshold;
+    size_t maxPerGame;
+    size_t maxGameCount;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, GameEntries> games;
+    std::list<std::string> gameOrder;  // Most recently used game first
+    size_t hits = 0;
+    size_t misses = 0;
+
+    void touchGame(GameEntries& game) {
+        gameOrder.splice(gameOrder.begin(), gameOrder, game.orderPosition);
+    }
+
+    static float dot(const Embedding& a, const Embedding& b) {
+        if (a.size() != b.size()) return 0.0f;
+        float sum = 0.0f;
+        for (size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+        return sum;
+    }
+
+    // Direction words in the action, canonicalized (n -> north, ...)
+    static std::set<std::string> directionWords(const std::string& action) {
+        static const std::unordered_map<std::string, std::string> canonical = {
+            {"north", "north"}, {"n", "north"}, {"south", "south"}, {"s", "south"},
+            {"east", "east"}, {"e", "east"}, {"west", "west"}, {"w", "west"},
+            {"up", "up"}, {"u", "up"}, {"down", "down"}, {"d", "down"},
+            {"northeast", "northeast"}, {"ne", "northeast"}, {"northwest", "northwest"}, {"nw", "northwest"},
+            {"southeast", "southeast"}, {"se", "southeast"}, {"southwest", "southwest"}, {"sw", "southwest"},
+            {"left", "left"}, {"right", "right"}, {"forward", "forward"}, {"back", "back"},
+            {"in", "in"}, {"out", "out"}, {"inside", "in"}, {"outside", "out"}};
+
+        std::set<std::string> found;
+        std::string word;
+        for (size_t i = 0; i <= action.size(); i++) {
+            char c = i < action.size() ? action[i] : ' ';
+            if (std::isalpha(static_cast<unsigned char>(c))) {
+                word += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            } else if (!word.empty()) {
+                auto it = canonical.find(word);
+                if (it != canonical.end()) found.insert(it->second);
+                word.clear();
+            }
+        }
+        return found;
+    }
+};
+
+#endif // SEMANTIC_ACTION_CACHE_H
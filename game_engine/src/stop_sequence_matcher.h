@@ -0,0 +1,122 @@
+#ifndef STOP_SEQUENCE_MATCHER_H
+#define STOP_SEQUENCE_MATCHER_H
+
+// Streaming stop-sequence matcher shared by the AI daemons.
+// Builds an Aho-Corasick automaton once over a fixed set of stop sequences and then
+// consumes generated token pieces byte by byte, so detecting a stop sequence costs
+// O(piece length) per token instead of re-scanning the whole accumulated response.
+// The automaton is immutable after construction; per-generation progress lives in a
+// small MatchState value, so one matcher can be shared by concurrent generations.
+
+#include <array>
+#include <cctype>
+#include <cstddef>
+#include <queue>
+#include <string>
+#include <vector>
+
+class StopSequenceMatcher {
+public:
+    // Per-generation cursor into the automaton
+    struct MatchState {
+        int node = 0;
+    };
+
+    explicit StopSequenceMatcher(const std::vector<std::string>& stopSequences, bool caseInsensitive = false)
+        : patterns(stopSequences), ignoreCase(caseInsensitive) {
+        build();
+    }
+
+    // Feed one generated piece. Returns the index of the first stop sequence that
+    // completes inside this piece, or -1 when none does. Never allocates.
+    int feed(MatchState& state, const char* piece, size_t length) const {
+        int node = state.node;
+        for (size_t i = 0; i < length; i++) {
+            node = transitions[node][normalize(piece[i])];
+            if (output[node] >= 0) {
+                state.node = node;
+                return output[node];
+            }
+        }
+        state.node = node;
+        return -1;
+    }
+
+    const std::string& pattern(int index) const { return patterns[index]; }
+    size_t size() const { return patterns.size(); }
+
+private:
+    std::vector<std::string> patterns;
+    bool ignoreCase;
+    std::vector<std::array<int, 256>> transitions;  // Complete goto table (failure links folded in)
+    std::vector<int> output;                        // Lowest pattern index ending at each node, -1 if none
+
+    unsigned char normalize(char c) const {
+        unsigned char byte = static_cast<unsigned char>(c);
+        return ignoreCase ? static_cast<unsigned char>(std::tolower(byte)) : byte;
+    }
+
+    int addNode() {
+        std::array<int, 256> row;
+        row.fill(-1);
+        transitions.push_back(row);
+        output.push_back(-1);
+        return static_cast<int>(transitions.size()) - 1;
+    }
+
+    void build() {
+        addNode();  // Root
+
+        // Trie of all stop sequences
+        for (size_t p = 0; p < patterns.size(); p++) {
+            int node = 0;
+            for (char c : patterns[p]) {
+                unsigned char byte = normalize(c);
+                if (transitions[node][byte] < 0) {
+                    int child = addNode();
+                    transitions[node][byte] = child;
+                }
+                node = transitions[node][byte];
+            }
+            if (output[node] < 0 || output[node] > static_cast<int>(p)) {
+                output[node] = static_cast<int>(p);
+            }
+        }
+
+        // Breadth-first pass turning the trie into a complete automaton
+        std::vector<int> failure(transitions.size(), 0);
+        std::queue<int> pending;
+        for (int byte = 0; byte < 256; byte++) {
+            int child = transitions[0][byte];
+            if (child < 0) {
+                transitions[0][byte] = 0;
+            } else {
+                failure[child] = 0;
+                pending.push(child);
+            }
+        }
+
+        while (!pending.empty()) {
+            int node = pending.front();
+            pending.pop();
+
+            // Inherit matches that end at the failure node (suffix patterns)
+            int inherited = output[failure[node]];
+            if (inherited >= 0 && (output[node] < 0 || inherited < output[node])) {
+                output[node] = inherited;
+            }
+
+            for (int byte = 0; byte < 256; byte++) {
+                int child = transitions[node][byte];
+                if (child < 0) {
+                    transitions[node][byte] = transitions[failure[node]][byte];
+                } else {
+                    failure[child] = transitions[failure[node]][byte];
+                    pending.push(child);
+                }
+            }
+        }
+    }
+};
+
+#endif // STOP_SEQUENCE_MATCHER_H
@@ -0,0 +1,110 @@
+#ifndef WORLD_BLOB_CACHE_H
+#define WORLD_BLOB_CACHE_H
+
+// Content-addressed cache of game world texts for the AI daemons.
+// A game world never changes after creation and is the largest part of every
+// player_action and validate request. Clients send only its hash ("world_hash");
+// when the daemon does not hold that world it answers {"status":"world_cache_miss"}
+// and the client resends the request with the text ("game_world"), which is cached
+// for the following turns. Worlds are evicted least recently used first.
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+#include "content_hash.h"
+
+class WorldBlobCache {
+public:
+    using Blob = std::shared_ptr<const std::string>;
+
+    explicit WorldBlobCache(size_t maxWorlds = 64) : maxEntries(maxWorlds) {}
+
+    // Hash a world is addressed by on the wire
+    static std::string hashOf(const std::string& world) { return ContentHash::hashHex(world); }
+
+    static std::string missResponse(const std::string& hash) {
+        return "{\"status\":\"world_cache_miss\",\"world_hash\":\"" + hash + "\"}";
+    }
+
+    // Check a request at admission: a world sent along is cached when it hashes to the
+    // request's world hash (a mismatched resend is refused, never cached), a bare hash must
+    // be known. Requests without a world hash always pass.
+    bool admit(const nlohmann::json& request) {
+        std::string hash = request.value("world_hash", "");
+        if (hash.empty()) return true;
+        if (request.contains("game_world")) {
+            std::string world = request["game_world"].get<std::string>();
+            if (hashOf(world) != hash) return false;
+            store(std::move(world));
+            return true;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        return worlds.count(hash) != 0;
+    }
+
+    // Fill in "game_world" for a request that carries only the hash.
+    // False when the world is not cached (it may have been evicted since admission).
+    bool resolve(nlohmann::json& request) {
+        std::string hash = request.value("world_hash", "");
+        if (hash.empty() || request.contains("game_world")) return true;
+        Blob world = find(hash);
+        if (!world) return false;
+        request["game_world"] = *world;
+        return true;
+    }
+
+    Blob find(const std::string& hash) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = worlds.find(hash);
+        if (it == worlds.end()) {
+            misses++;
+            return nullptr;
+        }
+        lru.splice(lru.begin(), lru, it->second.lruPosition);
+        hits++;
+        return it->second.text;
+    }
+
+    // Cache a world under its content hash and return the hash
+    std::string store(std::string world) {
+        std::string hash = hashOf(world);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = worlds.find(hash);
+        if (it != worlds.end()) {
+            lru.splice(lru.begin(), lru, it->second.lruPosition);
+            return hash;
+        }
+        lru.push_front(hash);
+        worlds.emplace(hash, Entry{std::make_shared<const std::string>(std::move(world)), lru.begin()});
+        while (worlds.size() > maxEntries) {
+            worlds.erase(lru.back());
+            lru.pop_back();
+        }
+        return hash;
+    }
+
+    std::string metricsJson() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return "{\"worlds\":" + std::to_string(worlds.size()) +
+               ",\"hits\":" + std::to_string(hits) +
+               ",\"misses\":" + std::to_string(misses) + "}";
+    }
+
+private:
+    struct Entry {
+        Blob text;
+        std::list<std::string>::iterator lruPosition;
+    };
+
+    size_t maxEntries;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> worlds;
+    std::list<std::string> lru;  // Most recently used first
+    size_t hits = 0;
+    size_t misses = 0;
+};
+
+#endif // WORLD_BLOB_CACHE_H
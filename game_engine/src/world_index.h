@@ -0,0 +1,238 @@
+#ifndef WORLD_INDEX_H
+#define WORLD_INDEX_H
+
+// Section index of a game world text, used to give each turn only the part of the world
+// it can touch. A world is split at its top-level "Label:" lines into global sections
+// (description, objectives, win conditions, rules, ...), which are always kept, and
+// location / item sections, of which a slice keeps the player's location, the locations
+// one move away and the items that are held, lie there or are named by a global section.
+// Both world forms are indexed: JSON objects (Current_World_State, Items) and
+// "- Name: ..." lists (Locations, Items). A slice is a pure function of the world and
+// state texts, so every node builds the same prompt and the same world hash.
+
+#include <algorithm>
+#include <cctype>
+#include <set>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "world_model.h"
+
+class WorldIndex {
+public:
+    static WorldIndex build(const std::string& worldText) {
+        WorldIndex index;
+        index.hasModel = WorldModel::parse(worldText, index.model);
+
+        std::vector<size_t> starts;
+        size_t pos = 0;
+        while (pos < worldText.size()) {
+            size_t end = worldText.find('\n', pos);
+            if (end == std::string::npos) end = worldText.size();
+            if (starts.empty() || isHeader(worldText.substr(pos, end - pos))) {
+                starts.push_back(pos);
+            }
+            pos = end + 1;
+        }
+        for (size_t i = 0; i < starts.size(); i++) {
+            size_t end = i + 1 < starts.size() ? starts[i + 1] : worldText.size();
+            index.sections.push_back(parseSection(worldText.substr(starts[i], end - starts[i])));
+        }
+        return index;
+    }
+
+    // The world reduced to what the turn can touch; the full text when the player's
+    // location cannot be placed in the index
+    std::string slice(const std::string& stateText) const {
+        std::string full;
+        for (const auto& section : sections) full += section.text;
+
+        PlayerState state;
+        const Section* places = nullptr;
+        for (const auto& section : sections) {
+            if (section.kind == Kind::Locations && !places) places = &section;
+        }
+        if (!places || !PlayerState::parse(stateText, state)) {
+            return full;
+        }
+        const Entry* here = nullptr;
+        for (const auto& entry : places->entries) {
+            if (entry.key == words(state.location)) here = &entry;
+        }
+        if (!here) {
+            return full;
+        }
+
+        // Current and adjacent locations
+        std::set<std::string> locations = {here->key};
+        const WorldLocation* mapped = hasModel && places->json ? model.find(here->name) : nullptr;
+        if (mapped) {
+            for (const auto& name : model.neighbours(*mapped)) locations.insert(words(name));
+        } else {
+            for (const auto& entry : places->entries) {
+                if (contains(here->words, entry.key) || contains(entry.words, here->key)) {
+                    locations.insert(entry.key);
+                }
+            }
+        }
+
+        // Text an item must be named in to be kept: kept locations and global sections
+        std::string context;
+        for (const auto& entry : places->entries) {
+            if (locations.count(entry.key)) context += entry.words;
+        }
+        for (const auto& section : sections) {
+            if (section.kind == Kind::Global) context += words(section.text) + " ";
+        }
+        std::set<std::string> held;
+        for (const auto& item : state.inventory) held.insert(words(item));
+
+        std::string text;
+        for (const auto& section : sections) {
+            if (section.kind == Kind::Global) {
+                text += section.text;
+                continue;
+            }
+            std::vector<const Entry*> kept;
+            for (const auto& entry : section.entries) {
+                bool keep = section.kind == Kind::Locations
+                                ? locations.count(entry.key) > 0
+                                : held.count(entry.key) > 0 || contains(context, entry.key);
+                if (keep) kept.push_back(&entry);
+            }
+            text += section.prefix;
+            if (section.json) {
+                nlohmann::json object = nlohmann::json::object();
+                for (const Entry* entry : kept) object[entry->name] = entry->json;
+                text += object.dump(2);
+            } else {
+                for (const Entry* entry : kept) text += entry->text;
+            }
+            text += section.suffix;
+        }
+        return text;
+    }
+
+private:
+    enum class Kind { Global, Locations, Items };
+
+    struct Entry {
+        std::string name;
+        std::string key;     // Name as words ("Cave_Entrance" -> "cave entrance")
+        std::string text;    // List form: the entry lines
+        nlohmann::json json; // JSON form: the entry value
+        std::string words;   // Entry content as words, for name matching
+    };
+
+    struct Section {
+        Kind kind = Kind::Global;
+        std::string text;    // Verbatim section
+        bool json = false;
+        std::string prefix;  // Location / item sections: text before the entries,
+        std::string suffix;  // and after them
+        std::vector<Entry> entries;
+    };
+
+    std::vector<Section> sections;
+    WorldModel model;
+    bool hasModel = false;
+
+    // "Label: ..." at the start of a line, the label made of letters, spaces and underscores
+    static bool isHeader(const std::string& line) {
+        size_t colon = line.find(':');
+        if (colon == 0 || colon == std::string::npos || colon > 40 || !std::isupper(static_cast<unsigned char>(line[0]))) {
+            return false;
+        }
+        for (size_t i = 0; i < colon; i++) {
+            unsigned char c = line[i];
+            if (!std::isalpha(c) && c != ' ' && c != '_') return false;
+        }
+        return true;
+    }
+
+    static Section parseSection(const std::string& text) {
+        Section section;
+        section.text = text;
+        std::string label = words(text.substr(0, text.find(':')));
+        if (label == "current world state" || label == "locations") {
+            section.kind = Kind::Locations;
+        } else if (label == "items") {
+            section.kind = Kind::Items;
+        } else {
+            return section;
+        }
+
+        size_t body = text.find_first_not_of(" \t\r\n", text.find(':') + 1);
+        if (body != std::string::npos && text[body] == '{') {
+            size_t close = text.rfind('}');
+            nlohmann::json object = nlohmann::json::parse(text.substr(body, close - body + 1), nullptr, false);
+            if (!object.is_object()) {
+                section.kind = Kind::Global;
+                return section;
+            }
+            section.json = true;
+            section.prefix = text.substr(0, body);
+            section.suffix = text.substr(close + 1);
+            for (auto it = object.begin(); it != object.end(); ++it) {
+                section.entries.push_back({it.key(), words(it.key()), "", it.value(), words(it.value().dump()) + " "});
+            }
+            return section;
+        }
+
+        // "- Name: ..." list; an entry runs to the next item, the prefix up to the first
+        size_t pos = 0;
+        size_t trailing = text.find_last_not_of(" \t\r\n") + 1;
+        section.suffix = text.substr(trailing);
+        while (pos < trailing) {
+            size_t end = text.find('\n', pos);
+            end = end == std::string::npos || end + 1 > trailing ? trailing : end + 1;
+            std::string line = text.substr(pos, end - pos);
+            size_t first = line.find_first_not_of(" \t");
+            bool item = first != std::string::npos && (line[first] == '-' || line[first] == '*');
+            if (item) {
+                std::string content = line.substr(first + 1);
+                std::string name = content.substr(0, std::min(content.find(':'), content.find('.')));
+                name.erase(std::remove_if(name.begin(), name.end(),
+                                          [](unsigned char c) { return c == '[' || c == ']' || c == '*'; }),
+                           name.end());
+                section.entries.push_back({name, words(name), line, nullptr, ""});
+            } else if (section.entries.empty()) {
+                section.prefix += line;
+            } else {
+                section.entries.back().text += line;
+            }
+            pos = end;
+        }
+        if (section.entries.empty()) {
+            section.kind = Kind::Global;
+            return section;
+        }
+        for (auto& entry : section.entries) {
+            if (entry.text.back() != '\n') entry.text += "\n";
+            entry.words = words(entry.text) + " ";
+        }
+        if (!section.suffix.empty() && section.suffix.front() == '\n') section.suffix.erase(0, 1);
+        return section;
+    }
+
+    // Lower-case alphanumeric words separated by single spaces ("Crystal_of_Power" ->
+    // "crystal of power"); names are matched against content on word boundaries
+    static std::string words(const std::string& text) {
+        std::string result;
+        for (unsigned char c : text) {
+            if (std::isalnum(c)) {
+                result += static_cast<char>(std::tolower(c));
+            } else if (!result.empty() && result.back() != ' ') {
+                result += ' ';
+            }
+        }
+        if (!result.empty() && result.back() == ' ') result.pop_back();
+        return result;
+    }
+
+    static bool contains(const std::string& content, const std::string& key) {
+        return !key.empty() && (" " + content + " ").find(" " + key + " ") != std::string::npos;
+    }
+};
+
+#endif // WORLD_INDEX_H
@@ -0,0 +1,344 @@
+#ifndef WORLD_MODEL_H
+#define WORLD_MODEL_H
+
+// Machine-readable view of a game world and of a player state.
+// Worlds such as the premade ones carry their map as JSON sections in the world text
+// ("Current_World_State", "Items", "Game_Rules"); player states are "Key: value" lines
+// (Player_Location, Player_Health, ...). Worlds without the JSON sections do not parse
+// and are left entirely to the model.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+struct WorldLocation {
+    std::string name;
+    std::string description;
+    std::map<std::string, std::string> itemDescriptions;
+    std::vector<std::string> exits;                   // Directions, lower case
+    std::map<std::string, std::string> destinations;  // Direction -> location (only where known)
+    bool safe = true;
+    int healthPenalty = 0;
+    std::vector<std::string> items;                   // Items present at game start
+};
+
+class WorldModel {
+public:
+    std::vector<WorldLocation> locations;             // By name
+    std::map<std::string, std::string> itemInfo;      // Item -> description
+    std::string winItem;
+    std::string winLocation;
+    int healthLossUnsafe = 0;
+    int loseHealth = 0;
+    int maxTurns = 0;                                 // 0 = no turn limit
+
+    // Parse the JSON sections of a world text. False when it has no usable map.
+    static bool parse(const std::string& worldText, WorldModel& model) {
+        nlohmann::json state = section(worldText, "Current_World_State:");
+        if (!state.is_object() || state.empty()) {
+            return false;
+        }
+        for (auto it = state.begin(); it != state.end(); ++it) {
+            const nlohmann::json& entry = it.value();
+            if (!entry.is_object()) {
+                continue;
+            }
+            WorldLocation location;
+            location.name = it.key();
+            location.description = entry.value("base_description", entry.value("description", ""));
+            location.safe = entry.value("safe", true);
+            location.healthPenalty = entry.value("health_penalty", 0);
+            if (entry.contains("item_descriptions") && entry["item_descriptions"].is_object()) {
+                for (auto item = entry["item_descriptions"].begin(); item != entry["item_descriptions"].end(); ++item) {
+                    if (item.value().is_string()) {
+                        location.itemDescriptions[item.key()] = item.value().get<std::string>();
+                    }
+                }
+            }
+            // Exits are either a list of directions or an object of direction -> location
+            if (entry.contains("exits") && entry["exits"].is_array()) {
+                for (const auto& exit : entry["exits"]) {
+                    if (exit.is_string()) {
+                        location.exits.push_back(lower(exit.get<std::string>()));
+                    }
+                }
+            } else if (entry.contains("exits") && entry["exits"].is_object()) {
+                for (auto exit = entry["exits"].begin(); exit != entry["exits"].end(); ++exit) {
+                    location.exits.push_back(lower(exit.key()));
+                    if (exit.value().is_string()) {
+                        location.destinations[lower(exit.key())] = exit.value().get<std::string>();
+                    }
+                }
+            }
+            if (entry.contains("items_present") && entry["items_present"].is_array()) {
+                for (const auto& item : entry["items_present"]) {
+                    if (item.is_string()) {
+                        location.items.push_back(item.get<std::string>());
+                    }
+                }
+            }
+            model.locations.push_back(std::move(location));
+        }
+
+        nlohmann::json items = section(worldText, "Items:");
+        if (items.is_object()) {
+            for (auto it = items.begin(); it != items.end(); ++it) {
+                std::string description = it.value().is_object() ? it.value().value("description", "") : "";
+                model.itemInfo[it.key()] = description;
+                if (it.value().is_object() && it.value().value("winning_item", false) && model.winItem.empty()) {
+                    model.winItem = it.key();
+                }
+            }
+        }
+
+        nlohmann::json rules = section(worldText, "Game_Rules:");
+        if (rules.is_object()) {
+            model.winItem = rules.value("win_condition_item", model.winItem);
+            model.winLocation = rules.value("win_condition_location", "");
+            model.healthLossUnsafe = rules.value("health_loss_unsafe", 0);
+            model.loseHealth = rules.value("lose_condition_health", 0);
+        }
+
+        // "Win in N turns" in the game over condition
+        size_t limit = worldText.find("Win in ");
+        if (limit != std::string::npos) {
+            model.maxTurns = std::atoi(worldText.c_str() + limit + 7);
+        }
+
+        model.inferDestinations();
+        return true;
+    }
+
+    const WorldLocation* find(const std::string& name) const {
+        for (const auto& location : locations) {
+            if (location.name == name) {
+                return &location;
+            }
+        }
+        return nullptr;
+    }
+
+    // Location reached through an exit, empty when it cannot be told
+    std::string destination(const WorldLocation& from, const std::string& direction) const {
+        auto it = from.destinations.find(direction);
+        return it == from.destinations.end() ? "" : it->second;
+    }
+
+    // Locations one move away. An exit whose destination is not known counts every
+    // location with the opposite exit, so nothing reachable is left out.
+    std::vector<std::string> neighbours(const WorldLocation& from) const {
+        std::vector<std::string> names;
+        auto add = [&names](const std::string& name) {
+            if (std::find(names.begin(), names.end(), name) == names.end()) names.push_back(name);
+        };
+        for (const auto& direction : from.exits) {
+            std::string known = destination(from, direction);
+            if (!known.empty()) {
+                add(known);
+                continue;
+            }
+            for (const auto& to : locations) {
+                if (&to != &from && std::find(to.exits.begin(), to.exits.end(), opposite(direction)) != to.exits.end()) {
+                    add(to.name);
+                }
+            }
+        }
+        return names;
+    }
+
+    static std::string lower(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+private:
+    // The JSON object following a "Label:" line, or null
+    static nlohmann::json section(const std::string& text, const std::string& label) {
+        size_t pos = text.find(label);
+        if (pos == std::string::npos) {
+            return nullptr;
+        }
+        size_t start = text.find('{', pos + label.size());
+        if (start == std::string::npos) {
+            return nullptr;
+        }
+        int depth = 0;
+        bool inString = false;
+        for (size_t i = start; i < text.size(); i++) {
+            char c = text[i];
+            if (inString) {
+                if (c == '\\') {
+                    i++;
+                } else if (c == '"') {
+                    inString = false;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{') {
+                depth++;
+            } else if (c == '}' && --depth == 0) {
+                return nlohmann::json::parse(text.substr(start, i - start + 1), nullptr, false);
+            }
+        }
+        return nullptr;
+    }
+
+    static std::string opposite(const std::string& direction) {
+        static const std::map<std::string, std::string> opposites = {
+            {"north", "south"}, {"south", "north"}, {"east", "west"}, {"west", "east"},
+            {"up", "down"}, {"down", "up"}, {"northeast", "southwest"}, {"southwest", "northeast"},
+            {"northwest", "southeast"}, {"southeast", "northwest"}};
+        auto it = opposites.find(direction);
+        return it == opposites.end() ? "" : it->second;
+    }
+
+    // Worlds that list only exit directions are connected by the opposite exit: an exit
+    // leads to the one other location with the opposite direction, or else to the one
+    // location whose opposite exit is already known to lead back here. Exits that stay
+    // ambiguous are left unknown.
+    void inferDestinations() {
+        for (auto& from : locations) {
+            for (const auto& direction : from.exits) {
+                if (from.destinations.count(direction)) {
+                    continue;
+                }
+                std::string back = opposite(direction);
+                const WorldLocation* match = nullptr;
+                int candidates = 0;
+                for (const auto& to : locations) {
+                    if (&to != &from && std::find(to.exits.begin(), to.exits.end(), back) != to.exits.end()) {
+                        match = &to;
+                        candidates++;
+                    }
+                }
+                if (candidates == 1) {
+                    from.destinations[direction] = match->name;
+                }
+            }
+        }
+        for (auto& from : locations) {
+            for (const auto& direction : from.exits) {
+                if (from.destinations.count(direction)) {
+                    continue;
+                }
+                const WorldLocation* match = nullptr;
+                int candidates = 0;
+                for (const auto& to : locations) {
+                    auto back = to.destinations.find(opposite(direction));
+                    if (&to != &from && back != to.destinations.end() && back->second == from.name) {
+                        match = &to;
+                        candidates++;
+                    }
+                }
+                if (candidates == 1) {
+                    from.destinations[direction] = match->name;
+                }
+            }
+        }
+    }
+};
+
+struct PlayerState {
+    std::string location;
+    int health = 100;
+    int score = 0;
+    std::vector<std::string> inventory;
+    std::string status = "active";
+    std::vector<std::string> messages;
+    int turn = 0;
+
+    // Parse the "Key: value" state text. False when the mandatory fields are missing.
+    static bool parse(const std::string& text, PlayerState& state) {
+        std::string health, turn;
+        bool hasInventory = false;
+        size_t start = 0;
+        while (start < text.size()) {
+            size_t end = text.find('\n', start);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+            std::string line = text.substr(start, end - start);
+            start = end + 1;
+            size_t colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+            std::string key = trim(line.substr(0, colon));
+            std::string value = trim(line.substr(colon + 1));
+            if (key == "Player_Location") state.location = value;
+            else if (key == "Player_Health") health = value;
+            else if (key == "Player_Score") state.score = std::atoi(value.c_str());
+            else if (key == "Player_Inventory") { state.inventory = parseList(value); hasInventory = true; }
+            else if (key == "Game_Status") state.status = WorldModel::lower(value);
+            else if (key == "Messages") state.messages = parseList(value);
+            else if (key == "Turn_Count") turn = value;
+        }
+        if (state.location.empty() || health.empty() || turn.empty() || !hasInventory) {
+            return false;
+        }
+        state.health = std::atoi(health.c_str());
+        state.turn = std::atoi(turn.c_str());
+        return true;
+    }
+
+    std::string serialize() const {
+        return "Player_Location: " + location + "\n" +
+               "Player_Health: " + std::to_string(health) + "\n" +
+               "Player_Score: " + std::to_string(score) + "\n" +
+               "Player_Inventory: " + nlohmann::json(inventory).dump() + "\n" +
+               "Game_Status: " + status + "\n" +
+               "Messages: " + nlohmann::json(messages).dump() + "\n" +
+               "Turn_Count: " + std::to_string(turn);
+    }
+
+    bool has(const std::string& item) const {
+        return std::find(inventory.begin(), inventory.end(), item) != inventory.end();
+    }
+
+private:
+    static std::string trim(const std::string& text) {
+        size_t first = text.find_first_not_of(" \t\r");
+        size_t last = text.find_last_not_of(" \t\r");
+        return first == std::string::npos ? "" : text.substr(first, last - first + 1);
+    }
+
+    // A JSON list, or a bracketed comma-separated list the model wrote without quotes
+    static std::vector<std::string> parseList(const std::string& value) {
+        std::vector<std::string> items;
+        nlohmann::json parsed = nlohmann::json::parse(value, nullptr, false);
+        if (parsed.is_array()) {
+            for (const auto& item : parsed) {
+                if (item.is_string()) {
+                    items.push_back(item.get<std::string>());
+                }
+            }
+            return items;
+        }
+        std::string inner = value;
+        if (!inner.empty() && inner.front() == '[') inner.erase(0, 1);
+        if (!inner.empty() && inner.back() == ']') inner.pop_back();
+        size_t start = 0;
+        while (start <= inner.size()) {
+            size_t comma = inner.find(',', start);
+            if (comma == std::string::npos) {
+                comma = inner.size();
+            }
+            std::string item = trim(inner.substr(start, comma - start));
+            if (item.size() >= 2 && item.front() == '"' && item.back() == '"') {
+                item = item.substr(1, item.size() - 2);
+            }
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+            start = comma + 1;
+        }
+        return items;
+    }
+};
+
+#endif // WORLD_MODEL_H
@@ -0,0 +1,199 @@
+#ifndef WORLD_POOL_H
+#define WORLD_POOL_H
+
+// Pool of pre-generated game worlds for the game engine daemon.
+// Worlds are generated from per-theme seed prompts while the daemon is idle and
+// persisted one file per world (world_<theme>_<hash>.txt) so the pool survives
+// daemon restarts. create_game takes a pooled world when the user prompt matches a
+// theme - every content word of the prompt is one of the theme's keywords, or the
+// prompt asks for no theme at all - and otherwise falls back to live generation. Only
+// requests that opt in (use_pool) are served from it.
+// The pool lives outside the contract state directory: each node fills it with its
+// own generations, so it must never become part of the consensus state.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "content_hash.h"
+
+struct WorldTheme {
+    std::string name;                    // File-name safe tag
+    std::string seedPrompt;              // Creation prompt used to fill the pool
+    std::vector<std::string> keywords;   // Prompt words that select this theme
+};
+
+class WorldPool {
+public:
+    WorldPool(const std::string& directory, std::vector<WorldTheme> worldThemes, size_t worldsPerTheme)
+        : dir(directory), themes(std::move(worldThemes)), perTheme(worldsPerTheme) {}
+
+    // Index the worlds already on disk; unknown themes and partial files are ignored
+    void load() {
+        std::lock_guard<std::mutex> lock(mutex);
+        pool.clear();
+        std::error_code ec;
+        std::filesystem::create_directories(dir, ec);
+        for (const auto& entry : std::filesystem::directory_iterator(dir, ec)) {
+            std::string name = entry.path().filename().string();
+            if (name.rfind("world_", 0) != 0 || entry.path().extension() != ".txt") continue;
+            size_t hashSep = name.rfind('_');
+            if (hashSep <= 6) continue;
+            std::string theme = name.substr(6, hashSep - 6);
+            if (findTheme(theme) != nullptr) {
+                pool[theme].push_back(entry.path().string());
+            }
+        }
+    }
+
+    // Take a pooled world matching the prompt. The file is removed so the world
+    // is handed out once.
+    bool take(const std::string& prompt, std::string& world) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<const WorldTheme*> candidates = matchThemes(prompt);
+        if (candidates.empty()) {
+            misses++;
+            return false;
+        }
+
+        // Prefer the matching theme with the most pooled worlds
+        std::sort(candidates.begin(), candidates.end(), [this](const WorldTheme* a, const WorldTheme* b) {
+            return pool[a->name].size() > pool[b->name].size();
+        });
+        for (const WorldTheme* theme : candidates) {
+            auto& files = pool[theme->name];
+            while (!files.empty()) {
+                std::string path = files.front();
+                files.pop_front();
+                std::ifstream in(path);
+                std::stringstream content;
+                content << in.rdbuf();
+                std::error_code ec;
+                std::filesystem::remove(path, ec);
+                if (in && !content.str().empty()) {
+                    world = content.str();
+                    hits++;
+                    return true;
+                }
+            }
+        }
+        misses++;
+        return false;
+    }
+
+    // Theme most in need of a new world, or nullptr when the pool is full
+    const WorldTheme* nextRefill() {
+        std::lock_guard<std::mutex> lock(mutex);
+        const WorldTheme* neediest = nullptr;
+        size_t lowest = perTheme;
+        for (const auto& theme : themes) {
+            size_t count = pool[theme.name].size();
+            if (count < lowest) {
+                lowest = count;
+                neediest = &theme;
+            }
+        }
+        return neediest;
+    }
+
+    // Persist a generated world (write to a temp file, then rename into place). A world
+    // already in the pool is rejected.
+    bool add(const std::string& theme, const std::string& world) {
+        std::string path = dir + "/world_" + theme + "_" + ContentHash::hashHex(world) + ".txt";
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const auto& files = pool[theme];
+            if (std::find(files.begin(), files.end(), path) != files.end()) return false;
+        }
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::trunc);
+            out << world;
+            if (!out) return false;
+        }
+        std::error_code ec;
+        std::filesystem::rename(tmpPath, path, ec);
+        if (ec) return false;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        pool[theme].push_back(path);
+        generated++;
+        return true;
+    }
+
+    // Pool metrics as a JSON object
+    std::string metricsJson() {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::string sizes;
+        size_t total = 0;
+        for (const auto& theme : themes) {
+            size_t count = pool[theme.name].size();
+            total += count;
+            if (!sizes.empty()) sizes += ",";
+            sizes += "\"" + theme.name + "\":" + std::to_string(count);
+        }
+        return "{\"size\":" + std::to_string(total) +
+               ",\"target_per_theme\":" + std::to_string(perTheme) +
+               ",\"themes\":{" + sizes + "}" +
+               ",\"hits\":" + std::to_string(hits) +
+               ",\"misses\":" + std::to_string(misses) +
+               ",\"generated\":" + std::to_string(generated) + "}";
+    }
+
+private:
+    std::string dir;
+    std::vector<WorldTheme> themes;
+    size_t perTheme;
+    std::mutex mutex;
+    std::map<std::string, std::deque<std::string>> pool;   // theme -> world files, oldest first
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t generated = 0;
+
+    const WorldTheme* findTheme(const std::string& name) const {
+        for (const auto& theme : themes) {
+            if (theme.name == name) return &theme;
+        }
+        return nullptr;
+    }
+
+    // Themes whose keywords cover every content word of the prompt. A prompt with no
+    // content words ("create a new game") matches every theme.
+    std::vector<const WorldTheme*> matchThemes(const std::string& prompt) const {
+        static const std::set<std::string> fillerWords = {
+            "a", "an", "the", "and", "with", "of", "in", "on", "for", "to", "me", "my", "i", "want",
+            "please", "create", "make", "generate", "start", "new", "game", "adventure", "world",
+            "story", "quest", "set", "setting", "themed", "theme", "random", "some", "style"};
+
+        std::vector<std::string> words;
+        std::string word;
+        for (size_t i = 0; i <= prompt.size(); i++) {
+            char c = i < prompt.size() ? prompt[i] : ' ';
+            if (std::isalnum(static_cast<unsigned char>(c))) {
+                word += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+            } else if (!word.empty()) {
+                if (fillerWords.count(word) == 0) words.push_back(word);
+                word.clear();
+            }
+        }
+
+        std::vector<const WorldTheme*> matches;
+        for (const auto& theme : themes) {
+            bool covered = std::all_of(words.begin(), words.end(), [&theme](const std::string& w) {
+                return std::find(theme.keywords.begin(), theme.keywords.end(), w) != theme.keywords.end();
+            });
+            if (covered) matches.push_back(&theme);
+        }
+        return matches;
+    }
+};
+
+#endif // WORLD_POOL_H